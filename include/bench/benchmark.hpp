@@ -0,0 +1,119 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "../jobs/reencode_builder.hpp"
+
+namespace FFmpegMulti {
+namespace Bench {
+
+/**
+ * @brief What to measure, and where
+ */
+struct BenchOptions {
+    std::vector<std::string> generators{"testsrc2", "mandelbrot"}; // lavfi sources of the test clips
+    std::vector<std::pair<int, int>> resolutions{{640, 360}, {1280, 720}, {1920, 1080}};
+    std::vector<std::string> presets{"x264", "x265", "prores", "ffv1"}; // See presetNames()
+    std::vector<unsigned> threads{}; // Thread counts of the sweep (empty = 1, 2, 4... up to the usable cores)
+    double seconds{5.0}; // Length of the test clips
+    int framerate{30};
+    int runs{1}; // Encodes per configuration, the fastest one is reported
+    bool measure_ssim{true};
+    bool pin_cpus{true}; // Run N threads on N CPUs, so the sweep measures scaling and not the scheduler
+    std::filesystem::path work_dir{}; // Test clips and encodes (empty = <temp>/ffmpeg_multi_bench)
+    std::function<bool()> should_stop{}; // Polled between encodes, true ends the run early
+};
+
+/**
+ * @brief Measures of one preset, thread count and test clip
+ */
+struct BenchResult {
+    std::string generator{};
+    int width{0};
+    int height{0};
+    std::string preset{};
+    std::string encoder{};
+    unsigned threads{0};
+    bool success{false};
+    std::string error{};
+    int64_t frames{0};
+    double wall_seconds{0.0}; // Of the fastest run
+    double fps{0.0};
+    double cpu_seconds{0.0};
+    double average_cores{0.0}; // CPU time / wall time
+    double fps_per_core{0.0}; // Frames per CPU second: the cost of the preset, whatever the thread count
+    long peak_rss_kb{0};
+    uint64_t size_bytes{0};
+    double bitrate_kbps{0.0};
+    double ssim{-1.0}; // Against the test clip (-1 = not measured)
+};
+
+/**
+ * @brief Results of a whole run, with what is needed to compare two runs
+ */
+struct BenchReport {
+    std::string ffmpeg_version{}; // First line of `ffmpeg -version`
+    unsigned cores{0}; // Usable cores (cgroup quota and cpuset included)
+    double seconds{0.0};
+    int framerate{0};
+    std::vector<BenchResult> results{};
+
+    /**
+     * @brief Report as one JSON document (schema version 1)
+     */
+    std::string toJson() const;
+};
+
+/**
+ * @brief Names accepted in BenchOptions::presets, one per complete preset of ReencodeJobBuilder
+ */
+std::vector<std::string> presetNames();
+
+/**
+ * @brief Applies the complete preset called `name` (e.g. "x265" -> x265Preset())
+ * @return false for an unknown name
+ */
+bool applyPreset(Jobs::ReencodeJobBuilder& builder, const std::string& name);
+
+/**
+ * @brief Encodes deterministic test clips with every preset over a thread sweep
+ *
+ * The clips come from lavfi generators (testsrc2, mandelbrot...) and are
+ * stored losslessly (FFV1) once, so the encodes time the encoder and not the
+ * generator. Each encode is a ReencodeJob built from a complete preset, with
+ * an explicit thread count; its CPU time comes from the job metrics.
+ */
+class Benchmark {
+public:
+    explicit Benchmark(BenchOptions options);
+
+    /**
+     * @brief Generates the clips and runs every configuration
+     * @param on_result Called after each configuration (e.g. to print a table row)
+     * @throw std::runtime_error if ffmpeg is missing or a test clip cannot be generated
+     */
+    BenchReport run(const std::function<void(const BenchResult&)>& on_result = {});
+
+private:
+    BenchOptions options_;
+
+    std::vector<unsigned> threadSweep() const;
+    std::filesystem::path generateClip(const std::string& generator, int width, int height) const;
+    BenchResult measure(const std::filesystem::path& clip, const std::string& preset, unsigned threads) const;
+    double measureSsim(const std::filesystem::path& encode, const std::filesystem::path& clip) const;
+};
+
+/**
+ * @brief Entry point of ffmpeg_multi_bench
+ * @param args Command line without the program name
+ * @return Process exit code (see Cli::ExitCode)
+ */
+int run(const std::vector<std::string>& args);
+
+} // namespace Bench
+} // namespace FFmpegMulti
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "options.hpp"
+#include "../core/job.hpp"
+
+namespace FFmpegMulti {
+namespace Cli {
+
+/**
+ * @brief Process exit codes of the non-interactive mode
+ */
+enum ExitCode {
+    EXIT_OK = 0,
+    EXIT_FAILED = 1, // At least one job failed
+    EXIT_USAGE = 2, // Invalid arguments or manifest, nothing was run
+    EXIT_INTERRUPTED = 130 // SIGINT / Ctrl+C
+};
+
+/**
+ * @brief Entry point of the non-interactive mode (no menu, no prompt)
+ *
+ * `ffmpeg_multi <command> [--option value]...` runs one job, where the
+ * command is reencode, ladder, extract-frames, thumbnails, concat or svt-av1 and the
+ * options mirror the methods of the matching builder. `ffmpeg_multi run
+ * <manifest.json>` runs every job listed in a manifest, and `probe-dir`
+ * analyzes a folder like menu option 9.
+ *
+ * @param args Command line without the program name
+ * @return Process exit code (see ExitCode)
+ */
+int run(const std::vector<std::string>& args);
+
+/**
+ * @brief Builds the job of a command from its options
+ * @param command "reencode", "ladder", "extract-frames", "thumbnails", "concat" or "svt-av1"
+ * @throw UsageError for an unknown command or option, or a value the builder rejects
+ */
+std::unique_ptr<Core::Job> buildJob(const std::string& command, const Options& options);
+
+/**
+ * @brief Switches (options without value) accepted by a command
+ */
+std::set<std::string> commandSwitches(const std::string& command);
+
+/**
+ * @brief Runs the jobs of a JSON manifest on a BatchRunner
+ *
+ * Layout:
+ * @code
+ * {
+ *   "concurrency": 2,          // Optional, 0 = cores / job thread demand
+ *   "max_retries": 1,          // Optional
+ *   "log_dir": "logs",         // Optional, default <manifest dir>/logs
+ *   "metrics": "metrics.json", // Optional, resources used by each job
+ *   "trace": "batch.trace.json", // Optional, timeline of the workers, jobs, steps and processes
+ *   "prometheus": "ffmpeg_multi.prom", // Optional, live metrics for the node_exporter textfile collector
+ *   "jobs": [
+ *     { "type": "reencode", "name": "ep01", "input": "ep01.mkv", "output": "out/ep01.mkv", "codec": "x265", "crf": 20 },
+ *     { "type": "concat", "input": ["a.mkv", "b.mkv"], "output": "ab.mkv" }
+ *   ]
+ * }
+ * @endcode
+ * Job members use the option names of the command line; "retries" (overriding
+ * max_retries), "timeout" and "log" apply to any job. Every job is built,
+ * and so validated, before the first one starts. Relative paths resolve
+ * against the current directory, as on the command line.
+ *
+ * Every run appends to a journal (<manifest>.journal by default); with
+ * --resume, jobs it records as done whose output is intact are skipped.
+ *
+ * With --metrics (or a "metrics" setting), the resources used by each job
+ * (CPU time, average and peak cores, peak memory, I/O) are written as JSON
+ * when the batch ends. With --prometheus (or a "prometheus" setting), queue
+ * depth, live fps and speed, failures and CPU use are rewritten every
+ * --prometheus-interval seconds (default 5) while the batch runs. With
+ * --trace (or a "trace" setting), the batch is written as a Chrome trace
+ * for ui.perfetto.dev: the jobs of each worker, then the steps and child
+ * processes of each job with their CPU, memory and I/O over time.
+ *
+ * @param options Command line overrides: --jobs, --retries, --log-dir, --dry-run,
+ *                --resume, --verify, --journal, --metrics, --trace, --prometheus,
+ *                --prometheus-interval
+ */
+int runManifest(const std::filesystem::path& manifest, const Options& options);
+
+} // namespace Cli
+} // namespace FFmpegMulti
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "../core/json.hpp"
+
+namespace FFmpegMulti {
+namespace Cli {
+
+/**
+ * @brief Invalid command line or manifest entry (reported with the usage, exit code 2)
+ */
+class UsageError : public std::runtime_error {
+public:
+    using std::runtime_error::runtime_error;
+};
+
+/**
+ * @brief Named settings of one job, from command line flags or a manifest object
+ *
+ * Both sources use the same names: `--crf 20` on the command line is
+ * `"crf": 20` in a manifest. Every read marks the option as used, so that
+ * checkAllUsed() can reject misspelled or unsupported settings instead of
+ * silently ignoring them.
+ */
+class Options {
+public:
+    Options() = default;
+
+    /**
+     * @brief Parses `--name value`, `--name=value` and bare switches
+     * @param args Arguments after the subcommand
+     * @param switches Names that never take a value (e.g. "overwrite")
+     * @throw UsageError on a missing value
+     */
+    static Options parse(const std::vector<std::string>& args, const std::set<std::string>& switches);
+
+    /**
+     * @brief Converts the members of a manifest object (arrays give repeated values)
+     * @throw UsageError if a member is a nested object
+     */
+    static Options fromJson(const Json::Value& object);
+
+    bool has(const std::string& name) const;
+
+    /**
+     * @brief True when the switch is present and not "false", "0" or "no"
+     */
+    bool flag(const std::string& name) const;
+
+    std::string get(const std::string& name, const std::string& fallback = "") const;
+    std::string require(const std::string& name) const;
+    std::vector<std::string> getAll(const std::string& name) const;
+
+    /**
+     * @throw UsageError if the value is not a number within [min, max]
+     */
+    int getInt(const std::string& name, int fallback, int min, int max) const;
+    double getDouble(const std::string& name, double fallback, double min, double max) const;
+
+    /**
+     * @brief Arguments that are not options (in order)
+     */
+    const std::vector<std::string>& positionals() const { return positionals_; }
+
+    /**
+     * @brief Stable text of all values ("name=value" lines sorted by name, repeats in order)
+     * @param ignored Names left out (e.g. cosmetic labels)
+     */
+    std::string canonical(const std::set<std::string>& ignored = {}) const;
+
+    /**
+     * @throw UsageError naming the first option that was never read
+     */
+    void checkAllUsed() const;
+
+private:
+    std::vector<std::pair<std::string, std::string>> values_; // In order, names may repeat
+    std::vector<std::string> positionals_;
+    mutable std::set<std::string> used_;
+};
+
+} // namespace Cli
+} // namespace FFmpegMulti
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace FFmpegMulti {
+namespace Core {
+
+/**
+ * @brief Share of the machine given to one job: thread count and CPUs to run on
+ */
+struct CpuAllocation {
+    unsigned threads{0}; // Threads the encoder should start (0 = not planned, encoder default)
+    std::vector<unsigned> cpus{}; // Logical CPUs the job's processes are pinned to (empty = not pinned)
+    int numa_node{-1}; // Node holding every CPU of the allocation (-1 = several or unknown)
+};
+
+/**
+ * @brief CPUs of one NUMA node that this process may use
+ */
+struct NumaNode {
+    int id{0};
+    std::vector<unsigned> cpus{};
+};
+
+/**
+ * @brief CPUs available to this process, as the kernel and the container limit them
+ *
+ * On Linux: the affinity mask of the process, narrowed by the cgroup v2
+ * cpuset, the cgroup v2 CPU quota (cpu.max of the cgroup and its parents)
+ * and the NUMA nodes of /sys/devices/system/node. Elsewhere: every core of
+ * std::thread::hardware_concurrency() on a single node, without quota.
+ */
+struct CpuTopology {
+    std::vector<NumaNode> nodes{}; // Only nodes with at least one usable CPU
+    double quota_cores{0.0}; // CPU time the cgroup may use, in cores (0 = unlimited)
+
+    /**
+     * @brief Topology of the machine, detected once
+     */
+    static const CpuTopology& system();
+
+    /**
+     * @brief Reads the topology from the system (uncached)
+     */
+    static CpuTopology detect();
+
+    /**
+     * @brief Number of usable CPUs, over all nodes
+     */
+    unsigned cpuCount() const;
+
+    /**
+     * @brief Threads worth running at once: the CPU count, lowered by the quota (at least 1)
+     */
+    unsigned usableCores() const;
+};
+
+/**
+ * @brief Cores the machine lets this process keep busy (cgroup quota and cpuset included)
+ */
+unsigned availableCores();
+
+/**
+ * @brief Parses a kernel CPU list such as "0-3,8,10-11"
+ * @return Sorted CPU numbers (empty on a malformed list)
+ */
+std::vector<unsigned> parseCpuList(const std::string& list);
+
+/**
+ * @brief Parses the content of a cgroup v2 cpu.max file ("200000 100000" or "max 100000")
+ * @return Quota in cores (0 = unlimited or unreadable)
+ */
+double parseCpuMax(const std::string& content);
+
+/**
+ * @brief Splits the usable CPUs between jobs running side by side
+ *
+ * With at least as many slots as NUMA nodes, every slot stays on one node
+ * (nodes get slots in proportion to their size) and owns a contiguous share
+ * of its CPUs; with fewer slots, each slot takes whole nodes. Thread counts
+ * follow the CPU shares, scaled down to the cgroup quota.
+ * @param slots Number of jobs that run at once
+ * @param within Restricts the plan to these CPUs and threads (e.g. the allocation of a parent job)
+ * @return One allocation per slot
+ */
+std::vector<CpuAllocation> planAllocations(const CpuTopology& topology, unsigned slots, const CpuAllocation& within = {});
+
+} // namespace Core
+} // namespace FFmpegMulti
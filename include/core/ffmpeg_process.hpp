@@ -4,22 +4,304 @@
 #include <string>
 #include <memory>
 #include <filesystem>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+#include "progress.hpp"
+
+/**
+ * @brief Structured outcome of a child process
+ */
+struct ProcessResult {
+    bool launched{false}; // false if the executable could not be started
+    int exit_code{-1}; // Exit status (meaningful when signal == 0)
+    int signal{0}; // Terminating signal (POSIX only)
+    bool cancelled{false}; // Stopped through ProcessHandle::cancel()
+    bool timed_out{false}; // Stopped because the timeout expired
+    double wall_seconds{0.0}; // Elapsed real time
+    double user_cpu_seconds{0.0}; // CPU time spent in user mode
+    double system_cpu_seconds{0.0}; // CPU time spent in kernel mode
+    long peak_rss_kb{0}; // Largest resident set size
+    long major_faults{0}; // Page faults served from storage (POSIX only)
+    long voluntary_switches{0}; // Context switches while waiting, e.g. for I/O (POSIX only)
+    long involuntary_switches{0}; // Context switches forced by the scheduler (POSIX only)
+    uint64_t read_bytes{0}; // Bytes read through system calls, pipes and page cache included (Linux, Windows)
+    uint64_t write_bytes{0}; // Bytes written through system calls (Linux, Windows)
+    uint64_t storage_read_bytes{0}; // Bytes fetched from storage (Linux only)
+    uint64_t storage_write_bytes{0}; // Bytes sent to storage (Linux only)
+    unsigned peak_threads{0}; // Most threads seen at once (Linux only, sampled)
+    double peak_cores{0.0}; // Highest CPU use over one sampling interval, in cores (Linux only)
+    std::string output{}; // Captured stdout (only if capture is enabled)
+    std::string error{}; // Launch error message
+
+    /**
+     * @brief Checks whether the process ran to completion and exited with code 0
+     */
+    bool success() const { return launched && !cancelled && !timed_out && signal == 0 && exit_code == 0; }
+
+    /**
+     * @brief Human readable status (e.g. "exit code 1", "killed by signal 9")
+     */
+    std::string describe() const;
+};
+
+/**
+ * @brief Resource use of a running child at one point in time (see ffmpegProcess::setSampleCallback)
+ */
+struct ProcessSample {
+    std::chrono::steady_clock::time_point at{};
+    double cores{-1.0}; // CPU use since the previous sample, in cores (-1 = first sample)
+    long rss_kb{0}; // Current resident set size
+    unsigned threads{0};
+    uint64_t read_bytes{0}; // Cumulative, as in ProcessResult
+    uint64_t write_bytes{0};
+};
+
+/**
+ * @brief Handle on a running child process
+ *
+ * Returned by ffmpegProcess::start(). A background thread reaps the child and
+ * fulfils the result future, so the handle can be dropped at any time without
+ * leaving a zombie process behind. On Linux, another thread samples
+ * /proc/<pid> while the child runs (thread count, CPU use, I/O).
+ */
+class ProcessHandle : public std::enable_shared_from_this<ProcessHandle> {
+public:
+    ~ProcessHandle() = default;
+
+    /**
+     * @brief Blocks until the process exits
+     */
+    ProcessResult wait();
+
+    /**
+     * @brief Waits at most `timeout` for the process to exit
+     * @return true if the process has exited
+     */
+    bool wait_for(std::chrono::milliseconds timeout);
+
+    /**
+     * @brief Stops the process: SIGTERM, then SIGKILL once the grace period expires
+     *
+     * On Windows the process is terminated immediately.
+     */
+    void cancel(std::chrono::milliseconds grace = std::chrono::seconds(5));
+
+    /**
+     * @brief Future fulfilled with the result once the process exits
+     */
+    std::shared_future<ProcessResult> result() const;
+
+    bool running() const;
+
+private:
+    friend class ffmpegProcess;
+    ProcessHandle() = default;
+
+    void terminate(bool force);
+    void reap(bool pipeOutput);
+    void sample(ProcessResult& usage); // Reads /proc/<pid>, with mutex_ held and the child not reaped
+    void sampleUntilExit();
+
+    std::thread progress_reader_; // Parses the -progress pipe while the process runs
+    std::function<void(const char*, size_t)> output_callback_; // Receives stdout instead of ProcessResult::output
+    std::function<void(const ProcessSample&)> sample_callback_; // Receives each sample of the sampler
+    std::thread sampler_; // Runs sampleUntilExit() (Linux only)
+    std::condition_variable sampler_cv_; // Wakes the sampler when the child exits
+    ProcessResult usage_{}; // Peaks and counters sampled so far
+    double sampled_cpu_seconds_{0.0};
+    std::chrono::steady_clock::time_point sampled_at_{};
+
+    mutable std::mutex mutex_;
+    std::promise<ProcessResult> promise_;
+    std::shared_future<ProcessResult> future_;
+    std::chrono::steady_clock::time_point start_;
+    bool exited_{false};
+    bool cancelled_{false};
+    bool timed_out_{false};
+
+#ifdef _WIN32
+    void* process_{nullptr};
+    void* thread_{nullptr};
+    void* output_pipe_{nullptr};
+#else
+    int pid_{-1};
+    int output_fd_{-1};
+#endif
+};
+
+/**
+ * @brief Write end of a pipe feeding the stdin of a child (see ffmpegProcess::startWithInput())
+ *
+ * Closing it, or destroying it, gives the child the end of its input.
+ */
+class InputPipe {
+public:
+    ~InputPipe();
+
+    InputPipe(const InputPipe&) = delete;
+    InputPipe& operator=(const InputPipe&) = delete;
+
+    /**
+     * @brief Writes all of `data`, blocking while the pipe is full
+     * @return false once the child stopped reading (exited, cancelled) or after close()
+     */
+    bool write(const char* data, size_t size);
+
+    void close();
+
+private:
+    friend class ffmpegProcess;
+    InputPipe() = default;
+
+#ifdef _WIN32
+    void* pipe_{nullptr};
+#else
+    int fd_{-1};
+#endif
+};
 
 class ffmpegProcess {
 public:
+    using OutputCallback = std::function<void(const char* data, size_t size)>;
+    using SampleCallback = std::function<void(const ProcessSample& sample)>;
+
     explicit ffmpegProcess(const std::filesystem::path& ExecutablePath_init, const std::vector<std::string>& args_init);
     ~ffmpegProcess() = default;
 
     std::filesystem::path getExecutablePath();
     std::vector<std::string> getArgs();
-    
+
+    /**
+     * @brief Captures the child's stdout into ProcessResult::output
+     */
+    void setCaptureOutput(bool enabled);
+
+    /**
+     * @brief Streams the child's stdout to a callback as it is produced
+     *
+     * For large outputs (e.g. rawvideo on pipe:1) that must not be buffered in
+     * memory. The callback runs on the reaper thread, with chunks of arbitrary
+     * size; ProcessResult::output stays empty.
+     */
+    void setOutputCallback(OutputCallback callback);
+
+    /**
+     * @brief Receives the resource use of the child every sampling interval (Linux only)
+     *
+     * The callback runs on the sampler thread while it holds the handle's lock:
+     * it must return quickly and must not call back into the handle.
+     */
+    void setSampleCallback(SampleCallback callback);
+
+    /**
+     * @brief Prints the [EXECUTE] line before launching (enabled by default)
+     */
+    void setEcho(bool enabled);
+
+    /**
+     * @brief Streams FFmpeg progress to a callback
+     *
+     * Injects `-progress pipe:N -nostats` in front of the arguments (fd 3 on POSIX,
+     * stdout on Windows where it cannot be combined with output capture). The
+     * callback runs on a reader thread; the last event is delivered before the
+     * process result becomes available.
+     * @param callback Receives one event per progress report
+     * @param duration_seconds Expected media duration, used for percent/ETA (0 = unknown)
+     */
+    void setProgressCallback(FFmpegMulti::Core::ProgressCallback callback, double duration_seconds = 0.0);
+
+    /**
+     * @brief Stops run() after this delay (0 = no limit)
+     */
+    void setTimeout(std::chrono::milliseconds timeout);
+
+    /**
+     * @brief Sends the child's console output to a file instead of the terminal
+     *
+     * stderr (and stdout unless it is captured) is appended to the file, stdin is
+     * detached from the terminal and the command line is written as a header.
+     * Used to run several processes side by side without interleaved output.
+     * @param path Log file (empty = inherit the terminal)
+     */
+    void setLogFile(const std::filesystem::path& path);
+
+    /**
+     * @brief Pins the child to these logical CPUs (empty = inherit the parent's)
+     *
+     * Linux: the whole process and its threads; Windows: CPUs 0-63 only;
+     * ignored on other systems.
+     */
+    void setCpuAffinity(const std::vector<unsigned>& cpus);
+
+    /**
+     * @brief Command line as a displayable string (for logs only)
+     */
+    std::string getCommandString() const;
+
+    /**
+     * @brief Launches the executable with its argument vector (no shell involved)
+     * @return Handle on the running process (its result reports launch failures)
+     */
+    std::shared_ptr<ProcessHandle> start();
+
+    /**
+     * @brief Launches `producer` with its stdout connected to the stdin of `consumer`
+     *
+     * The pipe joins the two children directly: the data (e.g. y4m frames from
+     * ffmpeg into an encoder) never goes through this process. The consumer is
+     * started first; if the producer cannot be launched, the consumer sees an
+     * empty input. Output capture and callbacks of the producer are ignored.
+     * @return Handles of the producer and the consumer, in that order
+     */
+    static std::pair<std::shared_ptr<ProcessHandle>, std::shared_ptr<ProcessHandle>> startPipeline(ffmpegProcess& producer, ffmpegProcess& consumer);
+
+    /**
+     * @brief Launches the process with its stdin connected to a pipe written by this process
+     *
+     * For data produced here (e.g. raw frames decoded by several workers) that
+     * must reach the child in order. The pipe is closed for every other child.
+     * @return Handle of the process and the write end of its stdin (nullptr if the launch failed)
+     */
+    std::pair<std::shared_ptr<ProcessHandle>, std::unique_ptr<InputPipe>> startWithInput();
+
+    /**
+     * @brief Launches the process and waits for it, honouring the timeout
+     * @return Exit status, signal and timings of the child process
+     */
+    ProcessResult run();
+
     /**
      * @brief Execute the FFmpeg command with arguments
      * @return true if execution succeeded, false otherwise
      */
     bool execute();
-    
+
 private:
     std::filesystem::path ExecutablePath;
     std::vector<std::string> args;
-};
\ No newline at end of file
+    bool captureOutput{false};
+    bool echo{true};
+    std::chrono::milliseconds timeout{0};
+    std::filesystem::path logFile{};
+    std::vector<unsigned> cpuAffinity{};
+    FFmpegMulti::Core::ProgressCallback progressCallback{};
+    double progressDuration{0.0};
+    OutputCallback outputCallback{};
+    SampleCallback sampleCallback{};
+
+    // Pipe ends set by startPipeline() for the duration of start()
+#ifdef _WIN32
+    void* stdinPipe{nullptr};
+    void* stdoutPipe{nullptr};
+#else
+    int stdinFd{-1};
+    int stdoutFd{-1};
+#endif
+};
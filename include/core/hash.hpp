@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <string_view>
+
+namespace FFmpegMulti {
+namespace Hash {
+
+/**
+ * @brief Non-cryptographic 64-bit hash, fed 8 bytes at a time (several GB/s)
+ *
+ * Identifies job settings and checks file integrity; it does not resist
+ * deliberate collisions. Words are read in native byte order.
+ */
+class Hasher {
+public:
+    void update(const void* data, size_t size);
+    void update(std::string_view text) { update(text.data(), text.size()); }
+
+    /**
+     * @brief Digest of everything fed so far, as 16 hex digits
+     */
+    std::string hex() const;
+
+private:
+    void mix(const unsigned char* bytes);
+
+    uint64_t state_{0xCBF29CE484222325ull};
+    uint64_t length_{0};
+    unsigned char pending_[8] = {};
+    size_t pending_size_{0};
+};
+
+/**
+ * @brief Hash of a text, hex
+ */
+std::string hex64(std::string_view text);
+
+/**
+ * @brief Hash of a file content, hex (empty if unreadable)
+ */
+std::string fileHex64(const std::filesystem::path& path);
+
+} // namespace Hash
+} // namespace FFmpegMulti
@@ -1,13 +1,37 @@
 #pragma once
 
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "cpu_topology.hpp"
+#include "ffmpeg_process.hpp"
+#include "job_metrics.hpp"
+#include "progress.hpp"
+#include "trace.hpp"
+
 namespace FFmpegMulti {
 namespace Core {
 
 /**
  * @brief Base interface for all jobs
+ *
+ * Besides the blocking execute(), a job can be started in the background with
+ * start() and stopped with cancel(). Child processes launched through
+ * runProcess() are tracked so that cancel() can terminate them.
  */
 class Job {
 public:
+    Job() = default;
+    Job(const Job& other);
+    Job& operator=(const Job& other);
     virtual ~Job() = default;
 
     /**
@@ -15,6 +39,159 @@ public:
      * @return true if the job succeeded, false otherwise
      */
     virtual bool execute() = 0;
+
+    /**
+     * @brief Runs execute() on a background thread
+     * @return Future holding the execute() result
+     * @note The job must outlive the returned future
+     */
+    std::future<bool> start();
+
+    /**
+     * @brief Requests cancellation and stops the running child processes
+     *
+     * Children receive SIGTERM, then SIGKILL after the grace period.
+     */
+    void cancel(std::chrono::milliseconds grace = std::chrono::seconds(5));
+
+    /**
+     * @brief Checks whether cancel() was called
+     */
+    bool isCancelled() const;
+
+    /**
+     * @brief Maximum run time of each child process (0 = no limit)
+     */
+    void setTimeout(std::chrono::milliseconds timeout);
+    std::chrono::milliseconds getTimeout() const;
+
+    /**
+     * @brief Receives live progress of the FFmpeg processes run by the job
+     * @note Called from a reader thread
+     */
+    void setProgressCallback(ProgressCallback callback);
+    ProgressCallback getProgressCallback() const;
+
+    /**
+     * @brief Sends the console output of the job's child processes to a file
+     * @param path Log file, appended to by every process (empty = terminal)
+     */
+    void setLogFile(const std::filesystem::path& path);
+    std::filesystem::path getLogFile() const;
+
+    /**
+     * @brief Number of cores the job typically keeps busy while it runs
+     *
+     * Used by the batch runner to size its worker pool.
+     */
+    virtual unsigned threadDemand() const;
+
+    /**
+     * @brief Encoder writing the job's main output (e.g. "libx265"), to group reports
+     * @return Empty if the job does not encode video
+     */
+    virtual std::string encoderName() const;
+
+    /**
+     * @brief Share of the machine planned for the job (see planAllocations())
+     *
+     * Its child processes are pinned to the CPUs, and encoders without an
+     * explicit thread count start `threads` threads. Set by the batch runner
+     * before execute().
+     */
+    void setCpuAllocation(const CpuAllocation& allocation);
+    const CpuAllocation& getCpuAllocation() const;
+
+    /**
+     * @brief Resources used so far by the child processes of the job, over every execute() call
+     */
+    JobMetrics getMetrics() const;
+
+    /**
+     * @brief Records the steps and child processes of the job on a track of `trace`
+     *
+     * Each child process becomes a span on a lane of its own, with its CPU use,
+     * memory and I/O rate as counters over time. Copies of the job (e.g.
+     * chunks) record on the same track. Set by the batch runner before execute().
+     * @param trace Timeline to record on (nullptr = none)
+     * @param track Track of the job in `trace` (see Trace::addTrack())
+     */
+    void setTrace(std::shared_ptr<Trace> trace, int track);
+    std::shared_ptr<Trace> getTrace() const;
+    int getTraceTrack() const;
+
+protected:
+    /**
+     * @brief Checks whether somebody listens to progress (lets jobs skip duration probing)
+     */
+    bool hasProgressCallback() const;
+
+    /**
+     * @brief Forwards FFmpeg progress of `process` to the job's progress callback, if any
+     * @param process FFmpeg process about to be run
+     * @param duration_seconds Expected output duration (0 = unknown)
+     */
+    void trackProgress(ffmpegProcess& process, double duration_seconds) const;
+
+    /**
+     * @brief Sends a progress event computed by the job itself (e.g. merged from parallel processes)
+     */
+    void reportProgress(const Progress& progress) const;
+
+    /**
+     * @brief Runs a child process on behalf of the job (cancellable, honours the timeout)
+     * @param process Process to launch
+     * @return Result of the process, marked cancelled if the job was cancelled before launch
+     */
+    ProcessResult runProcess(ffmpegProcess& process);
+
+    /**
+     * @brief Runs a child process whose stdin is written by `feed` (see ffmpegProcess::startWithInput)
+     *
+     * `feed` runs on the calling thread once the process is started; its input
+     * ends when `feed` returns. Writes fail once the process exits, so a
+     * cancelled or timed out process also ends the feeding.
+     */
+    ProcessResult runProcess(ffmpegProcess& process, const std::function<void(InputPipe& input)>& feed);
+
+    /**
+     * @brief Runs two child processes joined by a pipe (see ffmpegProcess::startPipeline)
+     *
+     * Cancellation stops both; the timeout applies to the pipeline as a whole.
+     * @return Results of the producer and the consumer, in that order
+     */
+    std::pair<ProcessResult, ProcessResult> runPipeline(ffmpegProcess& producer, ffmpegProcess& consumer);
+
+    /**
+     * @brief Counts the processes of a sub-job in the metrics of this one (e.g. chunks run on a nested batch)
+     */
+    void addMetrics(const JobMetrics& metrics);
+
+    /**
+     * @brief Marks a step of the job on its trace track, until the returned span ends
+     * @return Span recording nothing if the job is not traced
+     */
+    Trace::Span traceStep(const std::string& name) const;
+
+private:
+    void prepareProcess(ffmpegProcess& process) const;
+    int traceProcess(ffmpegProcess& process) const; // Lane of the process, -1 if not traced
+    void traceProcessEnd(ffmpegProcess& process, int lane, Trace::Clock::time_point start, const ProcessResult& result) const;
+    std::chrono::milliseconds registerProcess(const std::shared_ptr<ProcessHandle>& handle);
+    void unregisterProcess(const std::shared_ptr<ProcessHandle>& handle);
+
+    mutable std::mutex processes_mutex_;
+    std::vector<std::shared_ptr<ProcessHandle>> processes_;
+    std::atomic<bool> cancelled_{false};
+    std::chrono::milliseconds timeout_{0};
+    ProgressCallback progress_callback_{};
+    std::filesystem::path log_file_{};
+    CpuAllocation cpu_allocation_{};
+    mutable std::mutex metrics_mutex_; // Processes may finish on several threads at once
+    JobMetrics metrics_{};
+    std::shared_ptr<Trace> trace_{};
+    int trace_track_{0};
+    std::chrono::milliseconds cancel_grace_{std::chrono::seconds(5)};
 };
 
 } // namespace Core
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include "ffmpeg_process.hpp"
+
+namespace FFmpegMulti {
+namespace Core {
+
+/**
+ * @brief Resources used by the child processes of a job, over all its attempts
+ *
+ * Times, faults, switches and bytes are summed over the processes; peaks are
+ * those of the largest single process (processes running side by side, such
+ * as chunk encodes, are not added up).
+ */
+struct JobMetrics {
+    unsigned processes{0}; // Child processes that were launched
+    double process_seconds{0.0}; // Wall time summed over the processes
+    double user_cpu_seconds{0.0};
+    double system_cpu_seconds{0.0};
+    long peak_rss_kb{0};
+    long major_faults{0};
+    long voluntary_switches{0};
+    long involuntary_switches{0};
+    uint64_t read_bytes{0}; // Through system calls, pipes and page cache included
+    uint64_t write_bytes{0};
+    uint64_t storage_read_bytes{0}; // Actually fetched from storage (Linux only)
+    uint64_t storage_write_bytes{0};
+    unsigned peak_threads{0};
+    double peak_cores{0.0}; // Highest CPU use of one process over a sampling interval
+
+    /**
+     * @brief Accounts for one finished child process (ignored if it never started)
+     */
+    void add(const ProcessResult& result);
+
+    /**
+     * @brief Accounts for the processes of another job (e.g. a chunk run on a nested batch)
+     */
+    void merge(const JobMetrics& other);
+
+    double cpuSeconds() const { return user_cpu_seconds + system_cpu_seconds; }
+
+    /**
+     * @brief Cores kept busy on average over `wall_seconds` (0 if no time elapsed)
+     */
+    double averageCores(double wall_seconds) const;
+
+    /**
+     * @brief JSON object with every counter, plus the average core use over `wall_seconds`
+     */
+    std::string toJson(double wall_seconds) const;
+};
+
+} // namespace Core
+} // namespace FFmpegMulti
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace FFmpegMulti {
+namespace Json {
+
+/**
+ * @brief Error raised by Value::parse(), with the byte offset of the problem
+ */
+class ParseError : public std::runtime_error {
+public:
+    ParseError(const std::string& message, size_t offset);
+    size_t offset() const { return offset_; }
+
+private:
+    size_t offset_;
+};
+
+/**
+ * @brief Parsed JSON document (DOM)
+ *
+ * Objects keep their members in document order. Lookups never throw: a
+ * missing key or index yields a null value, and the as*() accessors return
+ * their fallback when the value has another type. Numbers written as strings
+ * (ffprobe does this for durations and bitrates) are converted by asNumber().
+ */
+class Value {
+public:
+    enum class Type { Null, Bool, Number, String, Array, Object };
+
+    Value() = default;
+
+    /**
+     * @brief Parses a complete JSON text in a single pass
+     * @throw ParseError if the text is not valid JSON
+     */
+    static Value parse(std::string_view text);
+
+    Type type() const { return type_; }
+    bool isNull() const { return type_ == Type::Null; }
+    bool isObject() const { return type_ == Type::Object; }
+    bool isArray() const { return type_ == Type::Array; }
+    bool isString() const { return type_ == Type::String; }
+    bool isNumber() const { return type_ == Type::Number; }
+
+    bool asBool(bool fallback = false) const;
+    double asNumber(double fallback = 0.0) const;
+    long long asInt(long long fallback = 0) const;
+    std::string asString(const std::string& fallback = "") const; // Numbers keep their original text
+
+    /**
+     * @brief Member of an object (null value if absent)
+     */
+    const Value& operator[](std::string_view key) const;
+
+    /**
+     * @brief Element of an array (null value if out of range)
+     */
+    const Value& operator[](size_t index) const;
+
+    bool contains(std::string_view key) const;
+    size_t size() const; // Number of elements or members
+
+    const std::vector<Value>& items() const { return array_; }
+    const std::vector<std::pair<std::string, Value>>& members() const { return object_; }
+
+private:
+    friend class Parser;
+
+    Type type_{Type::Null};
+    bool bool_{false};
+    double number_{0.0};
+    std::string string_{}; // String value, or the text of a number
+    std::vector<Value> array_{};
+    std::vector<std::pair<std::string, Value>> object_{};
+};
+
+/**
+ * @brief Quotes and escapes a string for writing into a JSON document
+ */
+std::string quote(std::string_view text);
+
+} // namespace Json
+} // namespace FFmpegMulti
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <filesystem>
+#include <string>
 
 namespace FFmpegMulti {
 namespace PathUtils {
@@ -11,5 +12,36 @@ std::filesystem::path getExecutableDir();
 // Obtenir le chemin absolu vers le dossier extern/
 std::filesystem::path getExternPath();
 
+// Chemin d'un outil externe (ffmpeg, ffprobe, mkvmerge...) : extern/<subdir>/<name>[.exe] s'il existe,
+// sinon le nom seul pour une recherche dans le PATH
+std::filesystem::path getToolPath(const std::string& name, const std::filesystem::path& subdir = {});
+
+// Dossier de cache de l'utilisateur pour l'application (créé si besoin) :
+// %LOCALAPPDATA%\ffmpeg_multi, ~/Library/Caches/ffmpeg_multi ou $XDG_CACHE_HOME/ffmpeg_multi (~/.cache par défaut)
+std::filesystem::path getCacheDir();
+
+// Nom temporaire d'une sortie en cours d'écriture : <dossier>/<nom>.partial<ext>
+// (l'extension est conservée pour que ffmpeg/mkvmerge choisissent le bon format)
+std::filesystem::path getPartialPath(const std::filesystem::path& output);
+
+// Renomme atomiquement une sortie terminée vers son nom final (remplace l'existant) ;
+// une sortie interrompue ne porte donc jamais le nom final. En cas d'échec, `partial` est conservé.
+// Entre deux volumes, copie d'abord (clone ou copy_file_range) vers <nom>.staging<ext> à côté
+// de `output`, renomme, puis seulement alors supprime `partial`.
+bool commitPartial(const std::filesystem::path& partial, const std::filesystem::path& output);
+
+// Clone copy-on-write de `from` vers `to` (FICLONE sous Linux, clonefile sous macOS) :
+// instantané et sans espace disque supplémentaire, mais seulement sur Btrfs, XFS, APFS...
+// Retourne false si le système de fichiers ne le permet pas (rien n'est laissé à `to`).
+bool reflinkFile(const std::filesystem::path& from, const std::filesystem::path& to);
+
+// Copie de `from` vers `to` (remplacé s'il existe) : clone si possible, sinon copy_file_range
+// (copie dans le noyau, sous Linux), sinon copie classique
+bool copyFile(const std::filesystem::path& from, const std::filesystem::path& to);
+
+// Comme copyFile(), mais essaie un lien physique avant la copie (même volume) :
+// `to` partage alors le contenu de `from` et ne doit pas être modifié sur place
+bool linkOrCopyFile(const std::filesystem::path& from, const std::filesystem::path& to);
+
 } // namespace PathUtils
 } // namespace FFmpegMulti
\ No newline at end of file
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+
+namespace FFmpegMulti {
+namespace Core {
+
+/**
+ * @brief Snapshot of a running FFmpeg encode, decoded from `-progress` output
+ */
+struct Progress {
+    int64_t frame{0}; // Frames written so far
+    double fps{0.0}; // Current encoding speed in frames per second
+    int64_t out_time_us{0}; // Output timestamp reached (microseconds)
+    int64_t total_size{0}; // Bytes written so far
+    double bitrate_kbps{0.0}; // Current output bitrate
+    double speed{0.0}; // Realtime factor (1.0 = realtime)
+    bool finished{false}; // Last report of the process (progress=end)
+    double duration_seconds{0.0}; // Expected media duration (0 = unknown)
+
+    /**
+     * @brief Completion in percent, or -1 if the duration is unknown
+     */
+    double percent() const;
+
+    /**
+     * @brief Estimated remaining time in seconds, or -1 if unknown
+     */
+    double etaSeconds() const;
+};
+
+using ProgressCallback = std::function<void(const Progress&)>;
+
+/**
+ * @brief Incremental parser for the key=value stream of `ffmpeg -progress`
+ *
+ * Data can be fed in arbitrary chunks; a Progress event is emitted each time
+ * FFmpeg closes a block with `progress=continue` or `progress=end`.
+ */
+class ProgressParser {
+public:
+    explicit ProgressParser(double duration_seconds = 0.0);
+
+    /**
+     * @brief Consumes a chunk of the progress stream
+     * @param data Raw bytes read from the progress pipe
+     * @param size Number of bytes
+     * @param callback Receives one event per completed block
+     */
+    void feed(const char* data, size_t size, const ProgressCallback& callback);
+
+private:
+    std::string pending_;
+    Progress current_;
+
+    void parseLine(const std::string& line, const ProgressCallback& callback);
+};
+
+} // namespace Core
+} // namespace FFmpegMulti
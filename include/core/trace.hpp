@@ -0,0 +1,138 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace FFmpegMulti {
+namespace Core {
+
+/**
+ * @brief Timeline of a run in the Chrome trace-event format (chrome://tracing, ui.perfetto.dev)
+ *
+ * A trace is a list of tracks (one per job, plus one for the batch), each
+ * split in lanes: lane 0 holds the steps of the job, nested as they run, and
+ * every child process gets a lane of its own while it runs, so processes
+ * running side by side (chunks, pipelines) do not overlap. Counters (CPU
+ * cores, memory, I/O rate) are attached to a track and drawn as graphs.
+ *
+ * Events are kept in memory and written as one JSON document by write().
+ * Every method can be called from any thread.
+ */
+class Trace {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * @brief Interval recorded when it ends (destruction or end()), see Trace::span()
+     * @note The trace must outlive the span; a default constructed span records nothing
+     */
+    class Span {
+    public:
+        Span() = default;
+        Span(Span&& other) noexcept;
+        Span& operator=(Span&& other) noexcept;
+        ~Span();
+
+        Span(const Span&) = delete;
+        Span& operator=(const Span&) = delete;
+
+        /**
+         * @brief Records the span now instead of at destruction
+         */
+        void end();
+
+    private:
+        friend class Trace;
+
+        Trace* trace_{nullptr};
+        int track_{0};
+        int lane_{0};
+        std::string name_{};
+        std::string category_{};
+        Clock::time_point start_{};
+    };
+
+    /**
+     * @brief Starts an empty trace, timestamps count from now
+     */
+    Trace();
+
+    Trace(const Trace&) = delete;
+    Trace& operator=(const Trace&) = delete;
+
+    /**
+     * @brief Adds a track, shown in creation order
+     * @param name Label of the track (e.g. the job name)
+     * @param lane_label Prefix of the lanes handed out by acquireLane() (e.g. "process", "worker")
+     * @return Track id
+     */
+    int addTrack(const std::string& name, const std::string& lane_label = "process");
+
+    /**
+     * @brief Reserves the first free lane above 0 of a track, until releaseLane()
+     */
+    int acquireLane(int track);
+    void releaseLane(int track, int lane);
+
+    /**
+     * @brief Starts a span on a lane, recorded when the returned object ends
+     */
+    Span span(int track, int lane, const std::string& name, const std::string& category);
+
+    /**
+     * @brief Records a finished interval
+     * @param args Members of a JSON object shown with the event (e.g. "\"exit\":0"), may be empty
+     */
+    void complete(int track, int lane, const std::string& name, const std::string& category,
+                  Clock::time_point start, Clock::time_point end, const std::string& args = {});
+
+    /**
+     * @brief Records the values of a counter at one point in time
+     * @param values One series per value, drawn stacked on the counter's graph
+     */
+    void counter(int track, const std::string& name, Clock::time_point at, const std::vector<std::pair<std::string, double>>& values);
+
+    /**
+     * @brief Trace as a JSON document ({"traceEvents":[...]}), sorted by time
+     */
+    std::string toJson() const;
+
+    /**
+     * @brief Writes toJson() to a file, atomically
+     * @return false if the file could not be written
+     */
+    bool write(const std::filesystem::path& file) const;
+
+private:
+    struct Event {
+        char phase; // 'X' = complete, 'C' = counter
+        int track;
+        int lane;
+        std::string name;
+        std::string category;
+        int64_t timestamp_us;
+        int64_t duration_us;
+        std::string args; // Members of the args object
+    };
+
+    struct Track {
+        std::string name;
+        std::string lane_label;
+        std::vector<bool> lanes; // Lanes in use, lane 0 excluded
+    };
+
+    int64_t microseconds(Clock::time_point at) const;
+
+    Clock::time_point origin_;
+    mutable std::mutex mutex_;
+    std::vector<Track> tracks_;
+    std::vector<Event> events_;
+};
+
+} // namespace Core
+} // namespace FFmpegMulti
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "scene_detector.hpp"
+
+namespace FFmpegMulti {
+namespace Jobs {
+namespace AutoBoost {
+
+/**
+ * @brief Range of frames encoded on its own with its own CRF (one scene, or part of a long one)
+ */
+struct Zone {
+    int64_t start_frame{0};
+    int64_t frame_count{0};
+    double crf{0.0};
+    double mean_db{0.0}; // Mean SSIM of the probe encode, in dB
+    double low_db{0.0}; // Low percentile SSIM of the probe encode, in dB
+};
+
+/**
+ * @brief Splits [0, total_frames) at the cuts
+ * @param max_frames Longer scenes are split in equal parts no longer than this (0 = never)
+ */
+std::vector<Zone> planZones(const std::vector<SceneCut>& cuts, int64_t total_frames, int64_t max_frames);
+
+/**
+ * @brief Per-frame SSIM in dB from the stats of ffmpeg's ssim filter
+ *
+ * Reads the `All:` value of lines like "n:1 Y:0.993 U:0.996 V:0.996 All:0.994 (22.4)".
+ * Identical frames are capped at 60 dB instead of infinity.
+ */
+std::vector<double> parseSsimStats(const std::string& stats);
+
+/**
+ * @brief Value below which `fraction` of the values fall (0.0 - 1.0, nearest rank)
+ */
+double percentile(std::vector<double> values, double fraction);
+
+/**
+ * @brief CRF of a zone from its probe quality relative to the whole title
+ *
+ * As in Auto-Boost, a zone whose worst frames fall below the title average is
+ * boosted (lower CRF) and a zone above it gives bits back:
+ * adjustment = (1 - zone_low / title_mean) * strength, in 0.25 steps,
+ * clamped to +/- max_delta, the result kept within the encoder's 1 - 63.
+ */
+double zoneCrf(double base_crf, double zone_low_db, double title_mean_db, double strength, double max_delta);
+
+/**
+ * @brief Joins IVF files of the same stream back to back
+ *
+ * The header of the first part is kept with the total frame count, and the
+ * timestamps of each part are shifted to follow the previous one.
+ * @param frames Receives the number of frames written
+ * @param error Receives the reason of a failure
+ */
+bool concatIvf(const std::vector<std::filesystem::path>& parts, const std::filesystem::path& output, int64_t& frames, std::string& error);
+
+/**
+ * @brief Writes the zones as CSV (start_frame,start_time,frames,mean_db,low_db,crf)
+ */
+bool writeZones(const std::vector<Zone>& zones, double frame_rate, const std::filesystem::path& path);
+
+} // namespace AutoBoost
+} // namespace Jobs
+} // namespace FFmpegMulti
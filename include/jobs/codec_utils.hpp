@@ -47,6 +47,18 @@ public:
      */
     static void addFFV1Args(std::vector<std::string>& args, int level = 3, int coder = 1, int context = 1, int slices = 24);
     
+    // ========================================================================
+    // SCHEDULING
+    // ========================================================================
+    
+    /**
+     * @brief Estimates how many cores one encode typically saturates
+     * @param codec Codec type
+     * @param preset Encoding preset (slower presets scale further)
+     * @return Typical number of busy cores (at least 1)
+     */
+    static unsigned getTypicalThreadUsage(Encode::Codec codec, const std::string& preset);
+    
     // ========================================================================
     // CONTAINER UTILS
     // ========================================================================
@@ -32,10 +32,22 @@ struct EncodeConfig {
     std::string preset{"medium"}; // Encoding preset
     int framerate{24}; // Default FPS
     std::string input_pattern{"%08d.png"}; // Image pattern (e.g., 00000001.png)
+
+    // Parallel decoding: images are decoded by several ffmpeg processes and piped
+    // to the encoder as raw frames, in order (0 = the encoder reads the images itself)
+    int decode_workers{0};
+    int decode_chunk_frames{8}; // Images per decoder process
 };
 
 /**
  * @brief Image-to-video encoding job
+ *
+ * By default ffmpeg reads the sequence through its image2 demuxer, which
+ * decodes one image at a time: with 4K PNG or TIFF the decoder, not the
+ * encoder, sets the pace. With decode_workers, chunks of the sequence are
+ * decoded (and converted to the encoder's pixel format) by that many ffmpeg
+ * processes at once; their raw frames go through a bounded reorder buffer
+ * and are written in order to the stdin of the encoder.
  */
 class EncodeJob : public FFmpegMulti::Core::Job {
 public:
@@ -47,6 +59,8 @@ public:
     const EncodeConfig& config() const;
 
     bool execute() override;
+    unsigned threadDemand() const override;
+    std::string encoderName() const override;
 
     std::vector<std::string> buildCommand() const;
     std::string getCommandString() const;
@@ -54,10 +68,14 @@ public:
 private:
     EncodeConfig config_;
 
+    bool executePiped();
+    std::vector<std::string> buildCommand(const std::vector<std::string>& input_args) const;
+    std::string getPipePixelFormat(const std::string& image_pix_fmt) const;
     bool validatePaths() const;
     std::string getOutputPath() const;
     std::string getContainerExtension() const;
     std::string getCodecName() const;
+    double getExpectedDuration() const;
     void addCodecSpecificArgs(std::vector<std::string>& args) const;
 };
 
@@ -92,6 +110,8 @@ public:
     EncodeJobBuilder& quality(int crf);
     EncodeJobBuilder& preset(const std::string& p);
 
+    EncodeJobBuilder& decodeWorkers(int workers, int chunk_frames = 8); // Parallel image decoding, piped to the encoder
+
     EncodeJob build() const;
 
 private:
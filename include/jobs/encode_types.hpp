@@ -33,6 +33,53 @@ enum class RateControl {
     CBR // Constant Bitrate
 };
 
+// ============================================================================
+// QUALITY METRICS
+// ============================================================================
+enum class QualityMetric {
+    SSIM, // Structural similarity, 0-1 (ssim filter)
+    PSNR, // Peak signal-to-noise ratio in dB (psnr filter)
+    VMAF // Netflix VMAF, 0-100 (libvmaf filter, only in builds that include it)
+};
+
+/**
+ * @brief Quality to reach instead of a fixed CRF
+ *
+ * Short samples spread over the source are encoded at several CRFs in
+ * parallel and compared with the source; the real encode then uses the
+ * highest CRF whose interpolated mean score still reaches the target.
+ */
+struct QualityTarget {
+    QualityMetric metric{QualityMetric::VMAF};
+    double score{95.0}; // Mean score to reach, in the unit of the metric
+    int samples{4}; // Samples spread over the source
+    double sample_seconds{4.0}; // Length of each sample
+    int probes{4}; // CRFs of the first search round, spread over the range
+    int min_crf{0}; // Search range (0 = codec default)
+    int max_crf{0};
+};
+
+// ============================================================================
+// STREAMING OUTPUT
+// ============================================================================
+enum class StreamingFormat {
+    HLS, // .m3u8 playlist
+    DASH // .mpd manifest
+};
+
+/**
+ * @brief Segmented output, ready to serve, instead of a single file
+ *
+ * The output path names the playlist (or manifest); the fMP4/CMAF segments
+ * are written next to it, prefixed with its name. A keyframe is forced on
+ * every segment boundary, so renditions with the same segment length
+ * switch cleanly.
+ */
+struct StreamingOutput {
+    StreamingFormat format{StreamingFormat::HLS};
+    double segment_seconds{4.0}; // Length of each segment (and of the GOPs that start them)
+};
+
 // ============================================================================
 // PIXEL FORMATS
 // ============================================================================
@@ -111,6 +158,7 @@ struct MasteringDisplay {
 // AUDIO CONFIGURATION
 // ============================================================================
 struct AudioConfig {
+    bool disabled{false}; // If true, drop audio (-an)
     bool copy_audio{false}; // If true, copy audio stream as-is
     std::string source_path{}; // Source file for audio (if different from video)
     std::string codec{"aac"}; // Audio codec if not copying
@@ -134,6 +182,7 @@ struct EncodeConfig {
     int bitrate_kbps{0}; // For VBR/CBR modes
     int max_bitrate_kbps{0}; // Maximum bitrate (for CBR)
     int buffer_size_kbps{0}; // VBV buffer size
+    std::optional<QualityTarget> target_quality{}; // CRF searched for a target score (replaces quality)
     
     // --- Encoding Parameters ---
     std::string preset{"slow"}; // Encoding speed preset
@@ -171,8 +220,20 @@ struct EncodeConfig {
     int qp_cb_offset{0}; // QP offset for Cb channel (NVENC)
     int qp_cr_offset{0}; // QP offset for Cr channel (NVENC)
     
+    // --- Input Range ---
+    double start_time{0.0}; // Seek position in seconds (input seeking, should be a keyframe)
+    double duration{0.0}; // Length to encode in seconds (0 = until the end)
+    
+    // --- Chunked Encoding ---
+    double chunk_seconds{0.0}; // Split at keyframes into segments of about this length, encoded in parallel (0 = single process)
+    int chunk_workers{0}; // Segments encoded at once (0 = cores / encoder threads)
+    int chunk_retries{2}; // Extra attempts for a failed segment
+    
     // --- Output Container ---
     std::string container{"mp4"}; // Output container format
+    bool overwrite{false}; // Replace an existing output file (-y)
+    bool output_cache{false}; // Reuse an identical earlier encode from Pipeline::OutputCache
+    std::optional<StreamingOutput> streaming{}; // HLS/DASH segments and playlist (replaces the single file)
     
     // --- Audio ---
     AudioConfig audio{};
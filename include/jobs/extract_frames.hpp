@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <string>
 #include <vector>
 #include "../core/job.hpp"
@@ -25,6 +26,15 @@ struct ExtractFramesConfig {
     bool create_subfolder{true};
     std::string subfolder_name;
     ImageFormat format{ImageFormat::PNG};
+
+    // Parallel mode: the timeline is split into this many keyframe-aligned
+    // segments extracted by separate ffmpeg processes (0 or 1 = one process)
+    int parallel_segments{0};
+
+    // Range and numbering of one segment (set by the parallel mode)
+    double start_time{0.0}; // Input seek in seconds
+    double duration{0.0}; // 0 = until the end
+    int64_t start_number{0}; // Number of the first image
 };
 
 /**
@@ -40,6 +50,7 @@ public:
     const ExtractFramesConfig& config() const;
 
     bool execute() override;
+    unsigned threadDemand() const override;
 
     std::vector<std::string> buildCommand() const;
     std::string getCommandString() const;
@@ -47,8 +58,12 @@ public:
 private:
     ExtractFramesConfig config_;
 
+    bool executeSingle();
+    bool executeParallel();
+
     bool validatePaths() const;
     bool createOutputDirectory() const;
+    std::string getTargetDir() const;
     std::string getOutputPattern() const;
     std::string getFileExtension() const;
 };
@@ -65,6 +80,7 @@ public:
     ExtractFramesBuilder& createSubfolder(bool create);
     ExtractFramesBuilder& subfolderName(const std::string& name);
     ExtractFramesBuilder& format(ImageFormat fmt);
+    ExtractFramesBuilder& parallel(int segments);
 
     ExtractFramesBuilder& png();
     ExtractFramesBuilder& tiff();
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include "encode_types.hpp"
+#include "../core/job.hpp"
+
+namespace FFmpegMulti {
+namespace Jobs {
+
+/**
+ * @brief One output of a ladder: a size and its own encoding settings
+ */
+struct Rendition {
+    std::string output_path;
+    int width{0}; // 0 = follows the aspect ratio of the source
+    int height{0}; // 0 = follows the aspect ratio of the source (both 0 = source size)
+    Encode::EncodeConfig config{};
+};
+
+/**
+ * @brief Encodes several renditions of one source in a single FFmpeg process
+ *
+ * The source is decoded once; a split filtergraph feeds one scaler per
+ * rendition and every output gets the arguments of its own EncodeConfig
+ * (see ReencodeJob::buildOutputArgs()). Start time and duration come from the
+ * first rendition, chunked encoding, target quality and the output cache are
+ * not available here.
+ *
+ * Streaming renditions share one segment length, so their keyframes line up;
+ * HLS renditions can be listed in a master playlist written at the end.
+ */
+class LadderJob : public FFmpegMulti::Core::Job {
+public:
+    LadderJob() = default;
+    explicit LadderJob(const std::string& input_path);
+
+    // Configuration
+    void setInputPath(const std::string& path);
+    std::string getInputPath() const;
+    void addRendition(const Rendition& rendition);
+    const std::vector<Rendition>& renditions() const;
+    void setMasterPlaylist(const std::string& path); // HLS master playlist of every rendition (empty = none)
+
+    // Command construction
+    std::vector<std::string> buildCommand() const;
+    std::string getCommandString() const;
+
+    // Execution
+    bool execute() override;
+
+    /**
+     * @brief Sum of the encoder threads of every rendition, up to the core count
+     */
+    unsigned threadDemand() const override;
+
+    /**
+     * @brief Encoders of the renditions, joined with '+' when they differ
+     */
+    std::string encoderName() const override;
+
+    /**
+     * @brief Validates the configuration before execution
+     * @throw std::runtime_error if the configuration is invalid
+     */
+    bool validate() const;
+
+private:
+    std::string input_path_{};
+    std::vector<Rendition> renditions_{};
+    std::string master_playlist_{};
+
+    std::string buildFilterGraph() const;
+    void removePartials() const;
+};
+
+class LadderBuilder {
+public:
+    LadderBuilder& input(const std::string& path);
+    LadderBuilder& rendition(const std::string& output, int width, int height, const Encode::EncodeConfig& config);
+    LadderBuilder& masterPlaylist(const std::string& path);
+    LadderJob build();
+
+private:
+    LadderJob job_;
+};
+
+} // namespace Jobs
+} // namespace FFmpegMulti
@@ -5,6 +5,93 @@
 
 namespace Jobs {
 
+/**
+ * @brief One stream reported by ffprobe (-show_streams)
+ */
+struct ProbeStream {
+    int index{-1};
+    std::string codec_type{}; // "video", "audio", "subtitle", "attachment", "data"
+    std::string codec_name{};
+    std::string codec_long_name{};
+    std::string profile{};
+    long long bit_rate{0};
+    double duration{0.0};
+    long long nb_frames{0};
+
+    // Video
+    int width{0};
+    int height{0};
+    std::string pix_fmt{};
+    std::string r_frame_rate{}; // "num/den"
+    std::string avg_frame_rate{};
+    std::string color_range{};
+    std::string color_space{};
+    std::string color_transfer{};
+    std::string color_primaries{};
+
+    // Audio
+    int sample_rate{0};
+    int channels{0};
+    std::string channel_layout{};
+
+    // Tags
+    std::string language{};
+    std::string title{};
+
+    /**
+     * @brief Frame rate from r_frame_rate (0 if unknown)
+     */
+    double frameRate() const;
+
+    /**
+     * @brief "HDR10" (PQ), "HLG" or "SDR", from color_transfer
+     */
+    std::string dynamicRange() const;
+};
+
+/**
+ * @brief Container information reported by ffprobe (-show_format)
+ */
+struct ProbeFormat {
+    std::string filename{};
+    std::string format_name{};
+    std::string format_long_name{};
+    double duration{0.0};
+    double start_time{0.0};
+    long long size{0};
+    long long bit_rate{0};
+    int nb_streams{0};
+};
+
+/**
+ * @brief Typed result of `ffprobe -print_format json -show_format -show_streams`
+ */
+struct ProbeResult {
+    ProbeFormat format{};
+    std::vector<ProbeStream> streams{};
+
+    /**
+     * @brief Parses the ffprobe JSON output in a single pass
+     * @throw std::runtime_error if the output is not valid JSON
+     */
+    static ProbeResult fromJson(const std::string& json);
+
+    /**
+     * @brief First stream of a type ("video", "audio"...), nullptr if none
+     */
+    const ProbeStream* firstStream(const std::string& codec_type) const;
+
+    int countStreams(const std::string& codec_type) const;
+};
+
+/**
+ * @brief Packet timestamps of the first video stream, in seconds from the start of the file
+ */
+struct PacketIndex {
+    std::vector<double> packets{}; // Every packet (one per frame for video), sorted
+    std::vector<double> keyframes{}; // Keyframe packets only, sorted
+};
+
 class ProbeJob {
 public:
     ProbeJob(const std::string& inputFile);
@@ -15,6 +102,7 @@ public:
     std::string getInputFile() const { return inputFile_; }
     std::string getOutput() const { return output_; }
     std::string getFormattedOutput() const { return formattedOutput_; }
+    const ProbeResult& getResult() const { return result_; }
     bool shouldExport() const { return shouldExport_; }
     std::string getExportPath() const { return exportPath_; }
     
@@ -22,6 +110,18 @@ public:
     void setShouldExport(bool value) { shouldExport_ = value; }
     void setExportPath(const std::string& path) { exportPath_ = path; }
     
+    // Format and streams of a media file (ffprobe, or the persistent ProbeCache if the file is unchanged)
+    static ProbeResult probe(const std::string& inputFile);
+    
+    // Duration of a media file in seconds (0 if it cannot be determined)
+    static double probeDuration(const std::string& inputFile);
+    
+    // Keyframe times of the first video stream, in seconds from the start of the file (sorted)
+    static std::vector<double> probeKeyframes(const std::string& inputFile);
+    
+    // Packet and keyframe times of the first video stream (reads the packet headers, no decoding)
+    static PacketIndex probePackets(const std::string& inputFile);
+    
     // Public helpers
     std::string generateExportPath(bool isJson) const;
     void writeToFile(const std::string& filePath, const std::string& content) const;
@@ -30,15 +130,15 @@ private:
     std::string inputFile_;
     std::string output_;
     std::string formattedOutput_;
+    ProbeResult result_;
     bool shouldExport_;
     std::string exportPath_;
     
     // Helper methods
-    void executeFFProbe();
-    std::string buildFFProbeCommand() const;
+    static std::string runFFProbe(const std::string& inputFile, bool verbose = false);
+    static std::vector<std::string> buildFFProbeArgs(const std::string& inputFile);
     std::string readFileContent(const std::string& filePath) const;
     void parseAndFormatOutput();
-    std::string extractJsonValue(const std::string& json, const std::string& key) const;
     std::string formatBytes(long long bytes) const;
     std::string formatDuration(double seconds) const;
 };
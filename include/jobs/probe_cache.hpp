@@ -0,0 +1,128 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "probe.hpp"
+
+namespace Jobs {
+
+/**
+ * @brief Identity of a file on disk; any change invalidates the cached probe
+ */
+struct FileStamp {
+    uint64_t size{0};
+    uint64_t mtime_ns{0};
+    uint64_t inode{0}; // 0 where the platform has none
+
+    bool operator==(const FileStamp& other) const {
+        return size == other.size && mtime_ns == other.mtime_ns && inode == other.inode;
+    }
+    bool operator!=(const FileStamp& other) const { return !(*this == other); }
+};
+
+/**
+ * @brief Persistent cache of ffprobe results
+ *
+ * Entries are keyed by canonical path and validated against the size, mtime
+ * and inode of the file, so a replaced or modified file is probed again. The
+ * whole cache is one binary file, read on first use and rewritten (temp file
+ * + rename) by flush(). Pending entries are flushed every FLUSH_INTERVAL
+ * stores (or every eighth of the cache size, whichever is larger), by the
+ * callers after each directory probe and batch, and when the program exits,
+ * so a crash loses little work. Lookups and stores are not blocked while a
+ * flush reads and writes the file.
+ *
+ * Several processes may share the file: a flush merges the entries written
+ * meanwhile by others with its own changes (its own changes win). Entries of
+ * files that changed are dropped when looked up; entries of files that are
+ * missing are kept, their volume may only be offline.
+ */
+class ProbeCache {
+public:
+    static constexpr size_t FLUSH_INTERVAL = 256; // Stores between two automatic flushes
+
+    explicit ProbeCache(std::filesystem::path file);
+    ~ProbeCache();
+
+    ProbeCache(const ProbeCache&) = delete;
+    ProbeCache& operator=(const ProbeCache&) = delete;
+
+    /**
+     * @brief Shared cache stored in the user cache directory
+     */
+    static ProbeCache& instance();
+
+    /**
+     * @brief Cached result for a file, if the file has not changed since it was stored
+     */
+    std::optional<ProbeResult> lookup(const std::string& inputFile);
+
+    /**
+     * @brief Records the probe result of a file (ignored if the file cannot be stat'ed)
+     */
+    void store(const std::string& inputFile, const ProbeResult& result);
+
+    /**
+     * @brief Merges pending changes into the cache file on disk
+     * @return false if the cache file could not be written
+     */
+    bool flush();
+
+    void clear();
+    size_t size();
+    const std::filesystem::path& getFilePath() const { return file_; }
+
+    /**
+     * @brief Canonical path and stamp of a file
+     * @return false if the file does not exist or cannot be stat'ed
+     */
+    static bool stampFile(const std::string& inputFile, std::string& key, FileStamp& stamp);
+
+private:
+    struct Entry {
+        FileStamp stamp;
+        ProbeResult result;
+    };
+
+    using EntryMap = std::unordered_map<std::string, Entry>;
+
+    // Called with mutex_ held
+    void load();
+    void markChanged(const std::string& key);
+
+    /**
+     * @param wait false = give up if another flush is running
+     */
+    bool flush(bool wait);
+
+    /**
+     * @brief Applies changes (nothing = erased) to the file on disk, or to an empty cache if `cleared`
+     */
+    bool writeMerged(const std::vector<std::pair<std::string, std::optional<Entry>>>& changes, bool cleared) const;
+
+    /**
+     * @brief Entries of a cache file
+     * @return false if the file is missing, foreign, outdated or corrupt
+     */
+    static bool readFile(const std::filesystem::path& file, EntryMap& entries);
+
+    std::filesystem::path file_;
+    EntryMap entries_;
+    std::unordered_set<std::string> changed_; // Keys stored or erased since the last flush
+    std::mutex mutex_;
+    std::mutex flush_mutex_; // Held by the flush in progress, without mutex_ during its I/O
+    size_t pending_stores_{0};
+    bool loaded_{false};
+    bool dirty_{false};
+    bool cleared_{false}; // clear() since the last flush: the file on disk is not merged
+};
+
+} // namespace Jobs
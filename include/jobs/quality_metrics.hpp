@@ -0,0 +1,56 @@
+#pragma once
+
+#include <filesystem>
+#include <map>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "encode_types.hpp"
+
+namespace FFmpegMulti {
+namespace Jobs {
+namespace Metrics {
+
+/**
+ * @brief Display name of a metric ("SSIM", "PSNR", "VMAF")
+ */
+const char* metricName(Encode::QualityMetric metric);
+
+/**
+ * @brief Checks that the ffmpeg build has the filter of the metric (libvmaf is optional)
+ */
+bool isAvailable(Encode::QualityMetric metric);
+
+/**
+ * @brief ffmpeg arguments comparing an encode with the same range of its source
+ *
+ * Both inputs are brought to the same pixel format and to timestamps starting
+ * at zero. SSIM and PSNR print per-frame stats on stdout; VMAF writes its
+ * JSON log to `log_path`.
+ * @param start Position of the range in the source (the encode starts at 0)
+ * @param duration Length of the range (0 = to the end of the encode)
+ * @param threads Threads of the VMAF filter, the caller's share of the CPU (ignored by SSIM and PSNR)
+ */
+std::vector<std::string> buildCompareArgs(Encode::QualityMetric metric, const std::filesystem::path& distorted, const std::string& reference,
+                                          double start, double duration, const std::filesystem::path& log_path, unsigned threads);
+
+/**
+ * @brief Mean score of a comparison run by buildCompareArgs()
+ * @param output Captured stdout of ffmpeg
+ * @return The score, or nothing if no frame was compared
+ */
+std::optional<double> parseScore(Encode::QualityMetric metric, const std::string& output, const std::filesystem::path& log_path);
+
+/**
+ * @brief Highest CRF whose linearly interpolated score still reaches `target`
+ *
+ * The score is assumed to fall as the CRF rises. A target above every
+ * measure gives the lowest measured CRF, one below every measure the highest.
+ * @param scores Mean score per measured CRF
+ */
+double interpolateCrf(const std::map<int, double>& scores, double target);
+
+} // namespace Metrics
+} // namespace Jobs
+} // namespace FFmpegMulti
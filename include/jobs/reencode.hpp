@@ -3,6 +3,7 @@
 #include <string>
 #include <vector>
 #include <memory>
+#include <filesystem>
 #include "encode_types.hpp"
 #include "../core/job.hpp"
 
@@ -75,6 +76,16 @@ public:
      */
     std::vector<std::string> buildCommand() const;
     
+    /**
+     * @brief Builds the per-output part of the command (everything after the input)
+     *
+     * Encoder, rate control, pixel format, color, audio and extra arguments,
+     * ending with the .partial output file. Jobs writing several outputs from
+     * one ffmpeg process (LadderJob) chain these after their own inputs and maps.
+     * @return Vector of arguments
+     */
+    std::vector<std::string> buildOutputArgs() const;
+    
     /**
      * @brief Generates the complete command as a string (for debug)
      * @return Complete FFmpeg command
@@ -87,10 +98,21 @@ public:
     
     /**
      * @brief Executes the encoding with the current configuration
+     *
+     * With chunk_seconds set, the source is split at keyframes and the segments
+     * are encoded in parallel, then joined losslessly (mkvmerge) and muxed with
+     * the source audio. With target_quality set, the CRF is searched first
+     * (see searchTargetCrf()), unless the output cache already holds the encode.
      * @return true if encoding succeeded, false otherwise
      */
     bool execute() override;
     
+    /**
+     * @brief Cores used by the encoder (explicit thread count or codec estimate)
+     */
+    unsigned threadDemand() const override;
+    std::string encoderName() const override;
+    
     /**
      * @brief Validates the configuration before execution
      * @return true if the configuration is valid
@@ -117,6 +139,20 @@ private:
     void addAudioArgs(std::vector<std::string>& args) const;
     void addOutputArgs(std::vector<std::string>& args) const;
     
+    // ========================================================================
+    // PRIVATE EXECUTION METHODS
+    // ========================================================================
+    
+    bool encodeSingle();
+    bool executeChunked();
+    std::filesystem::path getChunkDir() const;
+    bool checkOutput() const; // Refuses an existing output unless overwrite is set
+    bool commitOutput() const; // Renames the finished .partial file to the output name
+    std::string getCacheKey() const; // Output cache key (empty = not cacheable)
+    bool fetchFromCache(const std::string& key) const;
+    bool searchTargetCrf(); // Sets quality to the CRF reaching target_quality
+    std::filesystem::path getProbeDir() const;
+    
     // ========================================================================
     // CONVERSION HELPERS
     // ========================================================================
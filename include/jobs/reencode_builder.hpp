@@ -30,6 +30,9 @@ public:
     ReencodeJobBuilder& bitrate(int kbps);
     ReencodeJobBuilder& cbr(int kbps);
     ReencodeJobBuilder& vbr(int kbps);
+    ReencodeJobBuilder& targetQuality(Encode::QualityMetric metric, double score); // CRF searched on sample encodes
+    ReencodeJobBuilder& targetSamples(int count, double seconds); // Samples measured by the search
+    ReencodeJobBuilder& targetCrfRange(int min_crf, int max_crf); // CRFs searched (0 = codec default)
     
     // === Encoding Parameters ===
     ReencodeJobBuilder& preset(const std::string& p);
@@ -98,8 +101,20 @@ public:
     ReencodeJobBuilder& proresPreset(int profile = 4);
     ReencodeJobBuilder& ffv1Preset();
 
+    // === Input Range ===
+    ReencodeJobBuilder& range(double start_seconds, double duration_seconds = 0.0);
+    
+    // === Chunked Encoding ===
+    ReencodeJobBuilder& chunked(double segment_seconds, int workers = 0); // Parallel encode of keyframe-aligned segments
+    ReencodeJobBuilder& chunkRetries(int retries); // Extra attempts per failed segment
+    
     // === Advanced Options ===
     ReencodeJobBuilder& container(const std::string& ext);
+    ReencodeJobBuilder& overwrite(bool enabled = true);
+    ReencodeJobBuilder& outputCache(bool enabled = true); // Skip encodes already in the output cache
+    ReencodeJobBuilder& hls(double segment_seconds = 4.0); // Output path = .m3u8 playlist, fMP4 segments next to it
+    ReencodeJobBuilder& dash(double segment_seconds = 4.0); // Output path = .mpd manifest, CMAF segments next to it
+    ReencodeJobBuilder& noAudio();
     ReencodeJobBuilder& extraArgs(const std::vector<std::string>& args);
     ReencodeJobBuilder& addExtraArg(const std::string& arg);
     
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace FFmpegMulti {
+namespace Jobs {
+
+/**
+ * @brief Scene change found by SceneDetector
+ */
+struct SceneCut {
+    int64_t frame{0}; // Index of the first frame of the new scene
+    double time{0.0}; // Seconds from the start of the file
+    double score{0.0}; // 0.0 - 1.0
+};
+
+/**
+ * @brief Scene change detector working on 8-bit luma frames
+ *
+ * Frames are fed as a byte stream (e.g. ffmpeg `-f rawvideo -pix_fmt gray` on
+ * stdout) and split internally. Each frame is compared with the previous one
+ * by mean absolute difference (SSE2/AVX2 SAD when available) and by the
+ * distance of their luma histograms; a cut needs both to jump, which rejects
+ * camera motion (high SAD, similar histogram) and gradual light changes.
+ */
+class SceneDetector {
+public:
+    using CutCallback = std::function<void(const SceneCut&)>;
+
+    /**
+     * @param width Frame width in pixels
+     * @param height Frame height in pixels
+     * @param frame_rate Frames per second of the stream (to timestamp cuts)
+     * @param threshold Minimum score of a cut (0.0 - 1.0)
+     * @param min_scene_seconds Cuts closer than this to the previous one are ignored
+     */
+    SceneDetector(int width, int height, double frame_rate, double threshold, double min_scene_seconds = 0.5);
+
+    /**
+     * @brief Called for each cut as soon as it is detected
+     */
+    void setCutCallback(CutCallback callback);
+
+    /**
+     * @brief Feeds raw frame bytes, in chunks of any size
+     */
+    void feed(const char* data, size_t size);
+
+    const std::vector<SceneCut>& cuts() const { return cuts_; }
+    int64_t frameCount() const { return frame_count_; }
+
+    /**
+     * @brief Analysis frame size: source size / downscale, even, aspect kept, at least 64 wide
+     */
+    static std::pair<int, int> analysisSize(int width, int height, int downscale);
+
+    /**
+     * @brief ffmpeg arguments streaming the first video stream as gray frames on stdout
+     *
+     * The fps filter makes the rate constant, so frame index / rate is the
+     * timestamp of every frame.
+     * @param frame_rate Rate of the stream, "num/den" or decimal
+     */
+    static std::vector<std::string> buildAnalysisArgs(const std::string& input, const std::string& frame_rate, int width, int height);
+
+    /**
+     * @brief Mean absolute difference of two buffers, in 0 - 255
+     */
+    static double meanAbsoluteDifference(const uint8_t* a, const uint8_t* b, size_t size);
+
+private:
+    static const int HISTOGRAM_BINS = 64;
+
+    void processFrame();
+
+    int width_;
+    int height_;
+    double frame_rate_;
+    double threshold_;
+    int64_t min_scene_frames_;
+
+    std::vector<uint8_t> current_;
+    std::vector<uint8_t> previous_;
+    size_t filled_{0};
+
+    std::vector<uint32_t> histogram_;
+    std::vector<uint32_t> previous_histogram_;
+    double previous_sad_{0.0};
+
+    int64_t frame_count_{0};
+    int64_t last_cut_frame_{0};
+    std::vector<SceneCut> cuts_;
+    CutCallback callback_;
+};
+
+} // namespace Jobs
+} // namespace FFmpegMulti
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "encode_types.hpp"
+
+namespace FFmpegMulti {
+namespace Jobs {
+namespace Streaming {
+
+/**
+ * @brief Value of -force_key_frames putting a keyframe on every segment boundary
+ */
+std::string keyframeExpression(double segment_seconds);
+
+/**
+ * @brief Muxer arguments of a segmented output, ending with the playlist
+ *
+ * fMP4 segments for HLS (VOD playlist, every segment listed), CMAF segments
+ * for DASH. The playlist is written under its .partial name, to be committed
+ * once the encode succeeds; the segments take their final names.
+ * @param playlist Final path of the .m3u8 playlist or .mpd manifest
+ */
+std::vector<std::string> buildMuxerArgs(const Encode::StreamingOutput& streaming, const std::filesystem::path& playlist);
+
+/**
+ * @brief Deletes the segments of a playlist (leftovers of an earlier or failed encode)
+ *
+ * Only the names buildMuxerArgs() gives this playlist are matched, so the
+ * segments of another output sharing the stem prefix (movie_720.m3u8 next to
+ * movie.m3u8) are left alone.
+ */
+void removeSegments(Encode::StreamingFormat format, const std::filesystem::path& playlist);
+
+/**
+ * @brief Writes an HLS master playlist listing media playlists as variants
+ *
+ * BANDWIDTH (peak segment bitrate) and AVERAGE-BANDWIDTH are measured on the
+ * segments, RESOLUTION is probed. Variants are ordered by bandwidth, highest
+ * first, with URIs relative to the master playlist.
+ * @param error Receives the reason of a failure
+ */
+bool writeMasterPlaylist(const std::vector<std::filesystem::path>& playlists, const std::filesystem::path& master, std::string& error);
+
+} // namespace Streaming
+} // namespace Jobs
+} // namespace FFmpegMulti
@@ -1,8 +1,11 @@
 #pragma once
 
 #include <string>
+#include <vector>
 #include <filesystem>
+#include <functional>
 #include "../core/job.hpp"
+#include "auto_boost.hpp"
 
 namespace FFmpegMulti {
 namespace Jobs {
@@ -12,6 +15,12 @@ namespace Jobs {
  * 
  * Uses Auto-Boost-Essential.py for optimized AV1 encoding
  * with automatic audio handling and final muxing.
+ *
+ * The native pipeline runs the same flow without PowerShell or Python: scene
+ * detection, a fast probe encode of every scene, an SSIM measure of each probe,
+ * a CRF per scene from its quality relative to the title, then the final encode.
+ * Scenes are encoded in parallel, each by SvtAv1EncApp reading y4m from an
+ * ffmpeg decoder through a pipe, and the parts are joined into one IVF.
  */
 class SvtAv1EssentialJob : public FFmpegMulti::Core::Job {
 public:
@@ -29,6 +38,14 @@ public:
         bool unshackle{false}; // Unshackle speed limits
         bool verbose{true}; // Detailed output
         bool cleanup{true}; // Auto cleanup of temp files
+        bool extract_audio{false}; // Extract the audio to a .mka first (otherwise muxed straight from the source)
+#ifdef _WIN32
+        bool native{false}; // Native Auto-Boost driving SvtAv1EncApp (otherwise ABE.ps1 through PowerShell)
+#else
+        bool native{true};
+#endif
+        unsigned workers{0}; // Scenes encoded at once by the native pipeline (0 = cores / 4)
+        double max_scene_seconds{10.0}; // Longer scenes are split (native pipeline)
     };
     
     explicit SvtAv1EssentialJob(const std::string& input, const std::string& output);
@@ -39,11 +56,16 @@ public:
     void setUnshackle(bool enabled);
     void setVerbose(bool enabled);
     void setCleanup(bool enabled);
+    void setExtractAudio(bool enabled);
+    void setNative(bool enabled);
+    void setWorkers(unsigned workers);
     
     Config& config();
     const Config& config() const;
 
     bool execute() override;
+    unsigned threadDemand() const override;
+    std::string encoderName() const override;
     
 private:
     Config config_;
@@ -51,6 +73,7 @@ private:
     bool validatePaths();
     bool extractAudio();
     bool runAutoBoost();
+    bool runNativeBoost();
     bool muxFinal();
     bool cleanup();
     
@@ -59,7 +82,21 @@ private:
     std::filesystem::path getTempDir() const;
     std::filesystem::path getAviPath() const;
     std::filesystem::path getAudioPath() const;
-    std::string buildABECommand() const;
+    std::vector<std::string> buildABEArgs() const;
+
+    // Native pipeline
+    double getBaseCrf() const;
+    int getFinalPreset() const;
+    std::filesystem::path getNativeDir() const;
+    bool detectZones(std::vector<AutoBoost::Zone>& zones, double& frameRate);
+    bool encodeZone(const AutoBoost::Zone& zone, int preset, double crf, const std::filesystem::path& ivf, const std::filesystem::path& log);
+    bool measureZone(AutoBoost::Zone& zone, const std::filesystem::path& ivf, const std::filesystem::path& log, std::vector<double>& frameDb);
+    std::vector<std::string> buildDecodeArgs(const AutoBoost::Zone& zone) const;
+    bool forEachZone(size_t count, const std::function<bool(size_t)>& task);
+    unsigned zoneWorkers() const; // Zones encoded at once
+
+    std::string frame_rate_; // "num/den" of the source, set by detectZones()
+    double frame_rate_value_{0.0};
 };
 
 /**
@@ -74,6 +111,9 @@ public:
     SvtAv1EssentialBuilder& unshackle();
     SvtAv1EssentialBuilder& verbose(bool enabled = true);
     SvtAv1EssentialBuilder& cleanup(bool enabled = true);
+    SvtAv1EssentialBuilder& extractAudio(bool enabled = true);
+    SvtAv1EssentialBuilder& native(bool enabled = true);
+    SvtAv1EssentialBuilder& workers(unsigned count);
     
     SvtAv1EssentialJob build();
     
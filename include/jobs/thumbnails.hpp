@@ -3,6 +3,7 @@
 #include <string>
 #include <vector>
 #include "../core/job.hpp"
+#include "scene_detector.hpp"
 
 namespace FFmpegMulti {
 namespace Jobs {
@@ -26,6 +27,13 @@ struct ThumbnailsConfig {
     std::string subfolder_name;
     ThumbnailFormat format{ThumbnailFormat::PNG};
     float scene_threshold{0.15f};
+
+    // Native detection: downscaled luma frames are analysed in-process, then only
+    // the scene starts are decoded at full resolution with input seeking.
+    // Disabled = ffmpeg select='gt(scene,X)' filter on every full size frame.
+    bool native_detection{true};
+    int analysis_downscale{8}; // Analysis frame = source size / this factor
+    double min_scene_seconds{0.5}; // Shorter scenes are merged into the previous one
 };
 
 /**
@@ -47,19 +55,40 @@ public:
     // Execution
     bool execute() override;
 
+    /**
+     * @brief Scene cuts found by the last native execution (frame 0 excluded)
+     */
+    const std::vector<SceneCut>& getCuts() const;
+
+    /**
+     * @brief CSV list of the cuts (frame,time,score) written next to the thumbnails
+     */
+    std::string getCutListPath() const;
+
     // Command construction
     std::vector<std::string> buildCommand() const;
     std::string getCommandString() const;
 
 private:
     ThumbnailsConfig config_;
+    std::vector<SceneCut> cuts_;
+    double frame_rate_{0.0}; // Of the analysed stream
+
+    // Execution modes
+    bool executeNative();
+    bool executeFilter();
+    bool detectScenes();
+    bool extractSceneFrames();
+    bool writeCutList() const;
 
     // Helpers
     bool validatePaths() const;
     bool createOutputDirectory() const;
+    std::string getTargetDir() const;
     std::string getOutputPattern() const;
     std::string getFileExtension() const;
     std::string getSceneFilter() const;
+    void appendFormatArgs(std::vector<std::string>& args) const;
 };
 
 /**
@@ -75,6 +104,9 @@ public:
     ThumbnailsBuilder& subfolderName(const std::string& name);
     ThumbnailsBuilder& format(ThumbnailFormat fmt);
     ThumbnailsBuilder& sceneThreshold(float threshold);
+    ThumbnailsBuilder& nativeDetection(bool enabled);
+    ThumbnailsBuilder& analysisDownscale(int factor);
+    ThumbnailsBuilder& minSceneSeconds(double seconds);
 
     ThumbnailsBuilder& png();
     ThumbnailsBuilder& tiff();
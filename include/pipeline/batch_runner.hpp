@@ -0,0 +1,169 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "../core/job.hpp"
+#include "journal.hpp"
+#include "prometheus_exporter.hpp"
+
+namespace FFmpegMulti {
+namespace Pipeline {
+
+/**
+ * @brief Outcome of one job of a batch
+ */
+struct BatchJobResult {
+    std::string name{};
+    bool success{false};
+    bool cancelled{false}; // Stopped by BatchRunner::cancel() or never started
+    bool resumed{false}; // Not run: the journal shows it completed in a previous run
+    int attempts{0}; // Number of execute() calls (0 = never started)
+    double wall_seconds{0.0}; // Total time over all attempts
+    std::string error{}; // Message of the exception thrown by the job, if any
+    std::filesystem::path log_file{}; // Console output of the job's processes
+    Core::JobMetrics metrics{}; // Resources used by the job's processes
+};
+
+/**
+ * @brief Outcome of a whole batch
+ */
+struct BatchSummary {
+    std::vector<BatchJobResult> results{}; // In submission order
+    size_t succeeded{0};
+    size_t failed{0};
+    size_t cancelled{0};
+    size_t resumed{0}; // Counted in succeeded as well
+    unsigned concurrency{0}; // Number of jobs run side by side
+    double wall_seconds{0.0};
+
+    bool allSucceeded() const { return failed == 0 && cancelled == 0; }
+};
+
+/**
+ * @brief Settings of a batch run
+ */
+struct BatchOptions {
+    unsigned concurrency{0}; // Jobs run side by side (0 = cores / job thread demand)
+    bool plan_cpus{true}; // Give each worker its own CPUs and thread count (see Core::planAllocations())
+    Core::CpuAllocation resources{}; // CPUs and threads shared by the workers (empty = all this process may use)
+    int max_retries{0}; // Extra attempts given to a failed job
+    std::filesystem::path log_dir{}; // One log file per job (empty = processes write to the terminal)
+    std::filesystem::path metrics_file{}; // JSON report of the resources used by each job, written at the end (empty = none)
+    std::filesystem::path trace_file{}; // Chrome trace of the workers, jobs, steps and processes, written at the end (empty = none)
+    std::function<bool()> should_stop{}; // Polled while the batch runs, true cancels it
+    std::function<void(const BatchJobResult&, size_t done, size_t total)> on_job_finished{}; // Called from worker threads, one call at a time
+
+    // Crash-safe record of the jobs added with a fingerprint (nullptr = none)
+    std::shared_ptr<Journal> journal{};
+    bool resume{false}; // Skip the jobs the journal shows as done with an intact output
+    bool verify_resumed{false}; // Re-hash their output before skipping them
+
+    // Live queue, progress and resource metrics for Prometheus (nullptr = none)
+    std::shared_ptr<PrometheusExporter> prometheus{};
+};
+
+/**
+ * @brief Runs a list of jobs on a bounded pool of workers
+ *
+ * Each worker takes the next pending job and runs its blocking execute(), so
+ * at most `concurrency` jobs (and their FFmpeg processes) are active at once.
+ * Failed jobs are retried up to `max_retries` times; cancelled jobs are not.
+ *
+ * With plan_cpus, the usable CPUs (cgroup quota and cpuset included) are
+ * split between the workers, NUMA node by node: the jobs of a worker are
+ * pinned to its CPUs and told its thread count, instead of every encoder
+ * sizing itself for the whole machine.
+ *
+ * With a trace_file, the batch is recorded as a timeline (see Core::Trace):
+ * one track with the jobs of each worker and the queue depth, then one track
+ * per job with its attempts, steps and child processes.
+ */
+class BatchRunner {
+public:
+    explicit BatchRunner(BatchOptions options = {});
+    ~BatchRunner() = default;
+
+    BatchRunner(const BatchRunner&) = delete;
+    BatchRunner& operator=(const BatchRunner&) = delete;
+
+    /**
+     * @brief Queues a job
+     * @param job Job to run
+     * @param name Label used in the summary and for the log file name
+     */
+    void add(std::unique_ptr<Core::Job> job, const std::string& name);
+
+    /**
+     * @brief Queues a job tracked by the journal of the batch
+     * @param fingerprint Hash of the job settings, stable across runs (e.g. Hash::hex64() of them)
+     * @param output Main output file, checksummed in the journal when the job succeeds (empty = none)
+     * @param max_retries Extra attempts given to this job if it fails (-1 = BatchOptions::max_retries)
+     */
+    void add(std::unique_ptr<Core::Job> job, const std::string& name, const std::string& fingerprint, const std::filesystem::path& output,
+             int max_retries = -1);
+
+    size_t size() const;
+
+    /**
+     * @brief Settings of the next run() (modifiable until it starts)
+     */
+    BatchOptions& options();
+
+    /**
+     * @brief Default pool size: usable cores divided by the largest job thread demand
+     * @return Number of workers (at least 1, at most the number of jobs)
+     */
+    unsigned recommendedConcurrency() const;
+
+    /**
+     * @brief Runs all queued jobs and blocks until they are finished
+     * @return Per-job results and totals
+     */
+    BatchSummary run();
+
+    /**
+     * @brief Stops the batch: pending jobs are skipped, running jobs are cancelled
+     * @note Can be called from any thread
+     */
+    void cancel();
+
+private:
+    struct Entry {
+        std::unique_ptr<Core::Job> job;
+        std::string name;
+        std::string fingerprint; // Empty = not journaled
+        std::filesystem::path output;
+        int max_retries{-1}; // -1 = options_.max_retries
+        bool running{false};
+        int trace_track{-1};
+    };
+
+    void worker(size_t total, const Core::CpuAllocation& allocation);
+    BatchJobResult runEntry(size_t index);
+    bool writeMetrics(const BatchSummary& summary) const;
+    void traceQueue(); // With mutex_ held
+    std::filesystem::path getLogPath(size_t index) const;
+
+    BatchOptions options_;
+    std::vector<Entry> entries_;
+    std::vector<BatchJobResult> results_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable finished_cv_;
+    std::mutex callback_mutex_;
+    std::shared_ptr<Core::Trace> trace_{}; // Timeline of the current run (nullptr = not traced)
+    int trace_track_{0}; // Track of the workers
+    size_t next_{0};
+    size_t done_{0};
+    std::atomic<bool> stopping_{false};
+};
+
+} // namespace Pipeline
+} // namespace FFmpegMulti
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "../jobs/probe.hpp"
+
+namespace FFmpegMulti {
+namespace Pipeline {
+
+/**
+ * @brief Layout of the report written by DirectoryProbe
+ */
+enum class ProbeReportFormat {
+    JSON_LINES, // One JSON object per file
+    CSV         // Header row, then one row per file
+};
+
+/**
+ * @brief Settings of a directory probe
+ */
+struct DirectoryProbeOptions {
+    unsigned concurrency{0}; // ffprobe processes run side by side (0 = number of cores)
+    bool recursive{true};
+    ProbeReportFormat format{ProbeReportFormat::JSON_LINES};
+    std::filesystem::path report_path{}; // Empty = no report, statistics only
+    std::function<bool()> should_stop{}; // Polled between files, true stops the scan
+    std::function<void(const std::filesystem::path&, bool ok, size_t done)> on_file_done{}; // Called from worker threads, one call at a time
+};
+
+/**
+ * @brief Aggregate statistics over all probed files
+ */
+struct DirectoryProbeStats {
+    size_t files{0}; // Successfully probed
+    size_t failed{0};
+    double total_duration{0.0}; // Seconds
+    unsigned long long total_bytes{0};
+    double wall_seconds{0.0};
+
+    std::map<std::string, size_t> video_codecs{}; // First video stream of each file
+    std::map<std::string, size_t> audio_codecs{}; // First audio stream of each file
+    std::map<std::string, size_t> resolutions{}; // "2160p", "1080p"...
+    std::map<std::string, size_t> dynamic_ranges{}; // "SDR", "HDR10", "HLG"
+};
+
+/**
+ * @brief Probes every media file of a directory tree on a pool of workers
+ *
+ * Workers pull the next file straight from the directory walk, so probing
+ * starts immediately and nothing but the statistics is kept in memory: each
+ * result is appended to the report as soon as it is known, in completion order.
+ * Results come from ::Jobs::ProbeJob::probe(), so unchanged files are served by
+ * the probe cache. An unreadable subdirectory is skipped and reported as a
+ * failed entry, the walk goes on with the rest of the tree.
+ */
+class DirectoryProbe {
+public:
+    DirectoryProbe(std::filesystem::path root, DirectoryProbeOptions options = {});
+
+    DirectoryProbe(const DirectoryProbe&) = delete;
+    DirectoryProbe& operator=(const DirectoryProbe&) = delete;
+
+    /**
+     * @brief Scans the tree and blocks until every file is probed
+     * @throw std::runtime_error if the root is not a directory or the report cannot be created
+     */
+    DirectoryProbeStats run();
+
+    /**
+     * @brief True for the extensions of common video and audio containers
+     */
+    static bool isMediaFile(const std::filesystem::path& path);
+
+    /**
+     * @brief Resolution class of a video stream ("4320p", "2160p", "1440p", "1080p", "720p", "SD")
+     */
+    static std::string resolutionClass(int width, int height);
+
+private:
+    bool nextFile(std::filesystem::path& file); // Called with walk_mutex_ held
+    void worker();
+    void record(const std::filesystem::path& file, const ::Jobs::ProbeResult* result, const std::string& error);
+    std::string formatJsonLine(const std::filesystem::path& file, const ::Jobs::ProbeResult* result, const std::string& error) const;
+    std::string formatCsvRow(const std::filesystem::path& file, const ::Jobs::ProbeResult* result, const std::string& error) const;
+
+    std::filesystem::path root_;
+    DirectoryProbeOptions options_;
+
+    std::mutex walk_mutex_;
+    std::filesystem::recursive_directory_iterator walk_;
+    bool stopped_{false};
+
+    std::mutex report_mutex_; // Guards report_, stats_ and the callback
+    std::ofstream report_;
+    DirectoryProbeStats stats_;
+};
+
+} // namespace Pipeline
+} // namespace FFmpegMulti
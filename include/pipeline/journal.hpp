@@ -0,0 +1,92 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+
+namespace FFmpegMulti {
+namespace Pipeline {
+
+/**
+ * @brief State of a job as recorded in a Journal
+ */
+enum class JournalState {
+    STARTED,
+    DONE,
+    FAILED,
+    CANCELLED
+};
+
+/**
+ * @brief Last known state of one job
+ */
+struct JournalEntry {
+    std::string fingerprint{}; // Hash of the job settings
+    JournalState state{JournalState::STARTED};
+    std::string name{};
+    std::string output{}; // Main output file (empty for jobs writing a folder)
+    uint64_t output_size{0};
+    std::string checksum{}; // Of the output, hex (empty if none)
+};
+
+/**
+ * @brief Append-only record of the state transitions of a batch, for resuming
+ *
+ * Each transition is one JSON line, written with a single write() and synced
+ * to disk before record() returns, so after a crash or power loss the file
+ * holds every transition that was reported, plus at most one torn last line
+ * (ignored on replay). The file is never rewritten: it also serves as the
+ * history of every run of the batch. Jobs are identified by a fingerprint of
+ * their settings, so editing a job of a manifest makes it run again.
+ */
+class Journal {
+public:
+    /**
+     * @brief Opens (or creates) the journal and replays its existing lines
+     * @throw std::runtime_error if the file cannot be opened for appending
+     */
+    explicit Journal(std::filesystem::path file);
+    ~Journal();
+
+    Journal(const Journal&) = delete;
+    Journal& operator=(const Journal&) = delete;
+
+    /**
+     * @brief Appends a transition and syncs it to disk
+     * @param output Output file; hashed when the state is DONE and the file exists
+     * @return false if the line could not be written
+     */
+    bool record(const std::string& fingerprint, JournalState state, const std::string& name, const std::filesystem::path& output = {});
+
+    /**
+     * @brief True if the last state of the job is DONE and its output is still intact
+     *
+     * The output must exist with its recorded size; with `verify` its checksum is
+     * recomputed as well (reads the whole file).
+     */
+    bool isComplete(const std::string& fingerprint, bool verify = false) const;
+
+    /**
+     * @brief Last recorded entry of a job
+     */
+    std::optional<JournalEntry> find(const std::string& fingerprint) const;
+
+    const std::filesystem::path& getFilePath() const { return file_; }
+
+    static const char* stateName(JournalState state);
+
+private:
+    bool replay(); // Returns true if the file ends with a line missing its newline (torn by a crash)
+    bool appendLine(const std::string& line);
+
+    std::filesystem::path file_;
+    int fd_{-1};
+    mutable std::mutex mutex_;
+    std::unordered_map<std::string, JournalEntry> entries_; // Last entry per fingerprint
+};
+
+} // namespace Pipeline
+} // namespace FFmpegMulti
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace FFmpegMulti {
+namespace Pipeline {
+
+/**
+ * @brief Content-addressed store of finished encodes, bounded in size (LRU)
+ *
+ * An entry is keyed by the identity of the input file (path, size, mtime,
+ * inode), the full argument vector of the encode and the encoder version,
+ * so any change to one of them is a miss. Entries are folders renamed into
+ * place once complete, which makes the store safe to share between processes.
+ * Hits and stores use a reflink, then a hard link, then a copy: a hard-linked
+ * output shares its content with the cache and must not be modified in place.
+ */
+class OutputCache {
+public:
+    static constexpr uint64_t DEFAULT_MAX_BYTES = 50ull * 1024 * 1024 * 1024;
+
+    explicit OutputCache(std::filesystem::path dir, uint64_t max_bytes = DEFAULT_MAX_BYTES);
+
+    /**
+     * @brief Shared cache in <user cache dir>/outputs
+     */
+    static OutputCache& instance();
+
+    void setMaxBytes(uint64_t max_bytes);
+    uint64_t getMaxBytes() const;
+    const std::filesystem::path& getDir() const { return dir_; }
+
+    /**
+     * @brief Key of an encode
+     * @param args Tool arguments, without the output path (its extension may stay)
+     * @return Hex key, empty if the input cannot be identified or the version is unknown
+     */
+    static std::string makeKey(const std::string& inputFile, const std::vector<std::string>& args, const std::string& toolVersion);
+
+    /**
+     * @brief First line of `<tool> -version`, run once per tool and process (empty on failure)
+     */
+    static std::string toolVersion(const std::filesystem::path& tool);
+
+    /**
+     * @brief Materializes a cached output at `target` and marks it recently used
+     * @return false on a miss
+     */
+    bool fetch(const std::string& key, const std::filesystem::path& target);
+
+    /**
+     * @brief Adds a finished output, then evicts the least recently used entries over the limit
+     */
+    bool store(const std::string& key, const std::filesystem::path& output);
+
+    /**
+     * @brief Total size of the entries, in bytes
+     */
+    uint64_t totalBytes() const;
+
+private:
+    void evict(const std::string& keep);
+    std::filesystem::path entryDir(const std::string& key) const;
+
+    std::filesystem::path dir_;
+    uint64_t max_bytes_;
+    mutable std::mutex mutex_; // Serializes eviction within the process
+};
+
+} // namespace Pipeline
+} // namespace FFmpegMulti
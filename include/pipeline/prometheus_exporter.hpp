@@ -0,0 +1,108 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+
+#include "../core/job_metrics.hpp"
+#include "../core/progress.hpp"
+
+namespace FFmpegMulti {
+namespace Pipeline {
+
+struct BatchJobResult;
+
+/**
+ * @brief Live state of one or more batches, exposed to Prometheus
+ *
+ * Writes a file in the text exposition format for the textfile collector of
+ * node_exporter (point --collector.textfile.directory at its folder). The file
+ * is rewritten every `interval` while a batch runs, through a temporary file
+ * and a rename, so the collector never reads a partial one.
+ *
+ * Exposed: queued and running jobs, current fps and realtime factor of each
+ * running job and per encoder, finished jobs by outcome, retries, and the CPU
+ * time and bytes read and written by finished jobs. Counters survive from one
+ * batch to the next as long as the exporter lives.
+ *
+ * BatchRunner calls the lifecycle methods (see BatchOptions::prometheus);
+ * they can be called from any thread, for one batch at a time.
+ */
+class PrometheusExporter {
+public:
+    /**
+     * @param file Output file, should end in .prom
+     * @param interval Time between two rewrites while a batch runs
+     */
+    explicit PrometheusExporter(std::filesystem::path file, std::chrono::milliseconds interval = std::chrono::seconds(5));
+    ~PrometheusExporter();
+
+    PrometheusExporter(const PrometheusExporter&) = delete;
+    PrometheusExporter& operator=(const PrometheusExporter&) = delete;
+
+    // Lifecycle
+    void batchStarted(size_t jobs);
+    void jobStarted(size_t index, const std::string& name, const std::string& encoder);
+    void jobProgress(size_t index, const Core::Progress& progress);
+    void jobFinished(size_t index, const BatchJobResult& result);
+    void batchFinished(size_t skipped); // Jobs of the batch that never started
+
+    /**
+     * @brief Current metrics in the text exposition format
+     */
+    std::string render() const;
+
+    /**
+     * @brief Writes render() to the file now
+     * @return false if the file could not be written
+     */
+    bool write() const;
+
+    const std::filesystem::path& getFilePath() const;
+
+private:
+    struct RunningJob {
+        std::string name;
+        std::string encoder;
+        Core::Progress progress{};
+    };
+
+    struct FinishedJob {
+        std::string name;
+        std::string encoder;
+        std::string outcome;
+        double wall_seconds{0.0};
+        Core::JobMetrics metrics{};
+    };
+
+    struct EncoderTotals {
+        std::map<std::string, uint64_t> outcomes; // succeeded, failed, cancelled, resumed
+        uint64_t retries{0};
+        double cpu_seconds{0.0};
+        uint64_t read_bytes{0};
+        uint64_t write_bytes{0};
+    };
+
+    void writeLoop();
+
+    std::filesystem::path file_;
+    std::chrono::milliseconds interval_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable wake_;
+    std::thread writer_; // Rewrites the file while a batch runs
+    bool active_{false}; // A batch is running
+    size_t queued_{0};
+    std::map<size_t, RunningJob> running_; // By index in the batch
+    std::map<size_t, FinishedJob> finished_; // Last batch, by index
+    std::map<std::string, EncoderTotals> encoders_;
+};
+
+} // namespace Pipeline
+} // namespace FFmpegMulti
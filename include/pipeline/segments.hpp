@@ -0,0 +1,45 @@
+#pragma once
+
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "../core/progress.hpp"
+
+namespace FFmpegMulti {
+namespace Pipeline {
+
+/**
+ * @brief Segment boundaries are moved this much before the keyframe so that
+ * rounding of the probed timestamps never drops the keyframe from its segment
+ */
+inline constexpr double SEGMENT_BOUNDARY_MARGIN = 0.001;
+
+/**
+ * @brief Seconds formatted for -ss/-t/-to (fixed, microsecond precision)
+ */
+std::string formatSeconds(double seconds);
+
+/**
+ * @brief Start times of keyframe-aligned segments
+ * @param keyframes Sorted keyframe times of the source
+ * @param start Start of the range to split
+ * @param end End of the range (infinity = end of file)
+ * @param target Minimum segment length in seconds; a tail shorter than half of it is merged
+ * @return Segment starts, the first one being `start`
+ */
+std::vector<double> planSegmentStarts(const std::vector<double>& keyframes, double start, double end, double target);
+
+/**
+ * @brief Merges the progress of segments processed in parallel into one event
+ */
+struct SegmentProgress {
+    std::mutex mutex;
+    std::vector<Core::Progress> segments;
+    double duration_seconds{0.0}; // Of the whole range
+
+    Core::Progress merged() const;
+};
+
+} // namespace Pipeline
+} // namespace FFmpegMulti
@@ -0,0 +1,418 @@
+#include "../../include/bench/benchmark.hpp"
+#include "../../include/cli/cli.hpp"
+#include "../../include/core/cpu_topology.hpp"
+#include "../../include/core/ffmpeg_process.hpp"
+#include "../../include/core/json.hpp"
+#include "../../include/core/path_utils.hpp"
+#include "../../include/jobs/codec_utils.hpp"
+#include "../../include/jobs/quality_metrics.hpp"
+#include "../../include/pipeline/segments.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+
+namespace fs = std::filesystem;
+
+namespace FFmpegMulti {
+namespace Bench {
+
+namespace {
+
+const char* USAGE =
+    "Usage: ffmpeg_multi_bench [options]\n"
+    "\n"
+    "Encodes deterministic lavfi test clips with the complete presets of the\n"
+    "re-encoder over a thread sweep and reports fps, fps per core, size and SSIM.\n"
+    "\n"
+    "  --presets LIST      Comma-separated, among youtube,x264,x265,h264_nvenc,h265_nvenc,prores,ffv1\n"
+    "                      (default x264,x265,prores,ffv1)\n"
+    "  --sources LIST      lavfi generators (default testsrc2,mandelbrot)\n"
+    "  --resolutions LIST  WIDTHxHEIGHT list (default 640x360,1280x720,1920x1080)\n"
+    "  --threads LIST      Thread counts (default 1, 2, 4... up to the usable cores)\n"
+    "  --seconds S         Length of the clips (default 5)\n"
+    "  --fps N             Frame rate of the clips (default 30)\n"
+    "  --runs N            Encodes per configuration, the fastest is kept (default 1)\n"
+    "  --work-dir D        Clips and encodes (default <temp>/ffmpeg_multi_bench)\n"
+    "  --report F          JSON report (default ffmpeg_multi_bench.json)\n"
+    "  --no-ssim           Skip the quality measure\n"
+    "  --no-pin            Let the scheduler place the threads\n";
+
+std::atomic<bool> interrupted{false};
+
+void onInterrupt(int) {
+    interrupted = true;
+}
+
+std::vector<std::string> splitList(const std::string& list) {
+    std::vector<std::string> items;
+    std::istringstream in(list);
+    std::string item;
+    while (std::getline(in, item, ',')) {
+        if (!item.empty()) {
+            items.push_back(item);
+        }
+    }
+    return items;
+}
+
+std::string ffmpegVersion() {
+    ffmpegProcess ffmpeg(PathUtils::getToolPath("ffmpeg"), { "-hide_banner", "-version" });
+    ffmpeg.setEcho(false);
+    ffmpeg.setCaptureOutput(true);
+    ProcessResult result = ffmpeg.run();
+    if (!result.success()) {
+        throw std::runtime_error("ffmpeg cannot be run (" + result.describe() + ")");
+    }
+    return result.output.substr(0, result.output.find_first_of("\r\n"));
+}
+
+} // namespace
+
+// ============================================================================
+// PRESETS
+// ============================================================================
+
+std::vector<std::string> presetNames() {
+    return { "youtube", "x264", "x265", "h264_nvenc", "h265_nvenc", "prores", "ffv1" };
+}
+
+bool applyPreset(Jobs::ReencodeJobBuilder& builder, const std::string& name) {
+    if (name == "youtube") builder.youtubePreset();
+    else if (name == "x264") builder.x264Preset();
+    else if (name == "x265") builder.x265Preset();
+    else if (name == "h264_nvenc") builder.h264NvencPreset();
+    else if (name == "h265_nvenc") builder.h265NvencPreset();
+    else if (name == "prores") builder.proresPreset();
+    else if (name == "ffv1") builder.ffv1Preset();
+    else return false;
+    return true;
+}
+
+// ============================================================================
+// REPORT
+// ============================================================================
+
+std::string BenchReport::toJson() const {
+    std::ostringstream json;
+    json.precision(10);
+    json << "{\"schema\":1"
+         << ",\"ffmpeg\":" << Json::quote(ffmpeg_version)
+         << ",\"cores\":" << cores
+         << ",\"seconds\":" << seconds
+         << ",\"framerate\":" << framerate
+         << ",\"results\":[";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const BenchResult& r = results[i];
+        json << (i > 0 ? "," : "") << "\n{\"source\":" << Json::quote(r.generator)
+             << ",\"width\":" << r.width
+             << ",\"height\":" << r.height
+             << ",\"preset\":" << Json::quote(r.preset)
+             << ",\"encoder\":" << Json::quote(r.encoder)
+             << ",\"threads\":" << r.threads
+             << ",\"success\":" << (r.success ? "true" : "false");
+        if (!r.success) {
+            json << ",\"error\":" << Json::quote(r.error) << "}";
+            continue;
+        }
+        json << ",\"frames\":" << r.frames
+             << ",\"wall_seconds\":" << r.wall_seconds
+             << ",\"fps\":" << r.fps
+             << ",\"cpu_seconds\":" << r.cpu_seconds
+             << ",\"average_cores\":" << r.average_cores
+             << ",\"fps_per_core\":" << r.fps_per_core
+             << ",\"peak_rss_kb\":" << r.peak_rss_kb
+             << ",\"size_bytes\":" << r.size_bytes
+             << ",\"bitrate_kbps\":" << r.bitrate_kbps;
+        if (r.ssim >= 0.0) {
+            json << ",\"ssim\":" << r.ssim;
+        }
+        json << "}";
+    }
+    json << "]}\n";
+    return json.str();
+}
+
+// ============================================================================
+// BENCHMARK
+// ============================================================================
+
+Benchmark::Benchmark(BenchOptions options) : options_(std::move(options)) {
+    if (options_.work_dir.empty()) {
+        options_.work_dir = fs::temp_directory_path() / "ffmpeg_multi_bench";
+    }
+}
+
+std::vector<unsigned> Benchmark::threadSweep() const {
+    if (!options_.threads.empty()) {
+        return options_.threads;
+    }
+    unsigned cores = Core::availableCores();
+    std::vector<unsigned> sweep;
+    for (unsigned threads = 1; threads < cores; threads *= 2) {
+        sweep.push_back(threads);
+    }
+    sweep.push_back(cores);
+    return sweep;
+}
+
+fs::path Benchmark::generateClip(const std::string& generator, int width, int height) const {
+    std::ostringstream name;
+    name << generator << "_" << width << "x" << height << "_" << options_.framerate << "fps_" << options_.seconds << "s.mkv";
+    fs::path clip = options_.work_dir / "sources" / name.str();
+    if (fs::exists(clip)) {
+        return clip; // Generators are deterministic: a clip made earlier is the same
+    }
+    fs::create_directories(clip.parent_path());
+
+    std::ostringstream source;
+    source << generator << "=size=" << width << "x" << height << ":rate=" << options_.framerate;
+    fs::path partial = PathUtils::getPartialPath(clip);
+    ffmpegProcess ffmpeg(PathUtils::getToolPath("ffmpeg"), {
+        "-hide_banner", "-loglevel", "error", "-y",
+        "-f", "lavfi", "-i", source.str(), "-t", Pipeline::formatSeconds(options_.seconds),
+        "-pix_fmt", "yuv420p", "-c:v", "ffv1", "-level", "3", "-slices", "16", "-g", "1",
+        partial.string()
+    });
+    ffmpeg.setEcho(false);
+    ProcessResult result = ffmpeg.run();
+    if (!result.success() || !PathUtils::commitPartial(partial, clip)) {
+        std::error_code ec;
+        fs::remove(partial, ec);
+        throw std::runtime_error("Cannot generate the " + source.str() + " test clip (" + result.describe() + ")");
+    }
+    return clip;
+}
+
+double Benchmark::measureSsim(const fs::path& encode, const fs::path& clip) const {
+    fs::path log = fs::path(encode).replace_extension(".ssim.log");
+    ffmpegProcess compare(PathUtils::getToolPath("ffmpeg"),
+                          Jobs::Metrics::buildCompareArgs(Encode::QualityMetric::SSIM, encode, clip.string(), 0.0, 0.0, log,
+                                                           Core::availableCores()));
+    compare.setEcho(false);
+    compare.setCaptureOutput(true);
+    ProcessResult result = compare.run();
+    std::optional<double> score = result.success() ? Jobs::Metrics::parseScore(Encode::QualityMetric::SSIM, result.output, log) : std::nullopt;
+    return score ? *score : -1.0;
+}
+
+BenchResult Benchmark::measure(const fs::path& clip, const std::string& preset, unsigned threads) const {
+    BenchResult best;
+    best.preset = preset;
+    best.threads = threads;
+    best.frames = static_cast<int64_t>(options_.seconds * options_.framerate + 0.5);
+
+    Jobs::ReencodeJobBuilder builder;
+    builder.input(clip.string()).output("unused");
+    applyPreset(builder, preset);
+    builder.threads(static_cast<int>(threads)).noAudio().overwrite();
+    Jobs::ReencodeJob job = builder.build();
+    best.encoder = job.encoderName();
+
+    fs::path encode = options_.work_dir / "encodes" /
+                      (clip.stem().string() + "_" + preset + "_t" + std::to_string(threads) + Codec::CodecUtils::getContainerExtension(job.config().container));
+    fs::create_directories(encode.parent_path());
+    job.setOutputPath(encode.string());
+    job.setLogFile(options_.work_dir / "logs" / (encode.stem().string() + ".log"));
+    fs::create_directories(options_.work_dir / "logs");
+
+    // The first CPUs of the machine, node after node: N threads on N CPUs
+    if (options_.pin_cpus) {
+        Core::CpuAllocation allocation;
+        allocation.threads = threads;
+        for (const auto& node : Core::CpuTopology::system().nodes) {
+            for (unsigned cpu : node.cpus) {
+                if (allocation.cpus.size() < threads) {
+                    allocation.cpus.push_back(cpu);
+                }
+            }
+        }
+        job.setCpuAllocation(allocation);
+    }
+
+    for (int run = 0; run < std::max(1, options_.runs); ++run) {
+        Jobs::ReencodeJob attempt(job); // Fresh metrics for each run
+        auto start = std::chrono::steady_clock::now();
+        bool success = attempt.execute();
+        double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        if (!success) {
+            best.success = false;
+            best.error = "encode failed, see " + attempt.getLogFile().string();
+            return best;
+        }
+        if (best.success && wall >= best.wall_seconds) {
+            continue;
+        }
+
+        Core::JobMetrics metrics = attempt.getMetrics();
+        best.success = true;
+        best.wall_seconds = wall;
+        best.cpu_seconds = metrics.cpuSeconds();
+        best.peak_rss_kb = metrics.peak_rss_kb;
+    }
+
+    best.fps = best.wall_seconds > 0.0 ? static_cast<double>(best.frames) / best.wall_seconds : 0.0;
+    best.average_cores = best.wall_seconds > 0.0 ? best.cpu_seconds / best.wall_seconds : 0.0;
+    best.fps_per_core = best.cpu_seconds > 0.0 ? static_cast<double>(best.frames) / best.cpu_seconds : 0.0;
+    std::error_code ec;
+    best.size_bytes = static_cast<uint64_t>(fs::file_size(encode, ec));
+    best.bitrate_kbps = options_.seconds > 0.0 ? static_cast<double>(best.size_bytes) * 8.0 / options_.seconds / 1000.0 : 0.0;
+    if (options_.measure_ssim) {
+        best.ssim = measureSsim(encode, clip);
+    }
+    return best;
+}
+
+BenchReport Benchmark::run(const std::function<void(const BenchResult&)>& on_result) {
+    for (const auto& preset : options_.presets) {
+        Jobs::ReencodeJobBuilder builder;
+        if (!applyPreset(builder, preset)) {
+            throw std::runtime_error("Unknown preset \"" + preset + "\"");
+        }
+    }
+
+    BenchReport report;
+    report.ffmpeg_version = ffmpegVersion();
+    report.cores = Core::availableCores();
+    report.seconds = options_.seconds;
+    report.framerate = options_.framerate;
+
+    std::vector<unsigned> sweep = threadSweep();
+    for (const auto& generator : options_.generators) {
+        for (const auto& resolution : options_.resolutions) {
+            fs::path clip = generateClip(generator, resolution.first, resolution.second);
+            for (const auto& preset : options_.presets) {
+                for (unsigned threads : sweep) {
+                    if (options_.should_stop && options_.should_stop()) {
+                        return report;
+                    }
+                    BenchResult result = measure(clip, preset, threads);
+                    result.generator = generator;
+                    result.width = resolution.first;
+                    result.height = resolution.second;
+                    report.results.push_back(result);
+                    if (on_result) {
+                        on_result(result);
+                    }
+                }
+            }
+        }
+    }
+    return report;
+}
+
+// ============================================================================
+// COMMAND LINE
+// ============================================================================
+
+int run(const std::vector<std::string>& args) {
+    using Cli::UsageError;
+
+    try {
+        Cli::Options o = Cli::Options::parse(args, { "help", "no-ssim", "no-pin" });
+        if (o.flag("help")) {
+            std::cout << USAGE;
+            return Cli::EXIT_OK;
+        }
+        if (!o.positionals().empty()) {
+            throw UsageError("Unexpected argument \"" + o.positionals().front() + "\"");
+        }
+
+        BenchOptions options;
+        if (o.has("presets")) options.presets = splitList(o.get("presets"));
+        if (o.has("sources")) options.generators = splitList(o.get("sources"));
+        if (o.has("resolutions")) {
+            options.resolutions.clear();
+            for (const auto& item : splitList(o.get("resolutions"))) {
+                size_t x = item.find('x');
+                int width = x == std::string::npos ? 0 : std::atoi(item.substr(0, x).c_str());
+                int height = x == std::string::npos ? 0 : std::atoi(item.substr(x + 1).c_str());
+                if (width <= 0 || height <= 0) {
+                    throw UsageError("--resolutions expects WIDTHxHEIGHT values, not \"" + item + "\"");
+                }
+                options.resolutions.emplace_back(width, height);
+            }
+        }
+        if (o.has("threads")) {
+            for (const auto& item : splitList(o.get("threads"))) {
+                int threads = std::atoi(item.c_str());
+                if (threads <= 0 || threads > 1024) {
+                    throw UsageError("--threads expects counts between 1 and 1024, not \"" + item + "\"");
+                }
+                options.threads.push_back(static_cast<unsigned>(threads));
+            }
+        }
+        options.seconds = o.getDouble("seconds", options.seconds, 0.1, 3600.0);
+        options.framerate = o.getInt("fps", options.framerate, 1, 240);
+        options.runs = o.getInt("runs", options.runs, 1, 100);
+        options.measure_ssim = !o.flag("no-ssim");
+        options.pin_cpus = !o.flag("no-pin");
+        options.work_dir = o.get("work-dir");
+        options.should_stop = [] { return interrupted.load(); };
+        fs::path reportPath = o.get("report", "ffmpeg_multi_bench.json");
+        o.checkAllUsed();
+        if (options.presets.empty() || options.generators.empty() || options.resolutions.empty()) {
+            throw UsageError("Nothing to measure");
+        }
+
+        std::signal(SIGINT, onInterrupt);
+
+        std::cout << std::left << std::setw(12) << "source" << std::setw(11) << "size" << std::setw(12) << "preset" << std::right
+                  << std::setw(8) << "threads" << std::setw(10) << "fps" << std::setw(10) << "fps/core" << std::setw(12) << "kbps"
+                  << std::setw(9) << "ssim" << std::endl;
+        Benchmark benchmark(options);
+        BenchReport report = benchmark.run([](const BenchResult& r) {
+            std::ostringstream size;
+            size << r.width << "x" << r.height;
+            std::cout << std::left << std::setw(12) << r.generator << std::setw(11) << size.str() << std::setw(12) << r.preset << std::right
+                      << std::setw(8) << r.threads;
+            if (!r.success) {
+                std::cout << "  " << r.error << std::endl;
+                return;
+            }
+            std::cout << std::fixed << std::setprecision(1) << std::setw(10) << r.fps << std::setw(10) << r.fps_per_core
+                      << std::setw(12) << std::setprecision(0) << r.bitrate_kbps << std::setw(9) << std::setprecision(4);
+            if (r.ssim >= 0.0) {
+                std::cout << r.ssim;
+            } else {
+                std::cout << "-";
+            }
+            std::cout << std::endl;
+        });
+
+        fs::path partial = PathUtils::getPartialPath(reportPath);
+        {
+            std::ofstream file(partial, std::ios::binary | std::ios::trunc);
+            if (!file.is_open() || !(file << report.toJson())) {
+                throw std::runtime_error("Cannot write " + partial.string());
+            }
+        }
+        if (!PathUtils::commitPartial(partial, reportPath)) {
+            throw std::runtime_error("Cannot write " + reportPath.string());
+        }
+        std::cout << "Report: " << reportPath.string() << std::endl;
+
+        if (interrupted) {
+            return Cli::EXIT_INTERRUPTED;
+        }
+        bool failed = std::any_of(report.results.begin(), report.results.end(), [](const BenchResult& r) { return !r.success; });
+        return failed ? Cli::EXIT_FAILED : Cli::EXIT_OK;
+    } catch (const UsageError& e) {
+        std::cerr << "[ERROR] " << e.what() << std::endl;
+        std::cerr << "Run 'ffmpeg_multi_bench --help' for the options." << std::endl;
+        return Cli::EXIT_USAGE;
+    } catch (const std::exception& e) {
+        std::cerr << "[ERROR] " << e.what() << std::endl;
+        return Cli::EXIT_FAILED;
+    }
+}
+
+} // namespace Bench
+} // namespace FFmpegMulti
@@ -0,0 +1,7 @@
+#include <string>
+#include <vector>
+#include "bench/benchmark.hpp"
+
+int main(int argc, char** argv) {
+    return FFmpegMulti::Bench::run(std::vector<std::string>(argv + 1, argv + argc));
+}
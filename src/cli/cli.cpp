@@ -0,0 +1,709 @@
+#include "../../include/cli/cli.hpp"
+#include "../../include/core/colors.hpp"
+#include "../../include/core/hash.hpp"
+#include "../../include/core/json.hpp"
+#include "../../include/jobs/concat.hpp"
+#include "../../include/jobs/extract_frames.hpp"
+#include "../../include/jobs/ladder.hpp"
+#include "../../include/jobs/probe_cache.hpp"
+#include "../../include/jobs/reencode_builder.hpp"
+#include "../../include/jobs/svt_av1_essential.hpp"
+#include "../../include/jobs/thumbnails.hpp"
+#include "../../include/pipeline/batch_runner.hpp"
+#include "../../include/pipeline/directory_probe.hpp"
+#include "../../include/pipeline/output_cache.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <sstream>
+
+#ifdef _WIN32
+#include <io.h>
+#define isatty _isatty
+#define STDOUT_FILENO 1
+#else
+#include <unistd.h>
+#endif
+
+namespace fs = std::filesystem;
+
+namespace FFmpegMulti {
+namespace Cli {
+
+namespace {
+
+std::atomic<bool> interrupted{false};
+
+void onInterrupt(int) {
+    interrupted = true;
+}
+
+const char* USAGE =
+    "Usage: ffmpeg_multi                      Interactive menu\n"
+    "       ffmpeg_multi <command> [options]  Run one job\n"
+    "       ffmpeg_multi run <manifest.json>  Run every job of a manifest\n"
+    "\n"
+    "Commands:\n"
+    "  reencode        --input F --output F [--codec x264|x265|av1|svtav1|prores|ffv1|h264_nvenc|h265_nvenc]\n"
+    "                  [--profile youtube|x264|x265|h264_nvenc|h265_nvenc|prores|ffv1]\n"
+    "                  [--crf N | --qp N | --bitrate KBPS | --cbr KBPS] [--preset P] [--tune T]\n"
+    "                  [--target-vmaf X | --target-ssim X | --target-psnr DB [--target-samples N]]\n"
+    "                  [--gop N] [--bframes N] [--threads N] [--ten-bit | --eight-bit]\n"
+    "                  [--color sdr|hdr10|hlg] [--max-cll CLL,FALL]\n"
+    "                  [--prores-profile 0-5] [--prores-vendor V] [--prores-bits-per-mb N]\n"
+    "                  [--ffv1-coder N] [--ffv1-context N] [--ffv1-level N] [--ffv1-slices N]\n"
+    "                  [--x264-params S] [--nvenc-b-adapt N] [--nvenc-lookahead N]\n"
+    "                  [--nvenc-qp-cb-offset N] [--nvenc-qp-cr-offset N]\n"
+    "                  [--copy-audio | --no-audio] [--audio-codec C] [--audio-bitrate KBPS]\n"
+    "                  [--audio-sample-rate HZ] [--audio-channels N]\n"
+    "                  [--start S] [--duration S] [--chunk-seconds S] [--chunk-workers N] [--chunk-retries N]\n"
+    "                  [--container EXT] [--overwrite] [--extra-arg ARG]...\n"
+    "                  [--streaming hls|dash [--segment-seconds S]]\n"
+    "                  [--cache [--cache-limit GB]]\n"
+    "  ladder          --input F --rendition HEIGHT=F [--rendition WIDTHxHEIGHT=F]...\n"
+    "                  [--master F] [encoding and range options of reencode, shared by every rendition]\n"
+    "  extract-frames  --input F --output-dir D [--format png|tiff|jpeg] [--parallel N]\n"
+    "                  [--subfolder NAME | --no-subfolder]\n"
+    "  thumbnails      --input F --output-dir D [--format png|tiff|jpeg] [--threshold 0-1]\n"
+    "                  [--detection native|filter] [--downscale N] [--min-scene S]\n"
+    "                  [--subfolder NAME | --no-subfolder]\n"
+    "  concat          --input F --input F... --output F\n"
+    "  svt-av1         --input F --output F [--quality low|medium|high] [--aggressive] [--unshackle]\n"
+    "                  [--quiet] [--keep-temp] [--extract-audio] [--engine native|script] [--workers N]\n"
+    "  probe-dir       DIR [--report F] [--format jsonl|csv] [--jobs N] [--no-recursive]\n"
+    "  run             MANIFEST [--jobs N] [--retries N] [--log-dir D] [--dry-run]\n"
+    "                  [--resume [--verify]] [--journal F] [--metrics F] [--trace F]\n"
+    "                  [--prometheus F.prom [--prometheus-interval S]]\n"
+    "                  Manifest: {\"jobs\": [{\"type\": COMMAND, option: value...}...], \"concurrency\": N, ...},\n"
+    "                  option names without \"--\", a list repeats an option, true/false sets a switch\n"
+    "                  (format and sample in README.md, \"Command Line & Batch Manifests\")\n"
+    "\n"
+    "Job options: [--retries N] [--timeout SECONDS] [--log FILE] [--no-progress] [--metrics F] [--trace F]\n"
+    "  In a manifest, each job accepts retries, timeout and log; metrics and trace are settings of the batch\n"
+    "  --metrics writes the CPU time, peak memory, threads and I/O of each job as JSON\n"
+    "  --trace writes a timeline of the steps and processes of each job for ui.perfetto.dev\n";
+
+// ============================================================================
+// VALUE PARSING
+// ============================================================================
+
+template<typename Builder> void applyImageFormat(Builder& builder, const std::string& format) {
+    if (format == "png") {
+        builder.png();
+    } else if (format == "tiff" || format == "tif") {
+        builder.tiff();
+    } else if (format == "jpeg" || format == "jpg") {
+        builder.jpeg();
+    } else {
+        throw UsageError("Unknown image format \"" + format + "\" (png, tiff, jpeg)");
+    }
+}
+
+void applyCodec(Jobs::ReencodeJobBuilder& builder, const std::string& codec) {
+    if (codec == "x264" || codec == "h264") {
+        builder.x264();
+    } else if (codec == "x265" || codec == "hevc" || codec == "h265") {
+        builder.x265();
+    } else if (codec == "av1" || codec == "libaom") {
+        builder.av1();
+    } else if (codec == "svtav1" || codec == "svt-av1") {
+        builder.svtav1();
+    } else if (codec == "prores") {
+        builder.prores();
+    } else if (codec == "ffv1") {
+        builder.ffv1();
+    } else if (codec == "h264_nvenc" || codec == "h264-nvenc") {
+        builder.h264_nvenc();
+    } else if (codec == "h265_nvenc" || codec == "h265-nvenc" || codec == "hevc_nvenc") {
+        builder.h265_nvenc();
+    } else {
+        throw UsageError("Unknown codec \"" + codec + "\"");
+    }
+}
+
+void applyProfile(Jobs::ReencodeJobBuilder& builder, const std::string& profile) {
+    if (profile == "youtube") {
+        builder.youtubePreset();
+    } else if (profile == "x264") {
+        builder.x264Preset();
+    } else if (profile == "x265") {
+        builder.x265Preset();
+    } else if (profile == "h264_nvenc" || profile == "h264-nvenc") {
+        builder.h264NvencPreset();
+    } else if (profile == "h265_nvenc" || profile == "h265-nvenc") {
+        builder.h265NvencPreset();
+    } else if (profile == "prores") {
+        builder.proresPreset();
+    } else if (profile == "ffv1") {
+        builder.ffv1Preset();
+    } else {
+        throw UsageError("Unknown profile \"" + profile + "\"");
+    }
+}
+
+// ============================================================================
+// JOB BUILDERS
+// ============================================================================
+
+// Encoding options shared by reencode and every rendition of a ladder
+void applyEncodeOptions(Jobs::ReencodeJobBuilder& builder, const Options& o) {
+    // Profile first, so that the individual options below refine it
+    if (o.has("profile")) {
+        applyProfile(builder, o.get("profile"));
+    }
+    if (o.has("codec")) {
+        applyCodec(builder, o.get("codec"));
+    }
+
+    // Rate control
+    if (o.has("crf")) builder.crf(o.getInt("crf", 0, 0, 63));
+    if (o.has("qp")) builder.qp(o.getInt("qp", 0, 0, 255));
+    if (o.has("bitrate")) builder.bitrate(o.getInt("bitrate", 0, 1, 1000000));
+    if (o.has("vbr")) builder.vbr(o.getInt("vbr", 0, 1, 1000000));
+    if (o.has("cbr")) builder.cbr(o.getInt("cbr", 0, 1, 1000000));
+
+    // Target quality: the CRF is searched on sample encodes
+    int targets = (o.has("target-vmaf") ? 1 : 0) + (o.has("target-ssim") ? 1 : 0) + (o.has("target-psnr") ? 1 : 0);
+    if (targets > 1) {
+        throw UsageError("--target-vmaf, --target-ssim and --target-psnr are exclusive");
+    }
+    if (o.has("target-vmaf")) builder.targetQuality(Encode::QualityMetric::VMAF, o.getDouble("target-vmaf", 0.0, 1.0, 100.0));
+    if (o.has("target-ssim")) builder.targetQuality(Encode::QualityMetric::SSIM, o.getDouble("target-ssim", 0.0, 0.01, 1.0));
+    if (o.has("target-psnr")) builder.targetQuality(Encode::QualityMetric::PSNR, o.getDouble("target-psnr", 0.0, 1.0, 100.0));
+    if (o.has("target-samples")) {
+        if (targets == 0) {
+            throw UsageError("--target-samples needs --target-vmaf, --target-ssim or --target-psnr");
+        }
+        builder.targetSamples(o.getInt("target-samples", 0, 1, 100), Encode::QualityTarget{}.sample_seconds);
+    }
+
+    // Encoding parameters
+    if (o.has("preset")) builder.preset(o.get("preset"));
+    if (o.has("tune")) builder.tune(o.get("tune"));
+    if (o.has("gop")) builder.gopSize(o.getInt("gop", 0, 1, 100000));
+    if (o.has("bframes")) builder.bframes(o.getInt("bframes", 0, 0, 16));
+    if (o.has("threads")) builder.threads(o.getInt("threads", 0, 0, 1024));
+    if (o.flag("ten-bit")) builder.tenBit();
+    if (o.flag("eight-bit")) builder.eightBit();
+
+    // Codec specific
+    if (o.has("prores-profile")) builder.proresProfile(o.getInt("prores-profile", 0, 0, 5));
+    if (o.has("prores-vendor")) builder.proresVendor(o.get("prores-vendor"));
+    if (o.has("prores-bits-per-mb")) builder.proresBitsPerMB(o.getInt("prores-bits-per-mb", 0, 1, 100000));
+    if (o.has("ffv1-coder")) builder.ffv1Coder(o.getInt("ffv1-coder", 0, 0, 2));
+    if (o.has("ffv1-context")) builder.ffv1Context(o.getInt("ffv1-context", 0, 0, 1));
+    if (o.has("ffv1-level")) builder.ffv1Level(o.getInt("ffv1-level", 0, 1, 3));
+    if (o.has("ffv1-slices")) builder.ffv1Slices(o.getInt("ffv1-slices", 0, 1, 1024));
+    if (o.has("x264-params")) builder.x264Params(o.get("x264-params"));
+    if (o.has("nvenc-b-adapt")) builder.nvencBAdapt(o.getInt("nvenc-b-adapt", 0, 0, 1));
+    if (o.has("nvenc-lookahead")) builder.nvencRcLookahead(o.getInt("nvenc-lookahead", 0, 0, 250));
+    if (o.has("nvenc-qp-cb-offset")) builder.nvencQpCbOffset(o.getInt("nvenc-qp-cb-offset", 0, -12, 12));
+    if (o.has("nvenc-qp-cr-offset")) builder.nvencQpCrOffset(o.getInt("nvenc-qp-cr-offset", 0, -12, 12));
+
+    // Color
+    if (o.has("color")) {
+        std::string color = o.get("color");
+        if (color == "sdr") {
+            builder.sdr();
+        } else if (color == "hdr10") {
+            builder.hdr10();
+        } else if (color == "hlg") {
+            builder.hlg();
+        } else {
+            throw UsageError("Unknown color preset \"" + color + "\" (sdr, hdr10, hlg)");
+        }
+    }
+    if (o.has("max-cll")) {
+        std::string value = o.get("max-cll");
+        unsigned cll = 0, fall = 0;
+        char comma = 0;
+        std::istringstream in(value);
+        if (!(in >> cll >> comma >> fall) || comma != ',' || cll > 65535 || fall > 65535 || !(in >> std::ws).eof()) {
+            throw UsageError("--max-cll expects CLL,FALL (e.g. 1000,400)");
+        }
+        builder.maxCLL(static_cast<uint16_t>(cll), static_cast<uint16_t>(fall));
+    }
+
+    // Audio
+    if (o.flag("copy-audio")) builder.copyAudio();
+    if (o.has("audio-codec")) builder.audioCodec(o.get("audio-codec"));
+    if (o.has("audio-bitrate")) builder.audioBitrate(o.getInt("audio-bitrate", 0, 1, 10000));
+    if (o.has("audio-sample-rate")) builder.audioSampleRate(o.getInt("audio-sample-rate", 0, 1000, 768000));
+    if (o.has("audio-channels")) builder.audioChannels(o.getInt("audio-channels", 0, 1, 64));
+    if (o.flag("no-audio")) builder.noAudio();
+
+    // Range and chunks
+    if (o.has("start") || o.has("duration")) {
+        builder.range(o.getDouble("start", 0.0, 0.0, 1e9), o.getDouble("duration", 0.0, 0.0, 1e9));
+    }
+    if (o.has("chunk-seconds")) {
+        builder.chunked(o.getDouble("chunk-seconds", 0.0, 0.0, 1e6), o.getInt("chunk-workers", 0, 0, 256));
+    } else if (o.has("chunk-workers")) {
+        throw UsageError("--chunk-workers needs --chunk-seconds");
+    }
+    if (o.has("chunk-retries")) builder.chunkRetries(o.getInt("chunk-retries", 0, 0, 10));
+
+    // Advanced
+    if (o.has("container")) builder.container(o.get("container"));
+    if (o.flag("overwrite")) builder.overwrite();
+    if (o.has("streaming")) {
+        std::string format = o.get("streaming");
+        double seconds = o.getDouble("segment-seconds", 4.0, 0.1, 3600.0);
+        if (format == "hls") {
+            builder.hls(seconds);
+        } else if (format == "dash") {
+            builder.dash(seconds);
+        } else {
+            throw UsageError("--streaming expects hls or dash");
+        }
+    } else if (o.has("segment-seconds")) {
+        throw UsageError("--segment-seconds needs --streaming");
+    }
+    if (o.flag("cache")) builder.outputCache();
+    if (o.has("cache-limit")) {
+        double gigabytes = o.getDouble("cache-limit", 0.0, 0.0, 1e6);
+        Pipeline::OutputCache::instance().setMaxBytes(static_cast<uint64_t>(gigabytes * 1024.0 * 1024.0 * 1024.0));
+    }
+    for (const auto& arg : o.getAll("extra-arg")) {
+        builder.addExtraArg(arg);
+    }
+}
+
+std::unique_ptr<Core::Job> buildReencode(const Options& o) {
+    Jobs::ReencodeJobBuilder builder;
+    builder.input(o.require("input")).output(o.require("output"));
+    applyEncodeOptions(builder, o);
+    return std::make_unique<Jobs::ReencodeJob>(builder.build());
+}
+
+std::unique_ptr<Core::Job> buildLadder(const Options& o) {
+    std::string input = o.require("input");
+    std::vector<std::string> renditions = o.getAll("rendition");
+    if (renditions.empty()) {
+        throw UsageError("ladder needs at least one --rendition");
+    }
+
+    Jobs::ReencodeJobBuilder encode;
+    encode.input(input).output(renditions.front());
+    applyEncodeOptions(encode, o);
+
+    // HEIGHT=FILE or WIDTHxHEIGHT=FILE, every rendition with the shared encoding options
+    Jobs::LadderBuilder builder;
+    builder.input(input);
+    for (const auto& rendition : renditions) {
+        size_t equals = rendition.find('=');
+        std::string size = rendition.substr(0, equals);
+        int width = 0, height = 0;
+        char x = 0;
+        std::istringstream in(size);
+        bool valid = equals != std::string::npos && equals + 1 < rendition.size();
+        if (valid && size.find('x') != std::string::npos) {
+            valid = static_cast<bool>(in >> width >> x >> height) && x == 'x';
+        } else if (valid) {
+            valid = static_cast<bool>(in >> height);
+        }
+        if (!valid || !(in >> std::ws).eof() || width < 0 || width > 16384 || height < 1 || height > 16384) {
+            throw UsageError("--rendition expects HEIGHT=FILE or WIDTHxHEIGHT=FILE (e.g. 720=out_720p.mp4)");
+        }
+        std::string output = rendition.substr(equals + 1);
+        builder.rendition(output, width, height, encode.output(output).build().config());
+    }
+    if (o.has("master")) builder.masterPlaylist(o.get("master"));
+    return std::make_unique<Jobs::LadderJob>(builder.build());
+}
+
+std::unique_ptr<Core::Job> buildExtractFrames(const Options& o) {
+    Jobs::ExtractFramesBuilder builder;
+    builder.input(o.require("input")).outputDir(o.require("output-dir"));
+    if (o.has("format")) applyImageFormat(builder, o.get("format"));
+    if (o.has("parallel")) builder.parallel(o.getInt("parallel", 0, 0, 256));
+    if (o.has("subfolder")) builder.subfolderName(o.get("subfolder"));
+    if (o.flag("no-subfolder")) builder.createSubfolder(false);
+    return std::make_unique<Jobs::ExtractFramesJob>(builder.build());
+}
+
+std::unique_ptr<Core::Job> buildThumbnails(const Options& o) {
+    Jobs::ThumbnailsBuilder builder;
+    builder.input(o.require("input")).outputDir(o.require("output-dir"));
+    if (o.has("format")) applyImageFormat(builder, o.get("format"));
+    if (o.has("threshold")) builder.sceneThreshold(static_cast<float>(o.getDouble("threshold", 0.0, 0.0, 1.0)));
+    if (o.has("detection")) {
+        std::string detection = o.get("detection");
+        if (detection != "native" && detection != "filter") {
+            throw UsageError("--detection expects native or filter");
+        }
+        builder.nativeDetection(detection == "native");
+    }
+    if (o.has("downscale")) builder.analysisDownscale(o.getInt("downscale", 0, 1, 64));
+    if (o.has("min-scene")) builder.minSceneSeconds(o.getDouble("min-scene", 0.0, 0.0, 3600.0));
+    if (o.has("subfolder")) builder.subfolderName(o.get("subfolder"));
+    if (o.flag("no-subfolder")) builder.createSubfolder(false);
+    return std::make_unique<Jobs::ThumbnailsJob>(builder.build());
+}
+
+std::unique_ptr<Core::Job> buildConcat(const Options& o) {
+    Jobs::ConcatBuilder builder;
+    std::vector<std::string> inputs = o.getAll("input");
+    inputs.insert(inputs.end(), o.positionals().begin(), o.positionals().end());
+    if (inputs.size() < 2) {
+        throw UsageError("concat needs at least 2 inputs");
+    }
+    for (const auto& input : inputs) {
+        builder.addInput(input);
+    }
+    builder.output(o.require("output"));
+    return std::make_unique<Jobs::ConcatJob>(builder.build());
+}
+
+std::unique_ptr<Core::Job> buildSvtAv1(const Options& o) {
+    Jobs::SvtAv1EssentialBuilder builder;
+    builder.input(o.require("input")).output(o.require("output"));
+    if (o.has("quality")) {
+        std::string quality = o.get("quality");
+        if (quality == "low") {
+            builder.quality(Jobs::SvtAv1EssentialJob::Quality::LOW);
+        } else if (quality == "medium") {
+            builder.quality(Jobs::SvtAv1EssentialJob::Quality::MEDIUM);
+        } else if (quality == "high") {
+            builder.quality(Jobs::SvtAv1EssentialJob::Quality::HIGH);
+        } else {
+            throw UsageError("--quality expects low, medium or high");
+        }
+    }
+    if (o.flag("aggressive")) builder.aggressive();
+    if (o.flag("unshackle")) builder.unshackle();
+    if (o.flag("quiet")) builder.verbose(false);
+    if (o.flag("keep-temp")) builder.cleanup(false);
+    if (o.flag("extract-audio")) builder.extractAudio();
+    if (o.has("engine")) {
+        std::string engine = o.get("engine");
+        if (engine != "native" && engine != "script") {
+            throw UsageError("--engine expects native or script");
+        }
+        builder.native(engine == "native");
+    }
+    if (o.has("workers")) builder.workers(static_cast<unsigned>(o.getInt("workers", 0, 0, 256)));
+    return std::make_unique<Jobs::SvtAv1EssentialJob>(builder.build());
+}
+
+// ============================================================================
+// OUTPUT
+// ============================================================================
+
+// Single line progress, only when a human watches the terminal
+void printProgress(const Core::Progress& progress) {
+    std::ostringstream line;
+    line << std::fixed << std::setprecision(1);
+    double percent = progress.percent();
+    if (percent >= 0.0) {
+        line << std::setw(5) << percent << "%  ";
+    }
+    line << "frame " << progress.frame << "  fps " << progress.fps << "  speed " << std::setprecision(2) << progress.speed << "x";
+    std::cout << "\r" << Colors::TEAL << "  " << line.str() << Colors::RESET << "    " << std::flush;
+    if (progress.finished) {
+        std::cout << std::endl;
+    }
+}
+
+void printJobFinished(const Pipeline::BatchJobResult& result, size_t done, size_t total) {
+    const char* color = result.success ? Colors::GREEN : (result.cancelled ? Colors::YELLOW : Colors::RED);
+    const char* status = result.resumed ? "Resumed " : (result.success ? "Done    " : (result.cancelled ? "Skipped " : "Failed  "));
+    std::cout << color << "[" << done << "/" << total << "] " << status << Colors::TEXT << result.name << Colors::SUBTEXT
+              << " (" << std::fixed << std::setprecision(1) << result.wall_seconds << " s";
+    if (result.attempts > 1) {
+        std::cout << ", " << result.attempts << " attempts";
+    }
+    std::cout << ")";
+    if (!result.error.empty()) {
+        std::cout << Colors::RED << " " << result.error;
+    }
+    if (!result.success && !result.log_file.empty()) {
+        std::cout << Colors::SUBTEXT << " -> " << result.log_file.string();
+    }
+    std::cout << Colors::RESET << std::endl;
+}
+
+int exitCode(const Pipeline::BatchSummary& summary) {
+    if (interrupted) {
+        return EXIT_INTERRUPTED;
+    }
+    return summary.allSucceeded() ? EXIT_OK : EXIT_FAILED;
+}
+
+/**
+ * @brief Settings shared by every job (command line or manifest entry)
+ */
+void applyJobOptions(Core::Job& job, const Options& o) {
+    if (o.has("timeout")) {
+        job.setTimeout(std::chrono::milliseconds(static_cast<long long>(o.getDouble("timeout", 0.0, 0.0, 1e7) * 1000.0)));
+    }
+    if (o.has("log")) {
+        job.setLogFile(o.get("log"));
+    }
+}
+
+// ============================================================================
+// COMMANDS
+// ============================================================================
+
+int runSingle(const std::string& command, const Options& o) {
+    std::unique_ptr<Core::Job> job = buildJob(command, o);
+    applyJobOptions(*job, o);
+    int retries = o.getInt("retries", 0, 0, 100);
+    bool progress = !o.flag("no-progress");
+    std::string metrics = o.get("metrics");
+    std::string trace = o.get("trace");
+    o.checkAllUsed();
+
+    if (progress && job->getLogFile().empty() && isatty(STDOUT_FILENO)) {
+        job->setProgressCallback(printProgress);
+    }
+
+    Pipeline::BatchOptions options;
+    options.concurrency = 1;
+    options.max_retries = retries;
+    options.metrics_file = metrics;
+    options.trace_file = trace;
+    options.should_stop = [] { return interrupted.load(); };
+
+    Pipeline::BatchRunner runner(options);
+    runner.add(std::move(job), command);
+    Pipeline::BatchSummary summary = runner.run();
+    ::Jobs::ProbeCache::instance().flush();
+
+    const Pipeline::BatchJobResult& result = summary.results.front();
+    if (!result.error.empty()) {
+        std::cerr << Colors::RED << "[ERROR] " << result.error << Colors::RESET << std::endl;
+    }
+    return exitCode(summary);
+}
+
+int runProbeDir(const Options& o) {
+    std::vector<std::string> dirs = o.getAll("input");
+    dirs.insert(dirs.end(), o.positionals().begin(), o.positionals().end());
+    if (dirs.size() != 1) {
+        throw UsageError("probe-dir expects one directory");
+    }
+
+    Pipeline::DirectoryProbeOptions options;
+    options.concurrency = static_cast<unsigned>(o.getInt("jobs", 0, 0, 1024));
+    options.recursive = !o.flag("no-recursive");
+    std::string format = o.get("format", "jsonl");
+    if (format == "jsonl" || format == "json") {
+        options.format = Pipeline::ProbeReportFormat::JSON_LINES;
+    } else if (format == "csv") {
+        options.format = Pipeline::ProbeReportFormat::CSV;
+    } else {
+        throw UsageError("--format expects jsonl or csv");
+    }
+    std::string defaultReport = options.format == Pipeline::ProbeReportFormat::CSV ? "probe_report.csv" : "probe_report.jsonl";
+    options.report_path = o.get("report", (fs::path(dirs.front()) / defaultReport).string());
+    options.should_stop = [] { return interrupted.load(); };
+    options.on_file_done = [](const fs::path& file, bool ok, size_t) {
+        if (!ok) {
+            std::cerr << Colors::RED << "[FAILED] " << Colors::TEXT << file.string() << Colors::RESET << std::endl;
+        }
+    };
+    o.checkAllUsed();
+
+    Pipeline::DirectoryProbe probe(dirs.front(), options);
+    Pipeline::DirectoryProbeStats stats = probe.run();
+    ::Jobs::ProbeCache::instance().flush();
+
+    std::cout << stats.files << " file(s) analyzed, " << stats.failed << " failed in " << std::fixed << std::setprecision(1)
+              << stats.wall_seconds << " s -> " << options.report_path.string() << std::endl;
+    if (interrupted) {
+        return EXIT_INTERRUPTED;
+    }
+    return stats.failed == 0 ? EXIT_OK : EXIT_FAILED;
+}
+
+} // namespace
+
+// ============================================================================
+// PUBLIC API
+// ============================================================================
+
+std::set<std::string> commandSwitches(const std::string& command) {
+    std::set<std::string> switches = {"no-progress", "help"};
+    if (command == "reencode" || command == "ladder") {
+        switches.insert({"ten-bit", "eight-bit", "copy-audio", "no-audio", "overwrite", "cache"});
+    } else if (command == "extract-frames" || command == "thumbnails") {
+        switches.insert("no-subfolder");
+    } else if (command == "svt-av1") {
+        switches.insert({"aggressive", "unshackle", "quiet", "keep-temp", "extract-audio"});
+    } else if (command == "probe-dir") {
+        switches.insert("no-recursive");
+    } else if (command == "run") {
+        switches.insert({"dry-run", "resume", "verify"});
+    }
+    return switches;
+}
+
+std::unique_ptr<Core::Job> buildJob(const std::string& command, const Options& options) {
+    try {
+        if (command == "reencode") return buildReencode(options);
+        if (command == "ladder") return buildLadder(options);
+        if (command == "extract-frames") return buildExtractFrames(options);
+        if (command == "thumbnails") return buildThumbnails(options);
+        if (command == "concat") return buildConcat(options);
+        if (command == "svt-av1") return buildSvtAv1(options);
+    } catch (const UsageError&) {
+        throw;
+    } catch (const std::exception& e) {
+        // Validation errors of the builders are usage errors here: nothing has run yet
+        throw UsageError(e.what());
+    }
+    throw UsageError("Unknown command \"" + command + "\"");
+}
+
+int runManifest(const fs::path& manifest, const Options& options) {
+    std::ifstream in(manifest, std::ios::binary);
+    if (!in.is_open()) {
+        throw UsageError("Cannot open manifest: " + manifest.string());
+    }
+    std::string text((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+
+    Json::Value root;
+    try {
+        root = Json::Value::parse(text);
+    } catch (const Json::ParseError& e) {
+        throw UsageError(manifest.string() + ": " + e.what() + " (offset " + std::to_string(e.offset()) + ")");
+    }
+    if (!root.isObject() || !root["jobs"].isArray()) {
+        throw UsageError(manifest.string() + ": expected an object with a \"jobs\" array");
+    }
+    for (const auto& member : root.members()) {
+        if (member.first != "jobs" && member.first != "concurrency" && member.first != "max_retries" && member.first != "log_dir" &&
+            member.first != "metrics" && member.first != "trace" && member.first != "prometheus") {
+            throw UsageError(manifest.string() + ": unknown setting \"" + member.first + "\"");
+        }
+    }
+
+    Pipeline::BatchOptions batch;
+    batch.concurrency = static_cast<unsigned>(std::max(0LL, root["concurrency"].asInt(0)));
+    batch.max_retries = static_cast<int>(std::max(0LL, root["max_retries"].asInt(0)));
+    batch.log_dir = root.contains("log_dir") ? fs::path(root["log_dir"].asString()) : manifest.parent_path() / "logs";
+    if (options.has("jobs")) batch.concurrency = static_cast<unsigned>(options.getInt("jobs", 0, 0, 1024));
+    if (options.has("retries")) batch.max_retries = options.getInt("retries", 0, 0, 100);
+    if (options.has("log-dir")) batch.log_dir = options.get("log-dir");
+    batch.metrics_file = options.get("metrics", root["metrics"].asString());
+    batch.trace_file = options.get("trace", root["trace"].asString());
+    std::string prometheus = options.get("prometheus", root["prometheus"].asString());
+    double prometheusInterval = options.getDouble("prometheus-interval", 5.0, 0.1, 3600.0);
+    if (!prometheus.empty()) {
+        batch.prometheus = std::make_shared<Pipeline::PrometheusExporter>(prometheus, std::chrono::milliseconds(static_cast<long long>(prometheusInterval * 1000.0)));
+    }
+    bool dryRun = options.flag("dry-run");
+    fs::path journalPath = options.get("journal", manifest.string() + ".journal");
+    batch.resume = options.flag("resume");
+    batch.verify_resumed = options.flag("verify");
+    options.checkAllUsed();
+    if (batch.verify_resumed && !batch.resume) {
+        throw UsageError("--verify only applies with --resume");
+    }
+    if (!dryRun) {
+        batch.journal = std::make_shared<Pipeline::Journal>(journalPath);
+    }
+
+    // Build every job first: a typo in the last entry must not surface hours into the batch
+    Pipeline::BatchRunner runner(batch);
+    const auto& jobs = root["jobs"].items();
+    for (size_t i = 0; i < jobs.size(); ++i) {
+        std::string where = "job #" + std::to_string(i + 1);
+        try {
+            if (!jobs[i].isObject()) {
+                throw UsageError("expected an object");
+            }
+            Options jobOptions = Options::fromJson(jobs[i]);
+            std::string type = jobOptions.require("type");
+            std::string name = jobOptions.get("name");
+            if (name.empty()) {
+                std::vector<std::string> inputs = jobOptions.getAll("input");
+                name = type + (inputs.empty() ? "" : "_" + fs::path(inputs.front()).filename().string());
+            }
+            where += " (" + name + ")";
+
+            std::unique_ptr<Core::Job> job = buildJob(type, jobOptions);
+            applyJobOptions(*job, jobOptions);
+            int retries = jobOptions.has("retries") ? jobOptions.getInt("retries", 0, 0, 100) : -1;
+            jobOptions.checkAllUsed();
+
+            // Renaming a job or changing its retries keeps its journal state, any other change makes it run again
+            std::string fingerprint = Hash::hex64(jobOptions.canonical({"name", "retries"}));
+            runner.add(std::move(job), name, fingerprint, jobOptions.get("output"), retries);
+        } catch (const UsageError& e) {
+            throw UsageError(manifest.string() + ": " + where + ": " + e.what());
+        }
+    }
+
+    std::cout << Colors::SAPPHIRE << ":: Manifest " << manifest.filename().string() << " : " << Colors::TEXT << runner.size()
+              << " job(s), " << (batch.concurrency ? batch.concurrency : runner.recommendedConcurrency()) << " in parallel"
+              << Colors::RESET << std::endl;
+    if (batch.resume) {
+        std::cout << Colors::TEAL << "Resuming from " << journalPath.string() << Colors::RESET << std::endl;
+    }
+    if (dryRun || runner.size() == 0) {
+        return EXIT_OK;
+    }
+
+    runner.options().should_stop = [] { return interrupted.load(); };
+    runner.options().on_job_finished = printJobFinished;
+    Pipeline::BatchSummary summary = runner.run();
+    ::Jobs::ProbeCache::instance().flush();
+
+    std::cout << Colors::TEAL << "Succeeded " << summary.succeeded << " (" << summary.resumed << " already done), failed " << summary.failed << ", skipped " << summary.cancelled
+              << " in " << std::fixed << std::setprecision(1) << summary.wall_seconds << " s" << Colors::RESET << std::endl;
+    return exitCode(summary);
+}
+
+int run(const std::vector<std::string>& args) {
+    if (args.empty() || args[0] == "help" || args[0] == "--help" || args[0] == "-h") {
+        std::cout << USAGE;
+        return EXIT_OK;
+    }
+
+    std::signal(SIGINT, onInterrupt);
+#ifdef SIGTERM
+    std::signal(SIGTERM, onInterrupt); // Schedulers stop jobs with SIGTERM
+#endif
+
+    const std::string& command = args[0];
+    try {
+        Options options = Options::parse(std::vector<std::string>(args.begin() + 1, args.end()), commandSwitches(command));
+        if (options.flag("help")) {
+            std::cout << USAGE;
+            return EXIT_OK;
+        }
+
+        if (command == "run") {
+            if (options.positionals().size() != 1) {
+                throw UsageError("run expects one manifest file");
+            }
+            return runManifest(options.positionals().front(), options);
+        }
+        if (command == "probe-dir") {
+            return runProbeDir(options);
+        }
+        if (command != "concat" && !options.positionals().empty()) {
+            throw UsageError("Unexpected argument \"" + options.positionals().front() + "\"");
+        }
+        return runSingle(command, options);
+    } catch (const UsageError& e) {
+        std::cerr << Colors::RED << "[ERROR] " << e.what() << Colors::RESET << std::endl;
+        std::cerr << "Run 'ffmpeg_multi help' for the list of commands and options." << std::endl;
+        return EXIT_USAGE;
+    } catch (const std::exception& e) {
+        std::cerr << Colors::RED << "[ERROR] " << e.what() << Colors::RESET << std::endl;
+        return EXIT_FAILED;
+    }
+}
+
+} // namespace Cli
+} // namespace FFmpegMulti
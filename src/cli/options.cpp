@@ -0,0 +1,177 @@
+#include "../../include/cli/options.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <sstream>
+
+namespace FFmpegMulti {
+namespace Cli {
+
+namespace {
+
+std::string formatNumber(double value) {
+    std::ostringstream text;
+    text << value;
+    return text.str();
+}
+
+} // namespace
+
+// ============================================================================
+// PARSING
+// ============================================================================
+
+Options Options::parse(const std::vector<std::string>& args, const std::set<std::string>& switches) {
+    Options options;
+    bool optionsEnded = false;
+
+    for (size_t i = 0; i < args.size(); ++i) {
+        const std::string& arg = args[i];
+        if (optionsEnded || arg.size() < 3 || arg.compare(0, 2, "--") != 0) {
+            if (arg == "--") {
+                optionsEnded = true; // Everything after is positional (e.g. a file named "--x")
+                continue;
+            }
+            options.positionals_.push_back(arg);
+            continue;
+        }
+
+        std::string name = arg.substr(2);
+        size_t equals = name.find('=');
+        if (equals != std::string::npos) {
+            options.values_.emplace_back(name.substr(0, equals), name.substr(equals + 1));
+        } else if (switches.count(name)) {
+            options.values_.emplace_back(name, "true");
+        } else if (i + 1 < args.size()) {
+            options.values_.emplace_back(name, args[++i]);
+        } else {
+            throw UsageError("Missing value for --" + name);
+        }
+    }
+    return options;
+}
+
+Options Options::fromJson(const Json::Value& object) {
+    Options options;
+    for (const auto& [name, value] : object.members()) {
+        if (value.isObject()) {
+            throw UsageError("\"" + name + "\" must be a value or a list of values");
+        }
+        if (value.isArray()) {
+            for (const auto& item : value.items()) {
+                options.values_.emplace_back(name, item.asString());
+            }
+        } else if (value.type() == Json::Value::Type::Bool) {
+            options.values_.emplace_back(name, value.asBool() ? "true" : "false");
+        } else if (!value.isNull()) {
+            options.values_.emplace_back(name, value.asString());
+        }
+    }
+    return options;
+}
+
+// ============================================================================
+// ACCESSORS
+// ============================================================================
+
+bool Options::has(const std::string& name) const {
+    for (const auto& entry : values_) {
+        if (entry.first == name) {
+            used_.insert(name);
+            return true;
+        }
+    }
+    return false;
+}
+
+bool Options::flag(const std::string& name) const {
+    if (!has(name)) {
+        return false;
+    }
+    std::string value = get(name);
+    return value != "false" && value != "0" && value != "no";
+}
+
+std::string Options::get(const std::string& name, const std::string& fallback) const {
+    // The last occurrence wins, so a repeated flag overrides an earlier one
+    for (auto it = values_.rbegin(); it != values_.rend(); ++it) {
+        if (it->first == name) {
+            used_.insert(name);
+            return it->second;
+        }
+    }
+    return fallback;
+}
+
+std::string Options::require(const std::string& name) const {
+    std::string value = get(name);
+    if (value.empty()) {
+        throw UsageError("--" + name + " is required");
+    }
+    return value;
+}
+
+std::vector<std::string> Options::getAll(const std::string& name) const {
+    std::vector<std::string> all;
+    for (const auto& entry : values_) {
+        if (entry.first == name) {
+            all.push_back(entry.second);
+        }
+    }
+    used_.insert(name);
+    return all;
+}
+
+int Options::getInt(const std::string& name, int fallback, int min, int max) const {
+    if (!has(name)) {
+        return fallback;
+    }
+    std::string text = get(name);
+    char* end = nullptr;
+    errno = 0;
+    long value = std::strtol(text.c_str(), &end, 10);
+    if (text.empty() || *end != '\0' || errno == ERANGE || value < min || value > max) {
+        throw UsageError("--" + name + " expects an integer between " + std::to_string(min) + " and " + std::to_string(max) + " (got \"" + text + "\")");
+    }
+    return static_cast<int>(value);
+}
+
+double Options::getDouble(const std::string& name, double fallback, double min, double max) const {
+    if (!has(name)) {
+        return fallback;
+    }
+    std::string text = get(name);
+    char* end = nullptr;
+    errno = 0;
+    double value = std::strtod(text.c_str(), &end);
+    if (text.empty() || *end != '\0' || errno == ERANGE || !(value >= min && value <= max)) {
+        throw UsageError("--" + name + " expects a number between " + formatNumber(min) + " and " + formatNumber(max) + " (got \"" + text + "\")");
+    }
+    return value;
+}
+
+std::string Options::canonical(const std::set<std::string>& ignored) const {
+    // Stable sort: the order of repeated values (e.g. concat inputs) is meaningful
+    std::vector<std::pair<std::string, std::string>> sorted = values_;
+    std::stable_sort(sorted.begin(), sorted.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+
+    std::string text;
+    for (const auto& [name, value] : sorted) {
+        if (!ignored.count(name)) {
+            text += name + "=" + value + "\n";
+        }
+    }
+    return text;
+}
+
+void Options::checkAllUsed() const {
+    for (const auto& entry : values_) {
+        if (!used_.count(entry.first)) {
+            throw UsageError("Unknown option --" + entry.first);
+        }
+    }
+}
+
+} // namespace Cli
+} // namespace FFmpegMulti
@@ -2,11 +2,17 @@
 #include <sstream>
 #include <iomanip>
 #include <vector>
+#include <filesystem>
+#include <algorithm>
+#include <cctype>
+#include <map>
+#include <thread>
 
 #include "../../include/core/app.hpp"
 #include "../../include/core/string_utils.hpp"
 #include "../../include/core/colors.hpp"
 #include "../../include/core/input.hpp"
+#include "../../include/core/progress.hpp"
 #include "../../include/jobs/encode.hpp"
 #include "../../include/jobs/extract_frames.hpp"
 #include "../../include/jobs/probe.hpp"
@@ -21,6 +27,10 @@
 #include "../../include/jobs/svt_av1_essential.hpp"
 #include "../../include/jobs/thumbnails.hpp"
 #include "../../include/jobs/concat.hpp"
+#include "../../include/jobs/codec_utils.hpp"
+#include "../../include/pipeline/batch_runner.hpp"
+#include "../../include/pipeline/directory_probe.hpp"
+#include "../../include/jobs/probe_cache.hpp"
 
 using namespace FFmpegMulti::Jobs;
 using namespace FFmpegMulti::Encode;
@@ -127,6 +137,229 @@ std::string promptPreset(const std::string& options) {
     return Input::getString("Choice");
 }
 
+// Function to display the re-encoding codec menu and read the choice
+int promptReencodeCodec() {
+    std::cout << Colors::LAVENDER << Colors::BOLD << ":: Choose a codec ::" << Colors::RESET << std::endl;
+    printSeparator();
+    
+    std::cout << Colors::MAUVE << "  1." << Colors::TEXT << " X264 " << Colors::SUBTEXT << "- Universal, good compatibility" << Colors::RESET << std::endl;
+    std::cout << Colors::MAUVE << "  2." << Colors::TEXT << " X265 " << Colors::SUBTEXT << "- Better compression, superior quality" << Colors::RESET << std::endl;
+    std::cout << Colors::MAUVE << "  3." << Colors::TEXT << " AV1 " << Colors::SUBTEXT << "- Max compression for web" << Colors::RESET << std::endl;
+    std::cout << Colors::MAUVE << "  4." << Colors::TEXT << " H264_NVENC " << Colors::SUBTEXT << "- Hardware H.264 (NVIDIA)" << Colors::RESET << std::endl;
+    std::cout << Colors::MAUVE << "  5." << Colors::TEXT << " H265_NVENC " << Colors::SUBTEXT << "- Hardware H.265 (NVIDIA)" << Colors::RESET << std::endl;
+    std::cout << Colors::MAUVE << "  6." << Colors::TEXT << " ProRes " << Colors::SUBTEXT << "- Apple ProRes 4444 (Production)" << Colors::RESET << std::endl;
+    std::cout << Colors::MAUVE << "  7." << Colors::TEXT << " FFV1 " << Colors::SUBTEXT << "- Lossless codec for archiving" << Colors::RESET << std::endl;
+    std::cout << Colors::MAUVE << "  8." << Colors::TEXT << " YouTube Preset " << Colors::SUBTEXT << "- H.264, optimal quality" << Colors::RESET << std::endl;
+    
+    printSeparator();
+    int codecChoice = Input::getIntRange("Your choice", 1, 8);
+    std::cout << std::endl;
+    return codecChoice;
+}
+
+// Function to configure a re-encoding builder according to the codec choice
+void configureReencodeCodec(ReencodeJobBuilder& builder, int codecChoice) {
+    int qualityChoice;
+    std::string presetChoice;
+    
+    switch (codecChoice) {
+        case 1: { // Custom X264
+            std::cout << Colors::SAPPHIRE << Colors::BOLD << ":: X264 Configuration" << Colors::RESET << std::endl;
+            qualityChoice = promptQuality("CRF", "(18=excellent, 23=good, 28=acceptable)");
+            presetChoice = promptPreset("(ultrafast/fast/medium/slow/veryslow)");
+            
+            builder.x264().crf(qualityChoice).preset(presetChoice).copyAudio();
+            std::cout << Colors::GREEN << "[OK] X264 configured" << Colors::RESET << std::endl;
+            break;
+        }
+        
+        case 2: { // Custom X265
+            std::cout << Colors::SAPPHIRE << Colors::BOLD << ":: X265 Configuration" << Colors::RESET << std::endl;
+            qualityChoice = promptQuality("CRF", "(18=excellent, 23=good, 28=acceptable)");
+            presetChoice = promptPreset("(ultrafast/fast/medium/slow/veryslow)");
+            
+            builder.x265().crf(qualityChoice).preset(presetChoice).tenBit().copyAudio();
+            std::cout << Colors::GREEN << "[OK] X265 configured (10-bit)" << Colors::RESET << std::endl;
+            break;
+        }
+        
+        case 3: { // AV1
+            std::cout << Colors::SAPPHIRE << Colors::BOLD << ":: AV1 Configuration" << Colors::RESET << std::endl;
+            qualityChoice = promptQuality("CRF", "(20=excellent, 30=good, 35=acceptable)");
+            
+            builder.svtav1().crf(qualityChoice).preset("5").copyAudio();
+            std::cout << Colors::GREEN << "[OK] AV1 configured (SVT-AV1)" << Colors::RESET << std::endl;
+            break;
+        }
+
+        case 4: { // H264 NVENC
+            std::cout << Colors::SAPPHIRE << Colors::BOLD << ":: H264_NVENC Configuration" << Colors::RESET << std::endl;
+            qualityChoice = promptQuality("QP", "(17=excellent, 22=good, 27=acceptable)");
+            presetChoice = promptPreset("(p1/p2/p3/p4/p5/p6/p7)");
+
+            builder.h264_nvenc().qp(qualityChoice).preset(presetChoice).pixelFormat(FFmpegMulti::Encode::PixelFormat::P010).copyAudio();
+            std::cout << Colors::GREEN << "[OK] H264_NVENC configured (Hardware)" << Colors::RESET << std::endl;
+            break;
+        }
+
+        case 5: { // H265 NVENC
+            std::cout << Colors::SAPPHIRE << Colors::BOLD << ":: H265_NVENC Configuration" << Colors::RESET << std::endl;
+            qualityChoice = promptQuality("QP", "(17=excellent, 22=good, 27=acceptable)");
+            presetChoice = promptPreset("(p1/p2/p3/p4/p5/p6/p7)");
+
+            builder.h265_nvenc().qp(qualityChoice).preset(presetChoice).pixelFormat(FFmpegMulti::Encode::PixelFormat::P010).tune("hq").copyAudio();
+            std::cout << Colors::GREEN << "[OK] H265_NVENC configured (Hardware, HQ)" << Colors::RESET << std::endl;
+            break;
+        }
+
+        case 6: { // ProRes
+            int profileChoice;
+            std::cout << Colors::SAPPHIRE << Colors::BOLD << ":: ProRes Profile" << Colors::RESET << std::endl;
+            std::cout << Colors::MAUVE << "  0." << Colors::TEXT << " Proxy " << Colors::SUBTEXT << "- Low quality, reduced size" << Colors::RESET << std::endl;
+            std::cout << Colors::MAUVE << "  1." << Colors::TEXT << " LT " << Colors::SUBTEXT << "- Light, medium quality" << Colors::RESET << std::endl;
+            std::cout << Colors::MAUVE << "  2." << Colors::TEXT << " Standard " << Colors::SUBTEXT << "- Good quality" << Colors::RESET << std::endl;
+            std::cout << Colors::MAUVE << "  3." << Colors::TEXT << " HQ " << Colors::SUBTEXT << "- High Quality, excellent quality" << Colors::RESET << std::endl;
+            std::cout << Colors::MAUVE << "  4." << Colors::TEXT << " 4444 " << Colors::SUBTEXT << "- Max quality with alpha" << Colors::RESET << std::endl;
+            std::cout << Colors::MAUVE << "  5." << Colors::TEXT << " 4444 XQ " << Colors::SUBTEXT << "- Extreme quality" << Colors::RESET << std::endl;
+            
+            profileChoice = Input::getIntRange("Your choice", 0, 5);
+            
+            builder.prores().proresProfile(profileChoice).copyAudio().container("mov");
+            
+            std::cout << Colors::GREEN << "[OK] ProRes configured (Profile " << profileChoice << ")" << Colors::RESET << std::endl;
+            break;
+        }
+        
+        case 7: { // FFV1
+            builder.ffv1Preset();
+            std::cout << Colors::GREEN << "[OK] FFV1 configured (Lossless, Level 3)" << Colors::RESET << std::endl;
+            break;
+        }
+        
+        case 8: { // YouTube Preset
+            builder.youtubePreset();
+            std::cout << Colors::GREEN << "[OK] YouTube Preset applied (H.264, CRF 23, medium)" << Colors::RESET << std::endl;
+            break;
+        }
+        
+        default:
+            std::cout << Colors::YELLOW << "[WARN] Invalid choice, using default YouTube preset" << Colors::RESET << std::endl;
+            builder.youtubePreset();
+            break;
+    }
+}
+
+// Function to display FFmpeg progress on a single, constantly rewritten line
+void printProgress(const Core::Progress& progress) {
+    std::ostringstream line;
+    line << std::fixed << std::setprecision(1);
+    
+    double percent = progress.percent();
+    if (percent >= 0.0) {
+        line << std::setw(5) << percent << "%  ";
+    }
+    line << "frame " << progress.frame << "  fps " << progress.fps;
+    line << "  speed " << std::setprecision(2) << progress.speed << "x";
+    
+    double eta = progress.etaSeconds();
+    if (eta >= 0.0) {
+        int total = static_cast<int>(eta);
+        line << "  ETA " << std::setfill('0') << std::setw(2) << total / 3600 << ":"
+             << std::setw(2) << (total % 3600) / 60 << ":" << std::setw(2) << total % 60;
+    }
+    
+    // Below realtime encodes are highlighted
+    const char* color = (progress.speed > 0.0 && progress.speed < 1.0) ? Colors::YELLOW : Colors::TEAL;
+    std::cout << "\r" << color << "  " << line.str() << Colors::RESET << "    " << std::flush;
+    if (progress.finished) {
+        std::cout << std::endl;
+    }
+}
+
+// Function to list the video files of a directory (non recursive, sorted by name)
+std::vector<std::filesystem::path> listVideoFiles(const std::string& directory) {
+    static const std::vector<std::string> extensions = { ".mkv", ".mp4", ".mov", ".avi", ".webm", ".m4v", ".ts", ".mxf" };
+    
+    if (!std::filesystem::is_directory(directory)) {
+        throw std::runtime_error("Input directory does not exist: " + directory);
+    }
+    
+    std::vector<std::filesystem::path> files;
+    for (const auto& entry : std::filesystem::directory_iterator(directory)) {
+        if (!entry.is_regular_file()) {
+            continue;
+        }
+        std::string ext = entry.path().extension().string();
+        std::transform(ext.begin(), ext.end(), ext.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+        if (std::find(extensions.begin(), extensions.end(), ext) != extensions.end()) {
+            files.push_back(entry.path());
+        }
+    }
+    
+    std::sort(files.begin(), files.end());
+    return files;
+}
+
+// Function to display the result of a batch
+void printBatchSummary(const Pipeline::BatchSummary& summary) {
+    std::cout << Colors::SAPPHIRE << ":: Batch Summary :" << Colors::RESET << std::endl;
+    for (const auto& result : summary.results) {
+        if (result.success) {
+            std::cout << Colors::GREEN << "  [OK]     ";
+        } else if (result.cancelled) {
+            std::cout << Colors::YELLOW << "  [SKIP]   ";
+        } else {
+            std::cout << Colors::RED << "  [FAILED] ";
+        }
+        std::cout << Colors::TEXT << result.name << Colors::SUBTEXT;
+        if (result.attempts > 1) {
+            std::cout << " (" << result.attempts << " attempts)";
+        }
+        if (!result.success && !result.log_file.empty()) {
+            std::cout << " -> " << result.log_file.string();
+        }
+        std::cout << Colors::RESET << std::endl;
+    }
+    
+    std::cout << std::endl;
+    std::cout << Colors::TEAL << "  • Succeeded : " << Colors::TEXT << summary.succeeded << Colors::RESET << std::endl;
+    std::cout << Colors::TEAL << "  • Failed    : " << Colors::TEXT << summary.failed << Colors::RESET << std::endl;
+    std::cout << Colors::TEAL << "  • Skipped   : " << Colors::TEXT << summary.cancelled << Colors::RESET << std::endl;
+    std::cout << Colors::TEAL << "  • Duration  : " << Colors::TEXT << std::fixed << std::setprecision(1) << summary.wall_seconds << " s"
+              << " (" << summary.concurrency << " in parallel)" << Colors::RESET << std::endl;
+}
+
+// Function to display a histogram of a directory probe, most frequent first
+void printHistogram(const std::string& title, const std::map<std::string, size_t>& counts) {
+    std::vector<std::pair<std::string, size_t>> sorted(counts.begin(), counts.end());
+    std::sort(sorted.begin(), sorted.end(), [](const auto& a, const auto& b) { return a.second > b.second; });
+    
+    std::cout << Colors::TEAL << "  • " << title << " :" << Colors::RESET << std::endl;
+    for (const auto& [name, count] : sorted) {
+        std::cout << Colors::TEXT << "      " << std::left << std::setw(12) << (name.empty() ? "unknown" : name) << std::right
+                  << Colors::SUBTEXT << count << Colors::RESET << std::endl;
+    }
+}
+
+// Function to display the statistics of a directory probe
+void printProbeStats(const Pipeline::DirectoryProbeStats& stats) {
+    int hours = static_cast<int>(stats.total_duration) / 3600;
+    int minutes = (static_cast<int>(stats.total_duration) % 3600) / 60;
+    
+    std::cout << Colors::SAPPHIRE << ":: Inventory :" << Colors::RESET << std::endl;
+    std::cout << Colors::TEAL << "  • Files     : " << Colors::TEXT << stats.files << Colors::RESET << std::endl;
+    std::cout << Colors::TEAL << "  • Failed    : " << Colors::TEXT << stats.failed << Colors::RESET << std::endl;
+    std::cout << Colors::TEAL << "  • Duration  : " << Colors::TEXT << hours << " h " << minutes << " min" << Colors::RESET << std::endl;
+    std::cout << Colors::TEAL << "  • Size      : " << Colors::TEXT << std::fixed << std::setprecision(2)
+              << static_cast<double>(stats.total_bytes) / (1024.0 * 1024.0 * 1024.0) << " GB" << Colors::RESET << std::endl;
+    std::cout << Colors::TEAL << "  • Scan time : " << Colors::TEXT << std::setprecision(1) << stats.wall_seconds << " s" << Colors::RESET << std::endl;
+    
+    printHistogram("Video codecs", stats.video_codecs);
+    printHistogram("Audio codecs", stats.audio_codecs);
+    printHistogram("Resolutions", stats.resolutions);
+    printHistogram("Dynamic range", stats.dynamic_ranges);
+}
+
 // Function to confirm and execute a job
 template<typename JobType> bool confirmAndExecute(JobType& job, const std::string& outputFile = "") {
     std::cout << std::endl;
@@ -138,6 +371,7 @@ template<typename JobType> bool confirmAndExecute(JobType& job, const std::strin
         std::cout << Colors::BLUE << Colors::BOLD << ">>> Starting operation..." << Colors::RESET << std::endl;
         printSeparator();
         
+        job.setProgressCallback(printProgress);
         bool success = job.execute();
         
         printSeparator();
@@ -194,6 +428,8 @@ void affiche() {
     printOption(5, "Generate thumbnails");
     printOption(6, "Encode with SVT-AV1-Essential");
     printOption(7, "Analyze media (ffprobe)");
+    printOption(8, "Batch re-encode a folder");
+    printOption(9, "Analyze a folder (ffprobe)");
     
     // Separator
     std::cout << Colors::BLUE << "├─────┼";
@@ -226,7 +462,7 @@ bool choice() {
                 std::string inputFile, outputDir;
                 bool createSubfolder;
                 std::string subfolderName;
-                int formatChoice;
+                int formatChoice, segments;
 
                 printHeader("EXTRACT FRAMES");
                 std::cout << std::endl;
@@ -260,9 +496,14 @@ bool choice() {
                 formatChoice = Input::getIntRange("Your choice", 1, 3);
                 std::cout << std::endl;
                 
+                // Image encoding is single threaded: one segment per core keeps the machine busy
+                unsigned cores = Core::availableCores();
+                segments = Input::getIntRange("Parallel segments", 1, 64, "(1 = single process, recommended: " + std::to_string(cores) + ")");
+                std::cout << std::endl;
+                
                 try {
                     ExtractFramesBuilder builder;
-                    builder.input(inputFile).outputDir(outputDir).createSubfolder(createSubfolder);
+                    builder.input(inputFile).outputDir(outputDir).createSubfolder(createSubfolder).parallel(segments);
                     
                     if (createSubfolder && !subfolderName.empty()) {
                         builder.subfolderName(subfolderName);
@@ -302,7 +543,7 @@ bool choice() {
         case 2: {
             try {
                 std::string inputDir, outputDir, outputFilename, inputPattern;
-                int codecChoice, qualityChoice, formatChoice, framerate;
+                int codecChoice, qualityChoice, formatChoice, framerate, decodeWorkers;
                 std::string presetChoice;
 
                 printHeader("ENCODE A VIDEO");
@@ -323,6 +564,10 @@ bool choice() {
                 framerate = Input::getInt("Framerate (FPS)", "24");
                 std::cout << std::endl;
 
+                // Ask for parallel decoding (large PNG/TIFF sequences decode slower than they encode)
+                decodeWorkers = Input::getIntRange("Parallel image decoders (0 = the encoder reads the images)", 0, 256, "0");
+                std::cout << std::endl;
+
                 // Ask for output directory
                 outputDir = Input::getString("Output directory");
                 std::cout << std::endl;
@@ -363,6 +608,9 @@ bool choice() {
                 try {
                     EncodeJobBuilder builder;
                     builder.inputDir(inputDir).outputDir(outputDir).outputFilename(outputFilename).inputPattern(inputPattern).framerate(framerate);
+                    if (decodeWorkers > 0) {
+                        builder.decodeWorkers(decodeWorkers);
+                    }
                     
                     // Format configuration
                     switch (formatChoice) {
@@ -466,8 +714,7 @@ bool choice() {
         case 3: {
             try {
                 std::string inputFile, outputFile;
-                int codecChoice, qualityChoice;
-                std::string presetChoice;
+                int codecChoice;
 
                 printHeader("RE-ENCODE A FILE");
                 std::cout << std::endl;
@@ -478,111 +725,24 @@ bool choice() {
                 std::cout << std::endl;
                 
                 // Codec choice menu
-                std::cout << Colors::LAVENDER << Colors::BOLD << ":: Choose a codec ::" << Colors::RESET << std::endl;
-                printSeparator();
-                
-                std::cout << Colors::MAUVE << "  1." << Colors::TEXT << " X264 " << Colors::SUBTEXT << "- Universal, good compatibility" << Colors::RESET << std::endl;
-                std::cout << Colors::MAUVE << "  2." << Colors::TEXT << " X265 " << Colors::SUBTEXT << "- Better compression, superior quality" << Colors::RESET << std::endl;
-                std::cout << Colors::MAUVE << "  3." << Colors::TEXT << " AV1 " << Colors::SUBTEXT << "- Max compression for web" << Colors::RESET << std::endl;
-                std::cout << Colors::MAUVE << "  4." << Colors::TEXT << " H264_NVENC " << Colors::SUBTEXT << "- Hardware H.264 (NVIDIA)" << Colors::RESET << std::endl;
-                std::cout << Colors::MAUVE << "  5." << Colors::TEXT << " H265_NVENC " << Colors::SUBTEXT << "- Hardware H.265 (NVIDIA)" << Colors::RESET << std::endl;
-                std::cout << Colors::MAUVE << "  6." << Colors::TEXT << " ProRes " << Colors::SUBTEXT << "- Apple ProRes 4444 (Production)" << Colors::RESET << std::endl;
-                std::cout << Colors::MAUVE << "  7." << Colors::TEXT << " FFV1 " << Colors::SUBTEXT << "- Lossless codec for archiving" << Colors::RESET << std::endl;
-                std::cout << Colors::MAUVE << "  8." << Colors::TEXT << " YouTube Preset " << Colors::SUBTEXT << "- H.264, optimal quality" << Colors::RESET << std::endl;
-                
-                printSeparator();
-                codecChoice = Input::getIntRange("Your choice", 1, 8);
-                std::cout << std::endl;
+                codecChoice = promptReencodeCodec();
                 
                 try {
                     ReencodeJobBuilder builder;
                     builder.input(inputFile).output(outputFile);
                     
                     // Configuration according to choice
-                    switch (codecChoice) {
-                        case 1: { // Custom X264
-                            std::cout << Colors::SAPPHIRE << Colors::BOLD << ":: X264 Configuration" << Colors::RESET << std::endl;
-                            qualityChoice = promptQuality("CRF", "(18=excellent, 23=good, 28=acceptable)");
-                            presetChoice = promptPreset("(ultrafast/fast/medium/slow/veryslow)");
-                            
-                            builder.x264().crf(qualityChoice).preset(presetChoice).copyAudio();
-                            std::cout << Colors::GREEN << "[OK] X264 configured" << Colors::RESET << std::endl;
-                            break;
-                        }
-                        
-                        case 2: { // Custom X265
-                            std::cout << Colors::SAPPHIRE << Colors::BOLD << ":: X265 Configuration" << Colors::RESET << std::endl;
-                            qualityChoice = promptQuality("CRF", "(18=excellent, 23=good, 28=acceptable)");
-                            presetChoice = promptPreset("(ultrafast/fast/medium/slow/veryslow)");
-                            
-                            builder.x265().crf(qualityChoice).preset(presetChoice).tenBit().copyAudio();
-                            std::cout << Colors::GREEN << "[OK] X265 configured (10-bit)" << Colors::RESET << std::endl;
-                            break;
-                        }
-                        
-                        case 3: { // AV1
-                            std::cout << Colors::SAPPHIRE << Colors::BOLD << ":: AV1 Configuration" << Colors::RESET << std::endl;
-                            qualityChoice = promptQuality("CRF", "(20=excellent, 30=good, 35=acceptable)");
-                            
-                            builder.svtav1().crf(qualityChoice).preset("5").copyAudio();
-                            std::cout << Colors::GREEN << "[OK] AV1 configured (SVT-AV1)" << Colors::RESET << std::endl;
-                            break;
-                        }
-
-                        case 4: { // H264 NVENC
-                            std::cout << Colors::SAPPHIRE << Colors::BOLD << ":: H264_NVENC Configuration" << Colors::RESET << std::endl;
-                            qualityChoice = promptQuality("QP", "(17=excellent, 22=good, 27=acceptable)");
-                            presetChoice = promptPreset("(p1/p2/p3/p4/p5/p6/p7)");
-
-                            builder.h264_nvenc().qp(qualityChoice).preset(presetChoice).pixelFormat(FFmpegMulti::Encode::PixelFormat::P010).copyAudio();
-                            std::cout << Colors::GREEN << "[OK] H264_NVENC configured (Hardware)" << Colors::RESET << std::endl;
-                            break;
-                        }
-
-                        case 5: { // H265 NVENC
-                            std::cout << Colors::SAPPHIRE << Colors::BOLD << ":: H265_NVENC Configuration" << Colors::RESET << std::endl;
-                            qualityChoice = promptQuality("QP", "(17=excellent, 22=good, 27=acceptable)");
-                            presetChoice = promptPreset("(p1/p2/p3/p4/p5/p6/p7)");
-
-                            builder.h265_nvenc().qp(qualityChoice).preset(presetChoice).pixelFormat(FFmpegMulti::Encode::PixelFormat::P010).tune("hq").copyAudio();
-                            std::cout << Colors::GREEN << "[OK] H265_NVENC configured (Hardware, HQ)" << Colors::RESET << std::endl;
-                            break;
-                        }
-
-                        case 6: { // ProRes
-                            int profileChoice;
-                            std::cout << Colors::SAPPHIRE << Colors::BOLD << ":: ProRes Profile" << Colors::RESET << std::endl;
-                            std::cout << Colors::MAUVE << "  0." << Colors::TEXT << " Proxy " << Colors::SUBTEXT << "- Low quality, reduced size" << Colors::RESET << std::endl;
-                            std::cout << Colors::MAUVE << "  1." << Colors::TEXT << " LT " << Colors::SUBTEXT << "- Light, medium quality" << Colors::RESET << std::endl;
-                            std::cout << Colors::MAUVE << "  2." << Colors::TEXT << " Standard " << Colors::SUBTEXT << "- Good quality" << Colors::RESET << std::endl;
-                            std::cout << Colors::MAUVE << "  3." << Colors::TEXT << " HQ " << Colors::SUBTEXT << "- High Quality, excellent quality" << Colors::RESET << std::endl;
-                            std::cout << Colors::MAUVE << "  4." << Colors::TEXT << " 4444 " << Colors::SUBTEXT << "- Max quality with alpha" << Colors::RESET << std::endl;
-                            std::cout << Colors::MAUVE << "  5." << Colors::TEXT << " 4444 XQ " << Colors::SUBTEXT << "- Extreme quality" << Colors::RESET << std::endl;
-                            
-                            profileChoice = Input::getIntRange("Your choice", 0, 5);
-                            
-                            builder.prores().proresProfile(profileChoice).copyAudio().container("mov");
-                            
-                            std::cout << Colors::GREEN << "[OK] ProRes configured (Profile " << profileChoice << ")" << Colors::RESET << std::endl;
-                            break;
-                        }
-                        
-                        case 7: { // FFV1
-                            builder.ffv1Preset();
-                            std::cout << Colors::GREEN << "[OK] FFV1 configured (Lossless, Level 3)" << Colors::RESET << std::endl;
-                            break;
-                        }
-                        
-                        case 8: { // YouTube Preset
-                            builder.youtubePreset();
-                            std::cout << Colors::GREEN << "[OK] YouTube Preset applied (H.264, CRF 23, medium)" << Colors::RESET << std::endl;
+                    configureReencodeCodec(builder, codecChoice);
+                    
+                    // The job refuses to replace an existing file unless told to
+                    if (std::filesystem::exists(outputFile)) {
+                        std::cout << std::endl;
+                        if (!Input::getConfirm(outputFile + " already exists, overwrite it?")) {
+                            std::cout << std::endl;
+                            std::cout << Colors::YELLOW << "[INFO] Operation cancelled." << Colors::RESET << std::endl;
                             break;
                         }
-                        
-                        default:
-                            std::cout << Colors::YELLOW << "[WARN] Invalid choice, using default YouTube preset" << Colors::RESET << std::endl;
-                            builder.youtubePreset();
-                            break;
+                        builder.overwrite();
                     }
                     
                     // Build the job
@@ -761,6 +921,7 @@ bool choice() {
                         std::cout << Colors::BLUE << Colors::BOLD << ">>> Starting extraction..." << Colors::RESET << std::endl;
                         printSeparator();
                         
+                        job.setProgressCallback(printProgress);
                         bool success = job.execute();
                         
                         printSeparator();
@@ -930,6 +1091,198 @@ bool choice() {
             break;
         }
         
+        case 8: {
+            try {
+                std::string inputDir, outputDir;
+                int codecChoice, parallelJobs, retries;
+                
+                printHeader("BATCH RE-ENCODE");
+                std::cout << std::endl;
+                
+                // Ask for input and output directories
+                inputDir = Input::getString("Input directory");
+                std::cout << std::endl;
+                
+                outputDir = Input::getString("Output directory");
+                std::cout << std::endl;
+                
+                // Codec choice menu (shared with single re-encode)
+                codecChoice = promptReencodeCodec();
+                
+                try {
+                    ReencodeJobBuilder builder;
+                    configureReencodeCodec(builder, codecChoice);
+                    std::cout << std::endl;
+                    
+                    std::vector<std::filesystem::path> inputs = listVideoFiles(inputDir);
+                    if (inputs.empty()) {
+                        throw std::runtime_error("No video file found in " + inputDir);
+                    }
+                    std::filesystem::create_directories(outputDir);
+                    
+                    // One job per file, all sharing the settings of the prototype
+                    ReencodeJob prototype = builder.input(inputs.front().string()).output(outputDir).build();
+                    std::string extension = Codec::CodecUtils::getContainerExtension(prototype.config().container);
+                    auto outputFor = [&outputDir, &extension](const std::filesystem::path& input) {
+                        std::filesystem::path output = std::filesystem::path(outputDir) / input.stem();
+                        output += extension;
+                        return output;
+                    };
+                    
+                    // Outputs left by an earlier run: asked once for the whole batch
+                    size_t existing = 0;
+                    for (const auto& input : inputs) {
+                        if (std::filesystem::exists(outputFor(input))) {
+                            existing++;
+                        }
+                    }
+                    bool overwrite = false;
+                    if (existing > 0) {
+                        overwrite = Input::getConfirm(std::to_string(existing) + " output file(s) already exist, overwrite them?");
+                        std::cout << std::endl;
+                        if (overwrite) {
+                            prototype = builder.overwrite().build();
+                        }
+                    }
+                    
+                    Pipeline::BatchRunner runner;
+                    for (const auto& input : inputs) {
+                        std::filesystem::path output = outputFor(input);
+                        
+                        if (std::filesystem::exists(output) && std::filesystem::equivalent(output, input)) {
+                            std::cout << Colors::YELLOW << "[WARN] Skipping " << input.filename().string() << " (output would overwrite the input)" << Colors::RESET << std::endl;
+                            continue;
+                        }
+                        if (!overwrite && std::filesystem::exists(output)) {
+                            std::cout << Colors::YELLOW << "[WARN] Skipping " << input.filename().string() << " (output already exists)" << Colors::RESET << std::endl;
+                            continue;
+                        }
+                        
+                        ReencodeJob job = prototype;
+                        job.setInputPath(input.string());
+                        job.setOutputPath(output.string());
+                        runner.add(std::make_unique<ReencodeJob>(std::move(job)), input.filename().string());
+                    }
+                    if (runner.size() == 0) {
+                        throw std::runtime_error("Nothing left to encode in " + inputDir);
+                    }
+                    
+                    // Pool size
+                    unsigned recommended = runner.recommendedConcurrency();
+                    std::cout << Colors::SAPPHIRE << ":: Operation Summary :" << Colors::RESET << std::endl;
+                    std::cout << Colors::TEAL << "  • Files     : " << Colors::TEXT << runner.size() << Colors::RESET << std::endl;
+                    std::cout << Colors::TEAL << "  • Output    : " << Colors::TEXT << outputDir << Colors::RESET << std::endl;
+                    std::cout << std::endl;
+                    
+                    parallelJobs = Input::getIntRange("Parallel jobs", 1, 64, "(recommended: " + std::to_string(recommended) + ")");
+                    retries = Input::getIntRange("Retries per file", 0, 5, "(0 = none)");
+                    
+                    Pipeline::BatchOptions& options = runner.options();
+                    options.concurrency = static_cast<unsigned>(parallelJobs);
+                    options.max_retries = retries;
+                    options.log_dir = std::filesystem::path(outputDir) / "logs";
+                    options.on_job_finished = [](const Pipeline::BatchJobResult& result, size_t done, size_t total) {
+                        const char* color = result.success ? Colors::GREEN : Colors::RED;
+                        std::cout << color << "[" << done << "/" << total << "] " << (result.success ? "Done   " : "Failed ")
+                                  << Colors::TEXT << result.name << Colors::SUBTEXT << " (" << std::fixed << std::setprecision(1)
+                                  << result.wall_seconds << " s)" << Colors::RESET << std::endl;
+                    };
+                    
+                    std::cout << std::endl;
+                    if (Input::getConfirm("Start batch?")) {
+                        std::cout << std::endl;
+                        std::cout << Colors::BLUE << Colors::BOLD << ">>> Starting batch..." << Colors::RESET << std::endl;
+                        printSeparator();
+                        
+                        Pipeline::BatchSummary summary = runner.run();
+                        ::Jobs::ProbeCache::instance().flush();
+                        
+                        printSeparator();
+                        std::cout << std::endl;
+                        printBatchSummary(summary);
+                    } else {
+                        std::cout << std::endl;
+                        std::cout << Colors::YELLOW << "[INFO] Operation cancelled." << Colors::RESET << std::endl;
+                    }
+                    
+                } catch (const std::exception& e) {
+                    handleError(e);
+                }
+            } catch (const BackException&) {
+                std::cout << Colors::YELLOW << "[INFO] Back to main menu." << Colors::RESET << std::endl;
+            }
+            break;
+        }
+        
+        case 9: {
+            try {
+                std::string inputDir, reportPath;
+                int formatChoice, parallelJobs;
+                bool recursive;
+                
+                printHeader("ANALYZE A FOLDER");
+                std::cout << std::endl;
+                
+                inputDir = Input::getString("Input directory");
+                recursive = Input::getConfirm("Include subfolders?");
+                std::cout << std::endl;
+                
+                // Report format menu
+                std::cout << Colors::BLUE << "┌────────────────────────────────────────────┐" << Colors::RESET << std::endl;
+                std::cout << Colors::BLUE << "│" << Colors::TEXT << "  Report format :                          " << Colors::BLUE << "│" << Colors::RESET << std::endl;
+                std::cout << Colors::BLUE << "├────────────────────────────────────────────┤" << Colors::RESET << std::endl;
+                std::cout << Colors::BLUE << "│  " << Colors::MAUVE << "1" << Colors::RESET << Colors::BLUE << "  │  " << Colors::TEXT << "JSON Lines (one object per file) " << Colors::BLUE << "│" << Colors::RESET << std::endl;
+                std::cout << Colors::BLUE << "│  " << Colors::MAUVE << "2" << Colors::RESET << Colors::BLUE << "  │  " << Colors::TEXT << "CSV                              " << Colors::BLUE << "│" << Colors::RESET << std::endl;
+                std::cout << Colors::BLUE << "└────────────────────────────────────────────┘" << Colors::RESET << std::endl;
+                std::cout << std::endl;
+                
+                formatChoice = Input::getIntRange("Choice", 1, 2);
+                std::string defaultReport = (std::filesystem::path(inputDir) / (formatChoice == 1 ? "probe_report.jsonl" : "probe_report.csv")).string();
+                reportPath = Input::getString("Report file", "(empty = " + defaultReport + ")", true);
+                if (reportPath.empty()) {
+                    reportPath = defaultReport;
+                }
+                
+                unsigned cores = Core::availableCores();
+                parallelJobs = Input::getIntRange("Parallel probes", 1, 256, "(recommended: " + std::to_string(cores) + ")");
+                std::cout << std::endl;
+                
+                try {
+                    Pipeline::DirectoryProbeOptions options;
+                    options.concurrency = static_cast<unsigned>(parallelJobs);
+                    options.recursive = recursive;
+                    options.format = formatChoice == 1 ? Pipeline::ProbeReportFormat::JSON_LINES : Pipeline::ProbeReportFormat::CSV;
+                    options.report_path = reportPath;
+                    options.on_file_done = [](const std::filesystem::path& file, bool ok, size_t done) {
+                        if (!ok) {
+                            std::cout << "\r" << Colors::RED << "[FAILED] " << Colors::TEXT << file.string() << Colors::RESET << std::endl;
+                        }
+                        std::cout << "\r" << Colors::TEAL << "  " << done << " file(s) analyzed" << Colors::RESET << std::flush;
+                    };
+                    
+                    std::cout << Colors::BLUE << Colors::BOLD << ">>> Scanning..." << Colors::RESET << std::endl;
+                    printSeparator();
+                    
+                    Pipeline::DirectoryProbe probe(inputDir, options);
+                    Pipeline::DirectoryProbeStats stats = probe.run();
+                    ::Jobs::ProbeCache::instance().flush();
+                    
+                    std::cout << std::endl;
+                    printSeparator();
+                    std::cout << std::endl;
+                    printProbeStats(stats);
+                    std::cout << std::endl;
+                    std::cout << Colors::GREEN << "[OK] Report written : " << Colors::TEAL << reportPath << Colors::RESET << std::endl;
+                    
+                } catch (const std::exception& e) {
+                    handleError(e);
+                }
+            } catch (const BackException&) {
+                std::cout << Colors::YELLOW << "[INFO] Back to main menu." << Colors::RESET << std::endl;
+            }
+            break;
+        }
+        
         case 0: {
             std::cout << std::endl;
             std::cout << Colors::LAVENDER << "Goodbye !" << Colors::RESET << std::endl;
@@ -0,0 +1,311 @@
+#include "../../include/core/cpu_topology.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <set>
+#include <sstream>
+#include <thread>
+
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+namespace fs = std::filesystem;
+
+namespace FFmpegMulti {
+namespace Core {
+
+namespace {
+
+#ifdef __linux__
+const char* CGROUP_ROOT = "/sys/fs/cgroup";
+const char* NODE_ROOT = "/sys/devices/system/node";
+
+std::string readFirstLine(const fs::path& path) {
+    std::ifstream file(path);
+    std::string line;
+    std::getline(file, line);
+    return line;
+}
+
+// Path of this process in the cgroup v2 hierarchy ("0::/user.slice/..."), empty without v2
+fs::path cgroupPath() {
+    std::ifstream file("/proc/self/cgroup");
+    std::string line;
+    while (std::getline(file, line)) {
+        if (line.rfind("0::", 0) == 0) {
+            return fs::path(CGROUP_ROOT) / fs::path(line.substr(3)).relative_path();
+        }
+    }
+    return {};
+}
+
+std::vector<unsigned> affinityCpus() {
+    std::vector<unsigned> cpus;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+        for (unsigned cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+            if (CPU_ISSET(cpu, &set)) {
+                cpus.push_back(cpu);
+            }
+        }
+    }
+    return cpus;
+}
+#endif
+
+} // namespace
+
+// ============================================================================
+// PARSING
+// ============================================================================
+
+std::vector<unsigned> parseCpuList(const std::string& list) {
+    std::set<unsigned> cpus;
+    std::istringstream in(list);
+    std::string range;
+    while (std::getline(in, range, ',')) {
+        range.erase(std::remove_if(range.begin(), range.end(), [](char c) { return std::isspace(static_cast<unsigned char>(c)); }), range.end());
+        if (range.empty()) {
+            continue;
+        }
+        char* end = nullptr;
+        unsigned long first = std::strtoul(range.c_str(), &end, 10);
+        unsigned long last = first;
+        if (end == range.c_str()) {
+            return {};
+        }
+        if (*end == '-') {
+            const char* start = end + 1;
+            last = std::strtoul(start, &end, 10);
+            if (end == start || last < first) {
+                return {};
+            }
+        }
+        if (*end != '\0') {
+            return {};
+        }
+        for (unsigned long cpu = first; cpu <= last; ++cpu) {
+            cpus.insert(static_cast<unsigned>(cpu));
+        }
+    }
+    return std::vector<unsigned>(cpus.begin(), cpus.end());
+}
+
+double parseCpuMax(const std::string& content) {
+    std::istringstream in(content);
+    std::string quota;
+    double period = 0.0;
+    if (!(in >> quota >> period) || quota == "max" || period <= 0.0) {
+        return 0.0;
+    }
+    char* end = nullptr;
+    double value = std::strtod(quota.c_str(), &end);
+    if (end == quota.c_str() || value <= 0.0) {
+        return 0.0;
+    }
+    return value / period;
+}
+
+// ============================================================================
+// TOPOLOGY
+// ============================================================================
+
+CpuTopology CpuTopology::detect() {
+    CpuTopology topology;
+
+#ifdef __linux__
+    std::vector<unsigned> allowed = affinityCpus();
+
+    fs::path cgroup = cgroupPath();
+    if (!cgroup.empty()) {
+        std::error_code ec;
+        if (fs::exists(cgroup / "cpuset.cpus.effective", ec)) {
+            std::vector<unsigned> cpuset = parseCpuList(readFirstLine(cgroup / "cpuset.cpus.effective"));
+            if (!cpuset.empty()) {
+                std::vector<unsigned> both;
+                std::set_intersection(allowed.begin(), allowed.end(), cpuset.begin(), cpuset.end(), std::back_inserter(both));
+                allowed = both;
+            }
+        }
+
+        // The tightest quota along the path applies
+        for (fs::path dir = cgroup; dir.string().size() >= std::string(CGROUP_ROOT).size(); dir = dir.parent_path()) {
+            double quota = parseCpuMax(readFirstLine(dir / "cpu.max"));
+            if (quota > 0.0 && (topology.quota_cores == 0.0 || quota < topology.quota_cores)) {
+                topology.quota_cores = quota;
+            }
+            if (dir == dir.parent_path()) {
+                break;
+            }
+        }
+    }
+
+    std::error_code ec;
+    for (const auto& entry : fs::directory_iterator(NODE_ROOT, ec)) {
+        std::string name = entry.path().filename().string();
+        if (name.rfind("node", 0) != 0 || name.size() == 4 || !std::isdigit(static_cast<unsigned char>(name[4]))) {
+            continue;
+        }
+        std::vector<unsigned> nodeCpus = parseCpuList(readFirstLine(entry.path() / "cpulist"));
+        NumaNode node;
+        node.id = std::atoi(name.c_str() + 4);
+        std::set_intersection(nodeCpus.begin(), nodeCpus.end(), allowed.begin(), allowed.end(), std::back_inserter(node.cpus));
+        if (!node.cpus.empty()) {
+            topology.nodes.push_back(node);
+        }
+    }
+    std::sort(topology.nodes.begin(), topology.nodes.end(), [](const NumaNode& a, const NumaNode& b) { return a.id < b.id; });
+
+    // No NUMA information (or CPUs outside every node): one node with everything allowed
+    size_t placed = 0;
+    for (const auto& node : topology.nodes) {
+        placed += node.cpus.size();
+    }
+    if (placed != allowed.size() && !allowed.empty()) {
+        topology.nodes.clear();
+        topology.nodes.push_back(NumaNode{ 0, allowed });
+    }
+#endif
+
+    if (topology.nodes.empty()) {
+        NumaNode node;
+        unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+        for (unsigned cpu = 0; cpu < cores; ++cpu) {
+            node.cpus.push_back(cpu);
+        }
+        topology.nodes.push_back(node);
+    }
+    return topology;
+}
+
+const CpuTopology& CpuTopology::system() {
+    static const CpuTopology topology = detect();
+    return topology;
+}
+
+unsigned CpuTopology::cpuCount() const {
+    size_t count = 0;
+    for (const auto& node : nodes) {
+        count += node.cpus.size();
+    }
+    return static_cast<unsigned>(std::max<size_t>(1, count));
+}
+
+unsigned CpuTopology::usableCores() const {
+    unsigned cpus = cpuCount();
+    if (quota_cores <= 0.0) {
+        return cpus;
+    }
+    // A 2.5 core quota keeps 3 threads busy most of the time
+    unsigned quota = static_cast<unsigned>(std::ceil(quota_cores - 0.01));
+    return std::max(1u, std::min(cpus, quota));
+}
+
+unsigned availableCores() {
+    return CpuTopology::system().usableCores();
+}
+
+// ============================================================================
+// PLANNING
+// ============================================================================
+
+std::vector<CpuAllocation> planAllocations(const CpuTopology& topology, unsigned slots, const CpuAllocation& within) {
+    slots = std::max(1u, slots);
+
+    std::vector<NumaNode> nodes;
+    for (const auto& node : topology.nodes) {
+        NumaNode kept{ node.id, {} };
+        if (within.cpus.empty()) {
+            kept.cpus = node.cpus;
+        } else {
+            std::set_intersection(node.cpus.begin(), node.cpus.end(), within.cpus.begin(), within.cpus.end(), std::back_inserter(kept.cpus));
+        }
+        if (!kept.cpus.empty()) {
+            nodes.push_back(kept);
+        }
+    }
+    size_t total = 0;
+    for (const auto& node : nodes) {
+        total += node.cpus.size();
+    }
+
+    unsigned budget = within.threads > 0 ? within.threads : (within.cpus.empty() ? topology.usableCores() : static_cast<unsigned>(total));
+    if (total == 0) {
+        // CPUs outside the known topology: share the thread budget only
+        std::vector<CpuAllocation> plan(slots);
+        for (auto& allocation : plan) {
+            allocation.threads = std::max(1u, budget / slots);
+            allocation.cpus = within.cpus;
+        }
+        return plan;
+    }
+
+    // CPU sets per node, then interleaved so that the first slots spread over the nodes
+    std::vector<std::vector<CpuAllocation>> perNode(nodes.size());
+    if (slots <= nodes.size()) {
+        for (size_t j = 0; j < nodes.size(); ++j) {
+            CpuAllocation& allocation = perNode[j % slots].empty() ? perNode[j % slots].emplace_back() : perNode[j % slots].front();
+            allocation.cpus.insert(allocation.cpus.end(), nodes[j].cpus.begin(), nodes[j].cpus.end());
+            allocation.numa_node = allocation.numa_node == -1 && allocation.cpus.size() == nodes[j].cpus.size() ? nodes[j].id : -1;
+        }
+    } else {
+        // One slot per node, the others go where a slot gets the most CPUs
+        std::vector<size_t> counts(nodes.size(), 1);
+        for (size_t extra = nodes.size(); extra < slots; ++extra) {
+            size_t best = 0;
+            for (size_t j = 1; j < nodes.size(); ++j) {
+                if (nodes[j].cpus.size() * counts[best] > nodes[best].cpus.size() * counts[j]) {
+                    best = j;
+                }
+            }
+            counts[best]++;
+        }
+        for (size_t j = 0; j < nodes.size(); ++j) {
+            const std::vector<unsigned>& cpus = nodes[j].cpus;
+            size_t size = cpus.size();
+            for (size_t s = 0; s < counts[j]; ++s) {
+                CpuAllocation allocation;
+                allocation.numa_node = nodes[j].id;
+                size_t begin = s * size / counts[j];
+                size_t end = (s + 1) * size / counts[j];
+                if (end == begin) {
+                    allocation.cpus.push_back(cpus[begin]); // More slots than CPUs: neighbouring slots share one
+                } else {
+                    allocation.cpus.assign(cpus.begin() + static_cast<std::ptrdiff_t>(begin), cpus.begin() + static_cast<std::ptrdiff_t>(end));
+                }
+                perNode[j].push_back(allocation);
+            }
+        }
+    }
+
+    std::vector<CpuAllocation> plan;
+    for (size_t round = 0; plan.size() < slots; ++round) {
+        for (auto& allocations : perNode) {
+            if (round < allocations.size()) {
+                plan.push_back(allocations[round]);
+            }
+        }
+    }
+    if (nodes.size() == 1) {
+        for (auto& allocation : plan) {
+            allocation.numa_node = nodes.front().id;
+        }
+    }
+
+    // Threads follow the CPU share, within the quota
+    for (auto& allocation : plan) {
+        double share = static_cast<double>(allocation.cpus.size()) / static_cast<double>(total);
+        allocation.threads = std::max(1u, static_cast<unsigned>(std::lround(budget * share)));
+    }
+    return plan;
+}
+
+} // namespace Core
+} // namespace FFmpegMulti
@@ -1,9 +1,450 @@
 #include <iostream>
 #include <sstream>
+#include <cstring>
 #include <cstdlib>
-
+#include <fstream>
+#include <algorithm>
+#include <iterator>
 #include "../../include/core/ffmpeg_process.hpp"
 
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <spawn.h>
+#include <unistd.h>
+#include <signal.h>
+#include <sys/wait.h>
+#include <sys/resource.h>
+#include <fcntl.h>
+#include <cerrno>
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+extern char** environ;
+#endif
+
+namespace {
+
+// Large reads keep the syscall count low when a child streams rawvideo on stdout
+const size_t OUTPUT_BUFFER_SIZE = 64 * 1024;
+
+#ifdef _WIN32
+// Quote one argument following the CommandLineToArgvW rules
+std::string quoteWindowsArg(const std::string& arg) {
+    if (!arg.empty() && arg.find_first_of(" \t\n\v\"") == std::string::npos) {
+        return arg;
+    }
+
+    std::string quoted = "\"";
+    size_t backslashes = 0;
+    for (char c : arg) {
+        if (c == '\\') {
+            backslashes++;
+            continue;
+        }
+        if (c == '"') {
+            quoted.append(backslashes * 2 + 1, '\\');
+        } else {
+            quoted.append(backslashes, '\\');
+        }
+        backslashes = 0;
+        quoted += c;
+    }
+    quoted.append(backslashes * 2, '\\');
+    quoted += '"';
+    return quoted;
+}
+
+double fileTimeToSeconds(const FILETIME& ft) {
+    ULARGE_INTEGER value;
+    value.LowPart = ft.dwLowDateTime;
+    value.HighPart = ft.dwHighDateTime;
+    return static_cast<double>(value.QuadPart) / 1e7; // 100 ns units
+}
+#else
+double timevalToSeconds(const struct timeval& tv) {
+    return static_cast<double>(tv.tv_sec) + static_cast<double>(tv.tv_usec) / 1e6;
+}
+
+#ifndef __linux__
+// Without pipe2(), a child spawned between pipe() and fcntl() by another thread would inherit
+// both ends: pipe creation and posix_spawn exclude each other instead
+std::mutex spawnMutex;
+#endif
+
+/**
+ * @brief Pipe whose two ends are close-on-exec from the start, so no concurrently spawned child
+ * keeps a write end open (its reader would then wait for that unrelated child to exit)
+ */
+int makePipe(int fds[2]) {
+#ifdef __linux__
+    return pipe2(fds, O_CLOEXEC);
+#else
+    std::lock_guard<std::mutex> lock(spawnMutex);
+    if (pipe(fds) != 0) {
+        return -1;
+    }
+    fcntl(fds[0], F_SETFD, FD_CLOEXEC);
+    fcntl(fds[1], F_SETFD, FD_CLOEXEC);
+    return 0;
+#endif
+}
+#endif
+
+#ifdef __linux__
+// Short enough to catch the busiest phase of an encode, long enough to stay invisible in a profile
+const std::chrono::milliseconds SAMPLE_INTERVAL(500);
+#endif
+
+} // namespace
+
+// ============================================================================
+// PROCESS RESULT
+// ============================================================================
+
+std::string ProcessResult::describe() const {
+    if (!launched) {
+        return "failed to launch" + (error.empty() ? std::string() : ": " + error);
+    }
+    if (timed_out) {
+        return "timed out";
+    }
+    if (cancelled) {
+        return "cancelled";
+    }
+    if (signal != 0) {
+        return "killed by signal " + std::to_string(signal);
+    }
+    return "exit code " + std::to_string(exit_code);
+}
+
+// ============================================================================
+// PROCESS HANDLE
+// ============================================================================
+
+ProcessResult ProcessHandle::wait() {
+    return future_.get();
+}
+
+bool ProcessHandle::wait_for(std::chrono::milliseconds timeout) {
+    return future_.wait_for(timeout) == std::future_status::ready;
+}
+
+std::shared_future<ProcessResult> ProcessHandle::result() const {
+    return future_;
+}
+
+bool ProcessHandle::running() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return !exited_;
+}
+
+void ProcessHandle::terminate(bool force) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    // Never signal a reaped child: its pid may already belong to another process
+    if (exited_) {
+        return;
+    }
+#ifdef _WIN32
+    (void)force;
+    TerminateProcess(static_cast<HANDLE>(process_), 1);
+#else
+    kill(pid_, force ? SIGKILL : SIGTERM);
+#endif
+}
+
+void ProcessHandle::cancel(std::chrono::milliseconds grace) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (exited_) {
+            return;
+        }
+        cancelled_ = true;
+    }
+
+    terminate(false);
+    if (!wait_for(grace)) {
+        terminate(true);
+    }
+}
+
+void ProcessHandle::sample(ProcessResult& usage) {
+#ifdef __linux__
+    std::string dir = "/proc/" + std::to_string(pid_);
+    ProcessSample sample;
+    bool running = false;
+
+    // The command name may hold spaces and parentheses: fields are counted from the last ')'
+    std::ifstream statFile(dir + "/stat");
+    std::string stat((std::istreambuf_iterator<char>(statFile)), std::istreambuf_iterator<char>());
+    size_t nameEnd = stat.rfind(')');
+    if (nameEnd != std::string::npos) {
+        std::istringstream in(stat.substr(nameEnd + 1));
+        std::vector<std::string> fields{ std::istream_iterator<std::string>(in), std::istream_iterator<std::string>() };
+        if (fields.size() > 21) {
+            static const double ticks = static_cast<double>(sysconf(_SC_CLK_TCK));
+            static const long pageKb = sysconf(_SC_PAGESIZE) / 1024;
+            double cpu = static_cast<double>(std::strtoull(fields[11].c_str(), nullptr, 10) + std::strtoull(fields[12].c_str(), nullptr, 10)) / ticks;
+            sample.at = std::chrono::steady_clock::now();
+            // Clock ticks are coarse: shorter intervals would report spikes that never happened
+            double elapsed = std::chrono::duration<double>(sample.at - sampled_at_).count();
+            if (sampled_at_ != std::chrono::steady_clock::time_point{} && elapsed * 2000.0 >= SAMPLE_INTERVAL.count()) {
+                sample.cores = (cpu - sampled_cpu_seconds_) / elapsed;
+                usage.peak_cores = std::max(usage.peak_cores, sample.cores);
+            }
+            sampled_cpu_seconds_ = cpu;
+            sampled_at_ = sample.at;
+            running = fields[0] != "Z";
+            sample.threads = static_cast<unsigned>(std::strtoul(fields[17].c_str(), nullptr, 10));
+            sample.rss_kb = std::strtol(fields[21].c_str(), nullptr, 10) * pageKb;
+            usage.peak_threads = std::max(usage.peak_threads, sample.threads);
+            usage.peak_rss_kb = std::max(usage.peak_rss_kb, sample.rss_kb);
+        }
+    }
+
+    // Cumulative counters: the last read wins
+    std::ifstream io(dir + "/io");
+    std::string key;
+    uint64_t value = 0;
+    while (io >> key >> value) {
+        if (key == "rchar:") {
+            usage.read_bytes = value;
+        } else if (key == "wchar:") {
+            usage.write_bytes = value;
+        } else if (key == "read_bytes:") {
+            usage.storage_read_bytes = value;
+        } else if (key == "write_bytes:") {
+            usage.storage_write_bytes = value;
+        }
+    }
+
+    // A zombie has no memory or threads left to report
+    if (sample_callback_ && running) {
+        sample.read_bytes = usage.read_bytes;
+        sample.write_bytes = usage.write_bytes;
+        sample_callback_(sample);
+    }
+#else
+    (void)usage;
+#endif
+}
+
+void ProcessHandle::sampleUntilExit() {
+#ifdef __linux__
+    // Holding the mutex keeps the pid valid: reap() sets exited_ under it before reaping
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!exited_) {
+        sample(usage_);
+        sampler_cv_.wait_for(lock, SAMPLE_INTERVAL, [this] { return exited_; });
+    }
+#endif
+}
+
+void ProcessHandle::reap(bool pipeOutput) {
+    ProcessResult result;
+    result.launched = true;
+
+#ifdef _WIN32
+    HANDLE process = static_cast<HANDLE>(process_);
+
+    if (pipeOutput) {
+        HANDLE pipe = static_cast<HANDLE>(output_pipe_);
+        std::vector<char> buffer(OUTPUT_BUFFER_SIZE);
+        DWORD bytesRead = 0;
+        while (ReadFile(pipe, buffer.data(), static_cast<DWORD>(buffer.size()), &bytesRead, NULL) && bytesRead > 0) {
+            if (output_callback_) {
+                output_callback_(buffer.data(), bytesRead);
+            } else {
+                result.output.append(buffer.data(), bytesRead);
+            }
+        }
+        CloseHandle(pipe);
+    }
+
+    WaitForSingleObject(process, INFINITE);
+
+    DWORD exitCode = 0;
+    GetExitCodeProcess(process, &exitCode);
+    result.exit_code = static_cast<int>(exitCode);
+
+    FILETIME creationTime, exitTime, kernelTime, userTime;
+    if (GetProcessTimes(process, &creationTime, &exitTime, &kernelTime, &userTime)) {
+        result.user_cpu_seconds = fileTimeToSeconds(userTime);
+        result.system_cpu_seconds = fileTimeToSeconds(kernelTime);
+    }
+
+    IO_COUNTERS io;
+    if (GetProcessIoCounters(process, &io)) {
+        result.read_bytes = io.ReadTransferCount;
+        result.write_bytes = io.WriteTransferCount;
+    }
+    PROCESS_MEMORY_COUNTERS memory;
+    if (GetProcessMemoryInfo(process, &memory, sizeof(memory))) {
+        result.peak_rss_kb = static_cast<long>(memory.PeakWorkingSetSize / 1024);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        exited_ = true;
+        CloseHandle(process);
+        CloseHandle(static_cast<HANDLE>(thread_));
+        process_ = nullptr;
+        thread_ = nullptr;
+    }
+#else
+    if (pipeOutput) {
+        std::vector<char> buffer(OUTPUT_BUFFER_SIZE);
+        while (true) {
+            ssize_t n = read(output_fd_, buffer.data(), buffer.size());
+            if (n > 0) {
+                if (output_callback_) {
+                    output_callback_(buffer.data(), static_cast<size_t>(n));
+                } else {
+                    result.output.append(buffer.data(), static_cast<size_t>(n));
+                }
+            } else if (n < 0 && errno == EINTR) {
+                continue;
+            } else {
+                break;
+            }
+        }
+        close(output_fd_);
+        output_fd_ = -1;
+    }
+
+    // Wait for the exit without reaping, so terminate() can still signal safely until exited_ is set
+    siginfo_t info;
+    while (waitid(P_PID, static_cast<id_t>(pid_), &info, WEXITED | WNOWAIT) < 0 && errno == EINTR) {
+    }
+
+    int status = 0;
+    struct rusage usage;
+    std::memset(&usage, 0, sizeof(usage));
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        sample(usage_); // Last look at the exited child, its counters are final
+        exited_ = true;
+        while (wait4(pid_, &status, 0, &usage) < 0) {
+            if (errno != EINTR) {
+                result.error = std::strerror(errno);
+                break;
+            }
+        }
+    }
+
+    if (WIFEXITED(status)) {
+        result.exit_code = WEXITSTATUS(status);
+    } else if (WIFSIGNALED(status)) {
+        result.signal = WTERMSIG(status);
+    }
+    result.user_cpu_seconds = timevalToSeconds(usage.ru_utime);
+    result.system_cpu_seconds = timevalToSeconds(usage.ru_stime);
+
+    sampler_cv_.notify_all();
+    if (sampler_.joinable()) {
+        sampler_.join();
+    }
+    result.read_bytes = usage_.read_bytes;
+    result.write_bytes = usage_.write_bytes;
+    result.storage_read_bytes = usage_.storage_read_bytes;
+    result.storage_write_bytes = usage_.storage_write_bytes;
+    result.peak_threads = usage_.peak_threads;
+    result.peak_cores = usage_.peak_cores;
+#ifdef __APPLE__
+    long maxRssKb = usage.ru_maxrss / 1024; // Bytes on macOS
+#else
+    long maxRssKb = usage.ru_maxrss;
+#endif
+    result.peak_rss_kb = std::max(usage_.peak_rss_kb, maxRssKb);
+    result.major_faults = usage.ru_majflt;
+    result.voluntary_switches = usage.ru_nvcsw;
+    result.involuntary_switches = usage.ru_nivcsw;
+#endif
+
+    // Deliver the final progress event before the result becomes visible
+    if (progress_reader_.joinable()) {
+        progress_reader_.join();
+    }
+
+    result.wall_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_).count();
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        result.cancelled = cancelled_;
+        result.timed_out = timed_out_;
+    }
+    promise_.set_value(std::move(result));
+}
+
+// ============================================================================
+// INPUT PIPE
+// ============================================================================
+
+InputPipe::~InputPipe() {
+    close();
+}
+
+bool InputPipe::write(const char* data, size_t size) {
+#ifdef _WIN32
+    while (pipe_ && size > 0) {
+        DWORD written = 0;
+        if (!WriteFile(static_cast<HANDLE>(pipe_), data, static_cast<DWORD>(std::min<size_t>(size, 1u << 30)), &written, NULL)) {
+            return false;
+        }
+        data += written;
+        size -= written;
+    }
+    return pipe_ != nullptr;
+#else
+#ifdef __linux__
+    // A child that exits early would kill this process with SIGPIPE: blocked here, then discarded
+    sigset_t pipeSignal, previous;
+    sigemptyset(&pipeSignal);
+    sigaddset(&pipeSignal, SIGPIPE);
+    pthread_sigmask(SIG_BLOCK, &pipeSignal, &previous);
+#endif
+    bool ok = fd_ >= 0;
+    while (ok && size > 0) {
+        ssize_t n = ::write(fd_, data, size);
+        if (n > 0) {
+            data += n;
+            size -= static_cast<size_t>(n);
+        } else if (n < 0 && errno == EINTR) {
+            continue;
+        } else {
+            ok = false;
+        }
+    }
+#ifdef __linux__
+    if (!ok && errno == EPIPE) {
+        struct timespec noWait = { 0, 0 };
+        sigtimedwait(&pipeSignal, nullptr, &noWait);
+    }
+    pthread_sigmask(SIG_SETMASK, &previous, nullptr);
+#endif
+    return ok;
+#endif
+}
+
+void InputPipe::close() {
+#ifdef _WIN32
+    if (pipe_) {
+        CloseHandle(static_cast<HANDLE>(pipe_));
+        pipe_ = nullptr;
+    }
+#else
+    if (fd_ >= 0) {
+        ::close(fd_);
+        fd_ = -1;
+    }
+#endif
+}
+
+// ============================================================================
+// FFMPEG PROCESS
+// ============================================================================
+
 ffmpegProcess::ffmpegProcess(const std::filesystem::path& ExecutablePath_init, const std::vector<std::string>& args_init) :  ExecutablePath{ExecutablePath_init}, args{args_init} {}
 
 std::filesystem::path ffmpegProcess::getExecutablePath() {
@@ -14,10 +455,43 @@ std::vector<std::string> ffmpegProcess::getArgs() {
     return args;
 }
 
-bool ffmpegProcess::execute() {
+void ffmpegProcess::setCaptureOutput(bool enabled) {
+    captureOutput = enabled;
+}
+
+void ffmpegProcess::setOutputCallback(OutputCallback callback) {
+    outputCallback = std::move(callback);
+}
+
+void ffmpegProcess::setSampleCallback(SampleCallback callback) {
+    sampleCallback = std::move(callback);
+}
+
+void ffmpegProcess::setEcho(bool enabled) {
+    echo = enabled;
+}
+
+void ffmpegProcess::setProgressCallback(FFmpegMulti::Core::ProgressCallback callback, double duration_seconds) {
+    progressCallback = std::move(callback);
+    progressDuration = duration_seconds;
+}
+
+void ffmpegProcess::setTimeout(std::chrono::milliseconds value) {
+    timeout = value;
+}
+
+void ffmpegProcess::setLogFile(const std::filesystem::path& path) {
+    logFile = path;
+}
+
+void ffmpegProcess::setCpuAffinity(const std::vector<unsigned>& cpus) {
+    cpuAffinity = cpus;
+}
+
+std::string ffmpegProcess::getCommandString() const {
     std::ostringstream command;
     command << ExecutablePath.string();
-    
+
     for (const auto& arg : args) {
         command << " ";
         if (arg.find(' ') != std::string::npos) {
@@ -26,11 +500,422 @@ bool ffmpegProcess::execute() {
             command << arg;
         }
     }
-    
-    std::string cmd = command.str();
-    std::cout << "\n[EXECUTE] " << cmd << "\n" << std::endl;
 
-    int result = std::system(cmd.c_str());
-    
-    return result == 0;
+    return command.str();
+}
+
+std::shared_ptr<ProcessHandle> ffmpegProcess::start() {
+    if (echo) {
+        std::cout << "\n[EXECUTE] " << getCommandString() << "\n" << std::endl;
+    }
+
+    std::shared_ptr<ProcessHandle> handle(new ProcessHandle());
+    handle->future_ = handle->promise_.get_future().share();
+    handle->start_ = std::chrono::steady_clock::now();
+
+    auto failed = [&handle](const std::string& error) {
+        ProcessResult result;
+        result.error = error;
+        handle->exited_ = true;
+        handle->promise_.set_value(result);
+        return handle;
+    };
+
+    // stdout is piped to the parent to be captured or streamed to the output callback,
+    // unless startPipeline() connects it to another process
+#ifdef _WIN32
+    bool stdoutConnected = stdoutPipe != nullptr;
+    bool stdinConnected = stdinPipe != nullptr;
+#else
+    bool stdoutConnected = stdoutFd >= 0;
+    bool stdinConnected = stdinFd >= 0;
+#endif
+    bool pipeOutput = (captureOutput || static_cast<bool>(outputCallback)) && !stdoutConnected;
+    handle->output_callback_ = outputCallback;
+    handle->sample_callback_ = sampleCallback;
+
+    bool logging = !logFile.empty();
+    if (logging) {
+        std::ofstream header(logFile, std::ios::app);
+        if (!header) {
+            return failed("cannot open log file " + logFile.string());
+        }
+        header << "[EXECUTE] " << getCommandString() << "\n" << std::endl;
+    }
+
+#ifdef _WIN32
+    // Windows has no extra inheritable descriptor: progress goes through stdout
+    bool trackProgress = static_cast<bool>(progressCallback) && !pipeOutput && !stdoutConnected;
+    bool usePipe = pipeOutput || trackProgress;
+
+    std::string cmdLine = quoteWindowsArg(ExecutablePath.string());
+    if (trackProgress) {
+        cmdLine += " -progress pipe:1 -nostats";
+    }
+    for (const auto& arg : args) {
+        cmdLine += " " + quoteWindowsArg(arg);
+    }
+
+    HANDLE hReadPipe = NULL, hWritePipe = NULL;
+    HANDLE hLog = NULL, hNull = NULL;
+    STARTUPINFOA si = { 0 };
+    si.cb = sizeof(STARTUPINFOA);
+    SECURITY_ATTRIBUTES sa = { sizeof(SECURITY_ATTRIBUTES), NULL, TRUE };
+
+    if (logging) {
+        hLog = CreateFileA(logFile.string().c_str(), FILE_APPEND_DATA, FILE_SHARE_READ | FILE_SHARE_WRITE, &sa, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+        if (hLog == INVALID_HANDLE_VALUE) {
+            return failed("cannot open log file " + logFile.string());
+        }
+        hNull = CreateFileA("NUL", GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, &sa, OPEN_EXISTING, 0, NULL);
+    }
+
+    if (usePipe) {
+        if (!CreatePipe(&hReadPipe, &hWritePipe, &sa, 0)) {
+            if (logging) {
+                CloseHandle(hLog);
+                CloseHandle(hNull);
+            }
+            return failed("cannot create pipe");
+        }
+        SetHandleInformation(hReadPipe, HANDLE_FLAG_INHERIT, 0);
+    }
+
+    bool redirect = usePipe || logging || stdinConnected || stdoutConnected;
+    if (redirect) {
+        si.dwFlags = STARTF_USESTDHANDLES;
+        si.hStdInput = stdinConnected ? static_cast<HANDLE>(stdinPipe) : (logging ? hNull : GetStdHandle(STD_INPUT_HANDLE));
+        si.hStdOutput = stdoutConnected ? static_cast<HANDLE>(stdoutPipe)
+            : (usePipe ? hWritePipe : (logging ? hLog : GetStdHandle(STD_OUTPUT_HANDLE)));
+        si.hStdError = logging ? hLog : GetStdHandle(STD_ERROR_HANDLE);
+    }
+
+    // Pinned before its first instruction: created suspended, resumed once the mask is set
+    DWORD_PTR affinityMask = 0;
+    for (unsigned cpu : cpuAffinity) {
+        if (cpu < 64) {
+            affinityMask |= static_cast<DWORD_PTR>(1) << cpu;
+        }
+    }
+
+    PROCESS_INFORMATION pi = { 0 };
+    BOOL created = CreateProcessA(NULL, &cmdLine[0], NULL, NULL, redirect ? TRUE : FALSE, affinityMask ? CREATE_SUSPENDED : 0, NULL, NULL, &si, &pi);
+    DWORD createError = GetLastError();
+    if (created && affinityMask) {
+        SetProcessAffinityMask(pi.hProcess, affinityMask);
+        ResumeThread(pi.hThread);
+    }
+
+    if (usePipe) {
+        CloseHandle(hWritePipe);
+    }
+    if (logging) {
+        CloseHandle(hLog);
+        CloseHandle(hNull);
+    }
+
+    if (!created) {
+        if (usePipe) {
+            CloseHandle(hReadPipe);
+        }
+        return failed("CreateProcess error " + std::to_string(createError));
+    }
+
+    handle->process_ = pi.hProcess;
+    handle->thread_ = pi.hThread;
+
+    if (trackProgress) {
+        FFmpegMulti::Core::ProgressCallback callback = progressCallback;
+        double duration = progressDuration;
+        handle->progress_reader_ = std::thread([hReadPipe, callback, duration]() {
+            FFmpegMulti::Core::ProgressParser parser(duration);
+            char buffer[4096];
+            DWORD bytesRead = 0;
+            while (ReadFile(hReadPipe, buffer, sizeof(buffer), &bytesRead, NULL) && bytesRead > 0) {
+                parser.feed(buffer, bytesRead, callback);
+            }
+            CloseHandle(hReadPipe);
+        });
+    } else {
+        handle->output_pipe_ = hReadPipe;
+    }
+#else
+    const int PROGRESS_FD = 3;
+    bool trackProgress = static_cast<bool>(progressCallback);
+
+    std::string exe = ExecutablePath.string();
+    std::vector<std::string> launchArgs;
+    if (trackProgress) {
+        launchArgs = { "-progress", "pipe:" + std::to_string(PROGRESS_FD), "-nostats" };
+    }
+    launchArgs.insert(launchArgs.end(), args.begin(), args.end());
+
+    std::vector<char*> argv;
+    argv.reserve(launchArgs.size() + 2);
+    argv.push_back(const_cast<char*>(exe.c_str()));
+    for (auto& arg : launchArgs) {
+        argv.push_back(const_cast<char*>(arg.c_str()));
+    }
+    argv.push_back(nullptr);
+
+    int pipeFds[2] = { -1, -1 };
+    int progressFds[2] = { -1, -1 };
+    posix_spawn_file_actions_t actions;
+    posix_spawn_file_actions_init(&actions);
+
+    if (pipeOutput) {
+        if (makePipe(pipeFds) != 0) {
+            posix_spawn_file_actions_destroy(&actions);
+            return failed(std::strerror(errno));
+        }
+        posix_spawn_file_actions_adddup2(&actions, pipeFds[1], STDOUT_FILENO);
+        posix_spawn_file_actions_addclose(&actions, pipeFds[0]);
+        posix_spawn_file_actions_addclose(&actions, pipeFds[1]);
+    }
+
+    if (trackProgress) {
+        if (makePipe(progressFds) != 0) {
+            posix_spawn_file_actions_destroy(&actions);
+            if (pipeOutput) {
+                close(pipeFds[0]);
+                close(pipeFds[1]);
+            }
+            return failed(std::strerror(errno));
+        }
+        // Move the write end above the target descriptor so dup2 never becomes a no-op
+        int writeFd = fcntl(progressFds[1], F_DUPFD_CLOEXEC, 10);
+        close(progressFds[1]);
+        progressFds[1] = writeFd;
+        posix_spawn_file_actions_adddup2(&actions, progressFds[1], PROGRESS_FD);
+    }
+
+    if (stdinConnected) {
+        posix_spawn_file_actions_adddup2(&actions, stdinFd, STDIN_FILENO);
+    }
+    if (stdoutConnected) {
+        posix_spawn_file_actions_adddup2(&actions, stdoutFd, STDOUT_FILENO);
+    }
+
+    if (logging) {
+        // Opened in the child only, so a failure shows up as a spawn error
+        if (!stdinConnected) {
+            posix_spawn_file_actions_addopen(&actions, STDIN_FILENO, "/dev/null", O_RDONLY, 0);
+        }
+        posix_spawn_file_actions_addopen(&actions, STDERR_FILENO, logFile.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+        if (!pipeOutput && !stdoutConnected) {
+            posix_spawn_file_actions_adddup2(&actions, STDERR_FILENO, STDOUT_FILENO);
+        }
+    }
+
+#ifdef __linux__
+    // The child inherits the affinity of the spawning thread: narrowed for the spawn only
+    cpu_set_t previousAffinity;
+    bool pinned = false;
+    if (!cpuAffinity.empty() && sched_getaffinity(0, sizeof(previousAffinity), &previousAffinity) == 0) {
+        cpu_set_t affinity;
+        CPU_ZERO(&affinity);
+        for (unsigned cpu : cpuAffinity) {
+            if (cpu < CPU_SETSIZE) {
+                CPU_SET(cpu, &affinity);
+            }
+        }
+        pinned = sched_setaffinity(0, sizeof(affinity), &affinity) == 0;
+    }
+#endif
+
+    // A bare name ("mkvmerge") is looked up in PATH, a path is used as-is
+    pid_t pid = 0;
+    int spawnError = 0;
+    {
+#ifndef __linux__
+        std::lock_guard<std::mutex> lock(spawnMutex);
+#endif
+        spawnError = ExecutablePath.has_parent_path()
+            ? posix_spawn(&pid, exe.c_str(), &actions, nullptr, argv.data(), environ)
+            : posix_spawnp(&pid, exe.c_str(), &actions, nullptr, argv.data(), environ);
+    }
+    posix_spawn_file_actions_destroy(&actions);
+
+#ifdef __linux__
+    if (pinned) {
+        sched_setaffinity(0, sizeof(previousAffinity), &previousAffinity);
+    }
+#endif
+
+    if (pipeOutput) {
+        close(pipeFds[1]);
+    }
+    if (trackProgress) {
+        close(progressFds[1]);
+    }
+
+    if (spawnError != 0) {
+        if (pipeOutput) {
+            close(pipeFds[0]);
+        }
+        if (trackProgress) {
+            close(progressFds[0]);
+        }
+        return failed(std::strerror(spawnError));
+    }
+
+    handle->pid_ = pid;
+    handle->output_fd_ = pipeFds[0];
+
+    if (trackProgress) {
+        int readFd = progressFds[0];
+        FFmpegMulti::Core::ProgressCallback callback = progressCallback;
+        double duration = progressDuration;
+        handle->progress_reader_ = std::thread([readFd, callback, duration]() {
+            FFmpegMulti::Core::ProgressParser parser(duration);
+            char buffer[4096];
+            while (true) {
+                ssize_t n = read(readFd, buffer, sizeof(buffer));
+                if (n > 0) {
+                    parser.feed(buffer, static_cast<size_t>(n), callback);
+                } else if (n < 0 && errno == EINTR) {
+                    continue;
+                } else {
+                    break;
+                }
+            }
+            close(readFd);
+        });
+    }
+#endif
+
+#ifdef __linux__
+    // Joined by the reaper, which keeps the handle alive meanwhile
+    handle->sampler_ = std::thread(&ProcessHandle::sampleUntilExit, handle.get());
+#endif
+
+    // The reaper thread keeps the handle alive until the child has exited
+    std::thread([handle, pipeOutput]() { handle->reap(pipeOutput); }).detach();
+
+    return handle;
+}
+
+std::pair<std::shared_ptr<ProcessHandle>, std::shared_ptr<ProcessHandle>> ffmpegProcess::startPipeline(ffmpegProcess& producer, ffmpegProcess& consumer) {
+    auto failed = [](const std::string& error) {
+        std::shared_ptr<ProcessHandle> handle(new ProcessHandle());
+        handle->future_ = handle->promise_.get_future().share();
+        ProcessResult result;
+        result.error = error;
+        handle->exited_ = true;
+        handle->promise_.set_value(result);
+        return handle;
+    };
+
+    std::shared_ptr<ProcessHandle> consumerHandle;
+    std::shared_ptr<ProcessHandle> producerHandle;
+
+#ifdef _WIN32
+    SECURITY_ATTRIBUTES sa = { sizeof(SECURITY_ATTRIBUTES), NULL, TRUE };
+    HANDLE readPipe = NULL, writePipe = NULL;
+    if (!CreatePipe(&readPipe, &writePipe, &sa, 0)) {
+        std::string error = "cannot create pipe";
+        return { failed(error), failed(error) };
+    }
+
+    // Each child inherits its own end only, or the consumer would never see the end of the input
+    SetHandleInformation(writePipe, HANDLE_FLAG_INHERIT, 0);
+    consumer.stdinPipe = readPipe;
+    consumerHandle = consumer.start();
+    consumer.stdinPipe = nullptr;
+
+    SetHandleInformation(readPipe, HANDLE_FLAG_INHERIT, 0);
+    SetHandleInformation(writePipe, HANDLE_FLAG_INHERIT, HANDLE_FLAG_INHERIT);
+    producer.stdoutPipe = writePipe;
+    producerHandle = producer.start();
+    producer.stdoutPipe = nullptr;
+
+    CloseHandle(readPipe);
+    CloseHandle(writePipe);
+#else
+    int fds[2] = { -1, -1 };
+    // Both ends stay out of every other child, each process gets its end through dup2
+    if (makePipe(fds) != 0) {
+        std::string error = std::strerror(errno);
+        return { failed(error), failed(error) };
+    }
+
+    consumer.stdinFd = fds[0];
+    consumerHandle = consumer.start();
+    consumer.stdinFd = -1;
+
+    producer.stdoutFd = fds[1];
+    producerHandle = producer.start();
+    producer.stdoutFd = -1;
+
+    // The consumer gets EOF once the producer exits
+    close(fds[0]);
+    close(fds[1]);
+#endif
+
+    return { producerHandle, consumerHandle };
+}
+
+std::pair<std::shared_ptr<ProcessHandle>, std::unique_ptr<InputPipe>> ffmpegProcess::startWithInput() {
+    auto failed = [](const std::string& error) {
+        std::shared_ptr<ProcessHandle> handle(new ProcessHandle());
+        handle->future_ = handle->promise_.get_future().share();
+        ProcessResult result;
+        result.error = error;
+        handle->exited_ = true;
+        handle->promise_.set_value(result);
+        return handle;
+    };
+
+    // If the launch fails, the read end is closed with no reader: writes fail, nothing blocks
+    std::unique_ptr<InputPipe> input(new InputPipe());
+    std::shared_ptr<ProcessHandle> handle;
+#ifdef _WIN32
+    SECURITY_ATTRIBUTES sa = { sizeof(SECURITY_ATTRIBUTES), NULL, TRUE };
+    HANDLE readPipe = NULL, writePipe = NULL;
+    if (!CreatePipe(&readPipe, &writePipe, &sa, 0)) {
+        return { failed("cannot create pipe"), nullptr };
+    }
+    SetHandleInformation(writePipe, HANDLE_FLAG_INHERIT, 0);
+    stdinPipe = readPipe;
+    handle = start();
+    stdinPipe = nullptr;
+    CloseHandle(readPipe);
+    input->pipe_ = writePipe;
+#else
+    int fds[2] = { -1, -1 };
+    if (makePipe(fds) != 0) {
+        return { failed(std::strerror(errno)), nullptr };
+    }
+#ifdef __linux__
+    // Raw frames are large: a bigger pipe means fewer wake-ups (best effort, capped by pipe-max-size)
+    fcntl(fds[1], F_SETPIPE_SZ, 1024 * 1024);
+#endif
+#ifdef __APPLE__
+    fcntl(fds[1], F_SETNOSIGPIPE, 1);
+#endif
+    stdinFd = fds[0];
+    handle = start();
+    stdinFd = -1;
+    close(fds[0]);
+    input->fd_ = fds[1];
+#endif
+    return { handle, std::move(input) };
+}
+
+ProcessResult ffmpegProcess::run() {
+    std::shared_ptr<ProcessHandle> handle = start();
+
+    if (timeout.count() > 0 && !handle->wait_for(timeout)) {
+        {
+            std::lock_guard<std::mutex> lock(handle->mutex_);
+            handle->timed_out_ = true;
+        }
+        handle->cancel();
+    }
+
+    return handle->wait();
+}
+
+bool ffmpegProcess::execute() {
+    return run().success();
 }
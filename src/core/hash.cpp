@@ -0,0 +1,94 @@
+#include "../../include/core/hash.hpp"
+
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <vector>
+
+namespace FFmpegMulti {
+namespace Hash {
+
+// ============================================================================
+// HASHER
+// ============================================================================
+
+void Hasher::update(const void* data, size_t size) {
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    length_ += size;
+
+    // Complete a word started by the previous call
+    while (pending_size_ > 0 && pending_size_ < 8 && size > 0) {
+        pending_[pending_size_++] = *bytes++;
+        size--;
+    }
+    if (pending_size_ == 8) {
+        mix(pending_);
+        pending_size_ = 0;
+    }
+    for (; size >= 8; bytes += 8, size -= 8) {
+        mix(bytes);
+    }
+    std::memcpy(pending_ + pending_size_, bytes, size);
+    pending_size_ += size;
+}
+
+std::string Hasher::hex() const {
+    Hasher last = *this;
+    unsigned char tail[8] = {};
+    std::memcpy(tail, pending_, pending_size_);
+    last.mix(tail);
+
+    // Final avalanche, with the length so that trailing zero bytes count
+    uint64_t h = last.state_ ^ length_;
+    h ^= h >> 33;
+    h *= 0xFF51AFD7ED558CCDull;
+    h ^= h >> 33;
+
+    std::ostringstream out;
+    out << std::hex << std::setw(16) << std::setfill('0') << h;
+    return out.str();
+}
+
+void Hasher::mix(const unsigned char* bytes) {
+    uint64_t word;
+    std::memcpy(&word, bytes, sizeof(word));
+    state_ ^= word;
+    state_ *= 0x9E3779B97F4A7C15ull;
+    state_ ^= state_ >> 32;
+}
+
+// ============================================================================
+// HELPERS
+// ============================================================================
+
+std::string hex64(std::string_view text) {
+    Hasher hasher;
+    hasher.update(text);
+    return hasher.hex();
+}
+
+std::string fileHex64(const std::filesystem::path& path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in.is_open()) {
+        return "";
+    }
+
+    Hasher hasher;
+    std::vector<char> buffer(1 << 20);
+    while (in) {
+        in.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        std::streamsize got = in.gcount();
+        if (got <= 0) {
+            break;
+        }
+        hasher.update(buffer.data(), static_cast<size_t>(got));
+    }
+    if (in.bad()) {
+        return "";
+    }
+    return hasher.hex();
+}
+
+} // namespace Hash
+} // namespace FFmpegMulti
@@ -0,0 +1,346 @@
+#include "../../include/core/job.hpp"
+#include "../../include/core/json.hpp"
+
+#include <algorithm>
+#include <sstream>
+#include <tuple>
+
+namespace FFmpegMulti {
+namespace Core {
+
+// ============================================================================
+// CONSTRUCTORS
+// ============================================================================
+
+// Only the settings are copied: a copy starts with no running process, no metrics and is not cancelled
+Job::Job(const Job& other)
+    : timeout_(other.timeout_), progress_callback_(other.progress_callback_), log_file_(other.log_file_), cpu_allocation_(other.cpu_allocation_),
+      trace_(other.trace_), trace_track_(other.trace_track_) {}
+
+Job& Job::operator=(const Job& other) {
+    if (this != &other) {
+        timeout_ = other.timeout_;
+        progress_callback_ = other.progress_callback_;
+        log_file_ = other.log_file_;
+        cpu_allocation_ = other.cpu_allocation_;
+        trace_ = other.trace_;
+        trace_track_ = other.trace_track_;
+    }
+    return *this;
+}
+
+// ============================================================================
+// ASYNCHRONOUS EXECUTION
+// ============================================================================
+
+std::future<bool> Job::start() {
+    return std::async(std::launch::async, [this]() { return execute(); });
+}
+
+void Job::cancel(std::chrono::milliseconds grace) {
+    cancelled_ = true;
+
+    std::vector<std::shared_ptr<ProcessHandle>> running;
+    {
+        std::lock_guard<std::mutex> lock(processes_mutex_);
+        cancel_grace_ = grace;
+        running = processes_;
+    }
+
+    // Terminate all children concurrently so the grace periods overlap
+    std::vector<std::future<void>> pending;
+    for (const auto& handle : running) {
+        pending.push_back(std::async(std::launch::async, [handle, grace]() { handle->cancel(grace); }));
+    }
+    for (auto& p : pending) {
+        p.wait();
+    }
+}
+
+bool Job::isCancelled() const {
+    return cancelled_;
+}
+
+void Job::setTimeout(std::chrono::milliseconds timeout) {
+    timeout_ = timeout;
+}
+
+std::chrono::milliseconds Job::getTimeout() const {
+    return timeout_;
+}
+
+void Job::setLogFile(const std::filesystem::path& path) {
+    log_file_ = path;
+}
+
+std::filesystem::path Job::getLogFile() const {
+    return log_file_;
+}
+
+unsigned Job::threadDemand() const {
+    return 1;
+}
+
+std::string Job::encoderName() const {
+    return {};
+}
+
+void Job::setCpuAllocation(const CpuAllocation& allocation) {
+    cpu_allocation_ = allocation;
+}
+
+const CpuAllocation& Job::getCpuAllocation() const {
+    return cpu_allocation_;
+}
+
+// ============================================================================
+// METRICS
+// ============================================================================
+
+JobMetrics Job::getMetrics() const {
+    std::lock_guard<std::mutex> lock(metrics_mutex_);
+    return metrics_;
+}
+
+void Job::addMetrics(const JobMetrics& metrics) {
+    std::lock_guard<std::mutex> lock(metrics_mutex_);
+    metrics_.merge(metrics);
+}
+
+// ============================================================================
+// TRACE
+// ============================================================================
+
+void Job::setTrace(std::shared_ptr<Trace> trace, int track) {
+    trace_ = std::move(trace);
+    trace_track_ = track;
+}
+
+std::shared_ptr<Trace> Job::getTrace() const {
+    return trace_;
+}
+
+int Job::getTraceTrack() const {
+    return trace_track_;
+}
+
+Trace::Span Job::traceStep(const std::string& name) const {
+    return trace_ ? trace_->span(trace_track_, 0, name, "step") : Trace::Span();
+}
+
+int Job::traceProcess(ffmpegProcess& process) const {
+    if (!trace_) {
+        return -1;
+    }
+    int lane = trace_->acquireLane(trace_track_);
+    std::string prefix = "process " + std::to_string(lane);
+    std::shared_ptr<Trace> trace = trace_;
+    int track = trace_track_;
+    ProcessSample previous;
+    process.setSampleCallback([trace, track, prefix, previous](const ProcessSample& sample) mutable {
+        if (sample.cores >= 0.0) {
+            trace->counter(track, prefix + " CPU", sample.at, { { "cores", sample.cores } });
+        }
+        trace->counter(track, prefix + " memory", sample.at, { { "MiB", sample.rss_kb / 1024.0 } });
+        double elapsed = std::chrono::duration<double>(sample.at - previous.at).count();
+        if (previous.at != Trace::Clock::time_point{} && elapsed > 0.0) {
+            trace->counter(track, prefix + " I/O", sample.at, {
+                { "read MiB/s", (sample.read_bytes - previous.read_bytes) / 1048576.0 / elapsed },
+                { "write MiB/s", (sample.write_bytes - previous.write_bytes) / 1048576.0 / elapsed }
+            });
+        }
+        previous = sample;
+    });
+    return lane;
+}
+
+void Job::traceProcessEnd(ffmpegProcess& process, int lane, Trace::Clock::time_point start, const ProcessResult& result) const {
+    if (lane < 0) {
+        return;
+    }
+    // Processes of a pipeline end one after the other: their own wall time places the end
+    auto end = result.launched ? start + std::chrono::duration_cast<Trace::Clock::duration>(std::chrono::duration<double>(result.wall_seconds))
+                               : Trace::Clock::now();
+    std::ostringstream args;
+    args << "\"command\":" << Json::quote(process.getCommandString())
+         << ",\"status\":" << Json::quote(result.success() ? "ok" : result.describe())
+         << ",\"cpu_seconds\":" << result.user_cpu_seconds + result.system_cpu_seconds
+         << ",\"peak_rss_mib\":" << result.peak_rss_kb / 1024.0
+         << ",\"read_mib\":" << result.read_bytes / 1048576.0
+         << ",\"write_mib\":" << result.write_bytes / 1048576.0;
+    trace_->complete(trace_track_, lane, process.getExecutablePath().stem().string(), "process", start, end, args.str());
+
+    // The graphs drop to zero between two processes of the lane
+    std::string prefix = "process " + std::to_string(lane);
+    trace_->counter(trace_track_, prefix + " CPU", end, { { "cores", 0.0 } });
+    trace_->counter(trace_track_, prefix + " memory", end, { { "MiB", 0.0 } });
+    trace_->counter(trace_track_, prefix + " I/O", end, { { "read MiB/s", 0.0 }, { "write MiB/s", 0.0 } });
+    trace_->releaseLane(trace_track_, lane);
+}
+
+// ============================================================================
+// PROGRESS
+// ============================================================================
+
+void Job::setProgressCallback(ProgressCallback callback) {
+    progress_callback_ = std::move(callback);
+}
+
+ProgressCallback Job::getProgressCallback() const {
+    return progress_callback_;
+}
+
+bool Job::hasProgressCallback() const {
+    return static_cast<bool>(progress_callback_);
+}
+
+void Job::trackProgress(ffmpegProcess& process, double duration_seconds) const {
+    if (progress_callback_) {
+        process.setProgressCallback(progress_callback_, duration_seconds);
+    }
+}
+
+void Job::reportProgress(const Progress& progress) const {
+    if (progress_callback_) {
+        progress_callback_(progress);
+    }
+}
+
+// ============================================================================
+// CHILD PROCESSES
+// ============================================================================
+
+void Job::prepareProcess(ffmpegProcess& process) const {
+    if (!cpu_allocation_.cpus.empty()) {
+        process.setCpuAffinity(cpu_allocation_.cpus);
+    }
+    if (!log_file_.empty()) {
+        process.setLogFile(log_file_);
+        process.setEcho(false);
+    }
+}
+
+std::chrono::milliseconds Job::registerProcess(const std::shared_ptr<ProcessHandle>& handle) {
+    std::chrono::milliseconds grace;
+    {
+        std::lock_guard<std::mutex> lock(processes_mutex_);
+        processes_.push_back(handle);
+        grace = cancel_grace_;
+    }
+
+    // cancel() may have run between the caller's check and the registration
+    if (cancelled_) {
+        handle->cancel(grace);
+    }
+    return grace;
+}
+
+void Job::unregisterProcess(const std::shared_ptr<ProcessHandle>& handle) {
+    std::lock_guard<std::mutex> lock(processes_mutex_);
+    processes_.erase(std::remove(processes_.begin(), processes_.end(), handle), processes_.end());
+}
+
+ProcessResult Job::runProcess(ffmpegProcess& process) {
+    return runProcess(process, nullptr);
+}
+
+ProcessResult Job::runProcess(ffmpegProcess& process, const std::function<void(InputPipe& input)>& feed) {
+    if (cancelled_) {
+        ProcessResult result;
+        result.cancelled = true;
+        result.error = "job cancelled";
+        return result;
+    }
+
+    prepareProcess(process);
+    int lane = traceProcess(process);
+    auto start = Trace::Clock::now();
+    std::shared_ptr<ProcessHandle> handle;
+    std::unique_ptr<InputPipe> input;
+    if (feed) {
+        std::tie(handle, input) = process.startWithInput();
+    } else {
+        handle = process.start();
+    }
+    std::chrono::milliseconds grace = registerProcess(handle);
+
+    // While `feed` blocks on a full pipe, the timeout is watched from another thread
+    std::future<bool> watchdog;
+    if (input) {
+        if (timeout_.count() > 0) {
+            std::chrono::milliseconds timeout = timeout_;
+            watchdog = std::async(std::launch::async, [handle, timeout, grace]() {
+                if (handle->wait_for(timeout)) {
+                    return false;
+                }
+                handle->cancel(grace);
+                return true;
+            });
+        }
+        feed(*input);
+        input->close();
+    }
+
+    bool timedOut = false;
+    if (watchdog.valid()) {
+        timedOut = watchdog.get();
+    } else if (timeout_.count() > 0 && !handle->wait_for(timeout_)) {
+        timedOut = true;
+        handle->cancel(grace);
+    }
+
+    ProcessResult result = handle->wait();
+    result.timed_out = result.timed_out || timedOut;
+
+    unregisterProcess(handle);
+    traceProcessEnd(process, lane, start, result);
+    {
+        std::lock_guard<std::mutex> lock(metrics_mutex_);
+        metrics_.add(result);
+    }
+    return result;
+}
+
+std::pair<ProcessResult, ProcessResult> Job::runPipeline(ffmpegProcess& producer, ffmpegProcess& consumer) {
+    if (cancelled_) {
+        ProcessResult result;
+        result.cancelled = true;
+        result.error = "job cancelled";
+        return { result, result };
+    }
+
+    prepareProcess(producer);
+    prepareProcess(consumer);
+    int producerLane = traceProcess(producer);
+    int consumerLane = traceProcess(consumer);
+    auto start = Trace::Clock::now();
+    auto handles = ffmpegProcess::startPipeline(producer, consumer);
+    std::chrono::milliseconds grace = registerProcess(handles.first);
+    registerProcess(handles.second);
+
+    // The consumer exits last: it drains the pipe after the producer is done
+    bool timedOut = false;
+    if (timeout_.count() > 0 && !handles.second->wait_for(timeout_)) {
+        timedOut = true;
+        handles.first->cancel(grace);
+        handles.second->cancel(grace);
+    }
+
+    std::pair<ProcessResult, ProcessResult> results = { handles.first->wait(), handles.second->wait() };
+    results.first.timed_out = results.first.timed_out || timedOut;
+    results.second.timed_out = results.second.timed_out || timedOut;
+
+    unregisterProcess(handles.first);
+    unregisterProcess(handles.second);
+    traceProcessEnd(producer, producerLane, start, results.first);
+    traceProcessEnd(consumer, consumerLane, start, results.second);
+    {
+        std::lock_guard<std::mutex> lock(metrics_mutex_);
+        metrics_.add(results.first);
+        metrics_.add(results.second);
+    }
+    return results;
+}
+
+} // namespace Core
+} // namespace FFmpegMulti
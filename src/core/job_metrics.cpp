@@ -0,0 +1,72 @@
+#include "../../include/core/job_metrics.hpp"
+
+#include <algorithm>
+#include <sstream>
+
+namespace FFmpegMulti {
+namespace Core {
+
+void JobMetrics::add(const ProcessResult& result) {
+    if (!result.launched) {
+        return;
+    }
+    processes++;
+    process_seconds += result.wall_seconds;
+    user_cpu_seconds += result.user_cpu_seconds;
+    system_cpu_seconds += result.system_cpu_seconds;
+    peak_rss_kb = std::max(peak_rss_kb, result.peak_rss_kb);
+    major_faults += result.major_faults;
+    voluntary_switches += result.voluntary_switches;
+    involuntary_switches += result.involuntary_switches;
+    read_bytes += result.read_bytes;
+    write_bytes += result.write_bytes;
+    storage_read_bytes += result.storage_read_bytes;
+    storage_write_bytes += result.storage_write_bytes;
+    peak_threads = std::max(peak_threads, result.peak_threads);
+    peak_cores = std::max(peak_cores, result.peak_cores);
+}
+
+void JobMetrics::merge(const JobMetrics& other) {
+    processes += other.processes;
+    process_seconds += other.process_seconds;
+    user_cpu_seconds += other.user_cpu_seconds;
+    system_cpu_seconds += other.system_cpu_seconds;
+    peak_rss_kb = std::max(peak_rss_kb, other.peak_rss_kb);
+    major_faults += other.major_faults;
+    voluntary_switches += other.voluntary_switches;
+    involuntary_switches += other.involuntary_switches;
+    read_bytes += other.read_bytes;
+    write_bytes += other.write_bytes;
+    storage_read_bytes += other.storage_read_bytes;
+    storage_write_bytes += other.storage_write_bytes;
+    peak_threads = std::max(peak_threads, other.peak_threads);
+    peak_cores = std::max(peak_cores, other.peak_cores);
+}
+
+double JobMetrics::averageCores(double wall_seconds) const {
+    return wall_seconds > 0.0 ? cpuSeconds() / wall_seconds : 0.0;
+}
+
+std::string JobMetrics::toJson(double wall_seconds) const {
+    std::ostringstream json;
+    json.precision(6);
+    json << "{\"processes\":" << processes
+         << ",\"process_seconds\":" << process_seconds
+         << ",\"user_cpu_seconds\":" << user_cpu_seconds
+         << ",\"system_cpu_seconds\":" << system_cpu_seconds
+         << ",\"average_cores\":" << averageCores(wall_seconds)
+         << ",\"peak_cores\":" << peak_cores
+         << ",\"peak_threads\":" << peak_threads
+         << ",\"peak_rss_kb\":" << peak_rss_kb
+         << ",\"major_faults\":" << major_faults
+         << ",\"voluntary_switches\":" << voluntary_switches
+         << ",\"involuntary_switches\":" << involuntary_switches
+         << ",\"read_bytes\":" << read_bytes
+         << ",\"write_bytes\":" << write_bytes
+         << ",\"storage_read_bytes\":" << storage_read_bytes
+         << ",\"storage_write_bytes\":" << storage_write_bytes << "}";
+    return json.str();
+}
+
+} // namespace Core
+} // namespace FFmpegMulti
@@ -0,0 +1,397 @@
+#include "../../include/core/json.hpp"
+
+#include <cstdlib>
+
+namespace FFmpegMulti {
+namespace Json {
+
+namespace {
+
+const Value& nullValue() {
+    static const Value value;
+    return value;
+}
+
+void appendUtf8(std::string& out, unsigned long codepoint) {
+    if (codepoint < 0x80) {
+        out += static_cast<char>(codepoint);
+    } else if (codepoint < 0x800) {
+        out += static_cast<char>(0xC0 | (codepoint >> 6));
+        out += static_cast<char>(0x80 | (codepoint & 0x3F));
+    } else if (codepoint < 0x10000) {
+        out += static_cast<char>(0xE0 | (codepoint >> 12));
+        out += static_cast<char>(0x80 | ((codepoint >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (codepoint & 0x3F));
+    } else {
+        out += static_cast<char>(0xF0 | (codepoint >> 18));
+        out += static_cast<char>(0x80 | ((codepoint >> 12) & 0x3F));
+        out += static_cast<char>(0x80 | ((codepoint >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (codepoint & 0x3F));
+    }
+}
+
+} // namespace
+
+// ============================================================================
+// PARSE ERROR
+// ============================================================================
+
+ParseError::ParseError(const std::string& message, size_t offset)
+    : std::runtime_error("JSON parse error at offset " + std::to_string(offset) + ": " + message), offset_(offset) {}
+
+// ============================================================================
+// PARSER
+// ============================================================================
+
+/**
+ * @brief Recursive descent parser working directly on the input buffer
+ */
+class Parser {
+public:
+    explicit Parser(std::string_view text) : text_(text) {}
+
+    Value parseDocument() {
+        Value value = parseValue(0);
+        skipWhitespace();
+        if (pos_ != text_.size()) {
+            fail("unexpected trailing characters");
+        }
+        return value;
+    }
+
+private:
+    static const int MAX_DEPTH = 256;
+
+    std::string_view text_;
+    size_t pos_{0};
+
+    [[noreturn]] void fail(const std::string& message) const {
+        throw ParseError(message, pos_);
+    }
+
+    void skipWhitespace() {
+        while (pos_ < text_.size() && (text_[pos_] == ' ' || text_[pos_] == '\t' || text_[pos_] == '\n' || text_[pos_] == '\r')) {
+            pos_++;
+        }
+    }
+
+    void expect(std::string_view literal) {
+        if (text_.compare(pos_, literal.size(), literal) != 0) {
+            fail("invalid literal");
+        }
+        pos_ += literal.size();
+    }
+
+    Value parseValue(int depth) {
+        if (depth > MAX_DEPTH) {
+            fail("nesting too deep");
+        }
+
+        skipWhitespace();
+        if (pos_ >= text_.size()) {
+            fail("unexpected end of input");
+        }
+
+        Value value;
+        char c = text_[pos_];
+        switch (c) {
+            case '{':
+                parseObject(value, depth);
+                break;
+            case '[':
+                parseArray(value, depth);
+                break;
+            case '"':
+                value.type_ = Value::Type::String;
+                value.string_ = parseString();
+                break;
+            case 't':
+                expect("true");
+                value.type_ = Value::Type::Bool;
+                value.bool_ = true;
+                break;
+            case 'f':
+                expect("false");
+                value.type_ = Value::Type::Bool;
+                break;
+            case 'n':
+                expect("null");
+                break;
+            default:
+                if (c == '-' || (c >= '0' && c <= '9')) {
+                    parseNumber(value);
+                } else {
+                    fail(std::string("unexpected character '") + c + "'");
+                }
+        }
+        return value;
+    }
+
+    void parseObject(Value& value, int depth) {
+        value.type_ = Value::Type::Object;
+        pos_++; // '{'
+
+        skipWhitespace();
+        if (pos_ < text_.size() && text_[pos_] == '}') {
+            pos_++;
+            return;
+        }
+
+        while (true) {
+            skipWhitespace();
+            if (pos_ >= text_.size() || text_[pos_] != '"') {
+                fail("expected member name");
+            }
+            std::string key = parseString();
+
+            skipWhitespace();
+            if (pos_ >= text_.size() || text_[pos_] != ':') {
+                fail("expected ':'");
+            }
+            pos_++;
+
+            value.object_.emplace_back(std::move(key), parseValue(depth + 1));
+
+            skipWhitespace();
+            if (pos_ < text_.size() && text_[pos_] == ',') {
+                pos_++;
+            } else if (pos_ < text_.size() && text_[pos_] == '}') {
+                pos_++;
+                return;
+            } else {
+                fail("expected ',' or '}'");
+            }
+        }
+    }
+
+    void parseArray(Value& value, int depth) {
+        value.type_ = Value::Type::Array;
+        pos_++; // '['
+
+        skipWhitespace();
+        if (pos_ < text_.size() && text_[pos_] == ']') {
+            pos_++;
+            return;
+        }
+
+        while (true) {
+            value.array_.push_back(parseValue(depth + 1));
+
+            skipWhitespace();
+            if (pos_ < text_.size() && text_[pos_] == ',') {
+                pos_++;
+            } else if (pos_ < text_.size() && text_[pos_] == ']') {
+                pos_++;
+                return;
+            } else {
+                fail("expected ',' or ']'");
+            }
+        }
+    }
+
+    unsigned long parseHex4() {
+        if (pos_ + 4 > text_.size()) {
+            fail("truncated \\u escape");
+        }
+        unsigned long code = 0;
+        for (int i = 0; i < 4; ++i) {
+            char h = text_[pos_++];
+            code <<= 4;
+            if (h >= '0' && h <= '9') code |= static_cast<unsigned long>(h - '0');
+            else if (h >= 'a' && h <= 'f') code |= static_cast<unsigned long>(h - 'a' + 10);
+            else if (h >= 'A' && h <= 'F') code |= static_cast<unsigned long>(h - 'A' + 10);
+            else fail("invalid \\u escape");
+        }
+        return code;
+    }
+
+    std::string parseString() {
+        pos_++; // opening quote
+        std::string out;
+
+        while (true) {
+            // Copy the run of plain characters in one go
+            size_t start = pos_;
+            while (pos_ < text_.size() && text_[pos_] != '"' && text_[pos_] != '\\') {
+                pos_++;
+            }
+            out.append(text_.data() + start, pos_ - start);
+
+            if (pos_ >= text_.size()) {
+                fail("unterminated string");
+            }
+            if (text_[pos_] == '"') {
+                pos_++;
+                return out;
+            }
+
+            pos_++; // backslash
+            if (pos_ >= text_.size()) {
+                fail("unterminated escape");
+            }
+            char e = text_[pos_++];
+            switch (e) {
+                case '"': out += '"'; break;
+                case '\\': out += '\\'; break;
+                case '/': out += '/'; break;
+                case 'b': out += '\b'; break;
+                case 'f': out += '\f'; break;
+                case 'n': out += '\n'; break;
+                case 'r': out += '\r'; break;
+                case 't': out += '\t'; break;
+                case 'u': {
+                    unsigned long code = parseHex4();
+                    // Surrogate pair
+                    if (code >= 0xD800 && code <= 0xDBFF && text_.compare(pos_, 2, "\\u") == 0) {
+                        pos_ += 2;
+                        unsigned long low = parseHex4();
+                        code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+                    }
+                    appendUtf8(out, code);
+                    break;
+                }
+                default:
+                    fail("invalid escape");
+            }
+        }
+    }
+
+    void parseNumber(Value& value) {
+        size_t start = pos_;
+        while (pos_ < text_.size()) {
+            char c = text_[pos_];
+            if ((c >= '0' && c <= '9') || c == '-' || c == '+' || c == '.' || c == 'e' || c == 'E') {
+                pos_++;
+            } else {
+                break;
+            }
+        }
+
+        value.type_ = Value::Type::Number;
+        value.string_.assign(text_.data() + start, pos_ - start);
+
+        char* end = nullptr;
+        value.number_ = std::strtod(value.string_.c_str(), &end);
+        if (end != value.string_.c_str() + value.string_.size()) {
+            pos_ = start;
+            fail("invalid number");
+        }
+    }
+};
+
+// ============================================================================
+// VALUE
+// ============================================================================
+
+Value Value::parse(std::string_view text) {
+    return Parser(text).parseDocument();
+}
+
+bool Value::asBool(bool fallback) const {
+    return type_ == Type::Bool ? bool_ : fallback;
+}
+
+double Value::asNumber(double fallback) const {
+    if (type_ == Type::Number) {
+        return number_;
+    }
+    if (type_ == Type::String && !string_.empty()) {
+        char* end = nullptr;
+        double number = std::strtod(string_.c_str(), &end);
+        if (end != string_.c_str()) {
+            return number;
+        }
+    }
+    return fallback;
+}
+
+long long Value::asInt(long long fallback) const {
+    if (type_ == Type::Number || type_ == Type::String) {
+        // Integers are parsed from the text to keep full 64-bit precision
+        char* end = nullptr;
+        long long number = std::strtoll(string_.c_str(), &end, 10);
+        if (type_ == Type::Number && end != string_.c_str() + string_.size()) {
+            return static_cast<long long>(number_); // Fraction or exponent
+        }
+        if (end != string_.c_str()) {
+            return number;
+        }
+    }
+    return fallback;
+}
+
+std::string Value::asString(const std::string& fallback) const {
+    if (type_ == Type::String || type_ == Type::Number) {
+        return string_;
+    }
+    if (type_ == Type::Bool) {
+        return bool_ ? "true" : "false";
+    }
+    return fallback;
+}
+
+const Value& Value::operator[](std::string_view key) const {
+    for (const auto& member : object_) {
+        if (member.first == key) {
+            return member.second;
+        }
+    }
+    return nullValue();
+}
+
+const Value& Value::operator[](size_t index) const {
+    return index < array_.size() ? array_[index] : nullValue();
+}
+
+bool Value::contains(std::string_view key) const {
+    for (const auto& member : object_) {
+        if (member.first == key) {
+            return true;
+        }
+    }
+    return false;
+}
+
+size_t Value::size() const {
+    if (type_ == Type::Array) {
+        return array_.size();
+    }
+    if (type_ == Type::Object) {
+        return object_.size();
+    }
+    return 0;
+}
+
+// ============================================================================
+// WRITING
+// ============================================================================
+
+std::string quote(std::string_view text) {
+    static const char HEX[] = "0123456789abcdef";
+
+    std::string out;
+    out.reserve(text.size() + 2);
+    out += '"';
+    for (char c : text) {
+        switch (c) {
+            case '"': out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            case '\t': out += "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    out += "\\u00";
+                    out += HEX[(c >> 4) & 0xF];
+                    out += HEX[c & 0xF];
+                } else {
+                    out += c; // UTF-8 passes through unchanged
+                }
+        }
+    }
+    out += '"';
+    return out;
+}
+
+} // namespace Json
+} // namespace FFmpegMulti
@@ -1,9 +1,18 @@
 #include "../../include/core/path_utils.hpp"
+
+#include <cstdlib>
+#include <system_error>
+
 #ifdef _WIN32
 #include <windows.h>
 #elif __linux__
 #include <unistd.h>
 #include <limits.h>
+#include <fcntl.h>
+#include <sys/ioctl.h>
+#include <linux/fs.h>
+#elif __APPLE__
+#include <sys/clonefile.h>
 #endif
 
 namespace FFmpegMulti {
@@ -54,5 +63,171 @@ std::filesystem::path getExternPath() {
     return extern_next_to_exe;
 }
 
+std::filesystem::path getToolPath(const std::string& name, const std::filesystem::path& subdir) {
+    std::filesystem::path dir = getExternPath() / subdir;
+
+#ifdef _WIN32
+    std::filesystem::path bundled = dir / (name + ".exe");
+#else
+    std::filesystem::path bundled = dir / name;
+#endif
+
+    if (std::filesystem::exists(bundled)) {
+        return bundled;
+    }
+
+    // Fallback: Hope it is in the PATH
+    return std::filesystem::path(name);
+}
+
+std::filesystem::path getCacheDir() {
+    std::filesystem::path base;
+
+#ifdef _WIN32
+    if (const char* local = std::getenv("LOCALAPPDATA")) {
+        base = local;
+    }
+#elif defined(__APPLE__)
+    if (const char* home = std::getenv("HOME")) {
+        base = std::filesystem::path(home) / "Library" / "Caches";
+    }
+#else
+    const char* xdg = std::getenv("XDG_CACHE_HOME");
+    if (xdg && *xdg) {
+        base = xdg;
+    } else if (const char* home = std::getenv("HOME")) {
+        base = std::filesystem::path(home) / ".cache";
+    }
+#endif
+
+    std::error_code ec;
+    if (base.empty()) {
+        base = std::filesystem::temp_directory_path(ec);
+    }
+
+    std::filesystem::path dir = base / "ffmpeg_multi";
+    std::filesystem::create_directories(dir, ec);
+    return dir;
+}
+
+std::filesystem::path getPartialPath(const std::filesystem::path& output) {
+    std::filesystem::path partial = output;
+    partial.replace_filename(output.stem().string() + ".partial" + output.extension().string());
+    return partial;
+}
+
+bool commitPartial(const std::filesystem::path& partial, const std::filesystem::path& output) {
+    std::error_code ec;
+    std::filesystem::rename(partial, output, ec);
+    if (ec != std::errc::cross_device_link) {
+        return !ec; // On failure the partial is kept: it may hold hours of encoding
+    }
+
+    // Other volume: cloned or copied in the kernel under a name of its own next to the output, then renamed there
+    std::filesystem::path staged = output;
+    staged.replace_filename(output.stem().string() + ".staging" + output.extension().string());
+    std::error_code removeEc;
+    if (!copyFile(partial, staged)) {
+        std::filesystem::remove(staged, removeEc);
+        return false;
+    }
+    std::filesystem::rename(staged, output, ec);
+    if (ec) {
+        std::filesystem::remove(staged, removeEc);
+        return false;
+    }
+    std::filesystem::remove(partial, removeEc);
+    return true;
+}
+
+bool reflinkFile(const std::filesystem::path& from, const std::filesystem::path& to) {
+#if defined(__linux__) && defined(FICLONE)
+    int in = ::open(from.c_str(), O_RDONLY | O_CLOEXEC);
+    if (in < 0) {
+        return false;
+    }
+    int out = ::open(to.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (out < 0) {
+        ::close(in);
+        return false;
+    }
+    bool cloned = ::ioctl(out, FICLONE, in) == 0;
+    ::close(in);
+    ::close(out);
+    if (!cloned) {
+        ::unlink(to.c_str());
+    }
+    return cloned;
+#elif defined(__APPLE__)
+    std::error_code ec;
+    std::filesystem::remove(to, ec); // clonefile() refuses an existing destination
+    return ::clonefile(from.c_str(), to.c_str(), 0) == 0;
+#else
+    (void)from;
+    (void)to;
+    return false;
+#endif
+}
+
+bool copyFile(const std::filesystem::path& from, const std::filesystem::path& to) {
+    if (reflinkFile(from, to)) {
+        return true;
+    }
+
+#if defined(__linux__) && defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 27))
+    // In-kernel copy: no round trip through user space, server-side on NFS/SMB
+    int in = ::open(from.c_str(), O_RDONLY | O_CLOEXEC);
+    if (in >= 0) {
+        int out = ::open(to.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (out >= 0) {
+            bool copied = true;
+            bool started = false;
+            while (true) {
+                ssize_t n = ::copy_file_range(in, nullptr, out, nullptr, 1 << 30, 0);
+                if (n > 0) {
+                    started = true;
+                    continue;
+                }
+                copied = n == 0;
+                break;
+            }
+            ::close(in);
+            ::close(out);
+            if (copied) {
+                return true;
+            }
+            ::unlink(to.c_str());
+            if (started) {
+                return false; // Real I/O error, not an unsupported file system
+            }
+        } else {
+            ::close(in);
+        }
+    }
+#endif
+
+    std::error_code ec;
+    std::filesystem::copy_file(from, to, std::filesystem::copy_options::overwrite_existing, ec);
+    if (ec) {
+        std::filesystem::remove(to, ec);
+        return false;
+    }
+    return true;
+}
+
+bool linkOrCopyFile(const std::filesystem::path& from, const std::filesystem::path& to) {
+    if (reflinkFile(from, to)) {
+        return true;
+    }
+
+    std::error_code ec;
+    std::filesystem::remove(to, ec);
+    std::filesystem::create_hard_link(from, to, ec);
+    if (!ec) {
+        return true;
+    }
+    return copyFile(from, to);
+}
+
 } // namespace PathUtils
 } // namespace FFmpegMulti
\ No newline at end of file
@@ -0,0 +1,90 @@
+#include "../../include/core/progress.hpp"
+#include "../../include/core/string_utils.hpp"
+
+#include <cstdlib>
+
+namespace FFmpegMulti {
+namespace Core {
+
+// ============================================================================
+// PROGRESS
+// ============================================================================
+
+double Progress::percent() const {
+    if (duration_seconds <= 0.0) {
+        return -1.0;
+    }
+    if (finished) {
+        return 100.0;
+    }
+
+    double done = static_cast<double>(out_time_us) / 1e6 / duration_seconds * 100.0;
+    return done < 0.0 ? 0.0 : (done > 100.0 ? 100.0 : done);
+}
+
+double Progress::etaSeconds() const {
+    if (duration_seconds <= 0.0 || speed <= 0.0) {
+        return -1.0;
+    }
+
+    double remaining = duration_seconds - static_cast<double>(out_time_us) / 1e6;
+    return remaining > 0.0 ? remaining / speed : 0.0;
+}
+
+// ============================================================================
+// PARSER
+// ============================================================================
+
+ProgressParser::ProgressParser(double duration_seconds) {
+    current_.duration_seconds = duration_seconds;
+}
+
+void ProgressParser::feed(const char* data, size_t size, const ProgressCallback& callback) {
+    pending_.append(data, size);
+
+    size_t start = 0;
+    size_t end;
+    while ((end = pending_.find('\n', start)) != std::string::npos) {
+        parseLine(pending_.substr(start, end - start), callback);
+        start = end + 1;
+    }
+    pending_.erase(0, start);
+}
+
+void ProgressParser::parseLine(const std::string& line, const ProgressCallback& callback) {
+    size_t eq = line.find('=');
+    if (eq == std::string::npos || eq == 0 || eq + 1 >= line.size()) {
+        return;
+    }
+
+    std::string key = StringUtils::trim(line.substr(0, eq));
+    std::string value = StringUtils::trim(line.substr(eq + 1));
+
+    // FFmpeg reports "N/A" until a value is known
+    if (value.empty() || value == "N/A") {
+        return;
+    }
+
+    if (key == "frame") {
+        current_.frame = std::strtoll(value.c_str(), nullptr, 10);
+    } else if (key == "fps") {
+        current_.fps = std::strtod(value.c_str(), nullptr);
+    } else if (key == "out_time_us" || key == "out_time_ms") {
+        // out_time_ms is historically in microseconds as well
+        current_.out_time_us = std::strtoll(value.c_str(), nullptr, 10);
+    } else if (key == "total_size") {
+        current_.total_size = std::strtoll(value.c_str(), nullptr, 10);
+    } else if (key == "bitrate") {
+        current_.bitrate_kbps = std::strtod(value.c_str(), nullptr); // "1234.5kbits/s"
+    } else if (key == "speed") {
+        current_.speed = std::strtod(value.c_str(), nullptr); // "2.31x"
+    } else if (key == "progress") {
+        current_.finished = (value == "end");
+        if (callback) {
+            callback(current_);
+        }
+    }
+}
+
+} // namespace Core
+} // namespace FFmpegMulti
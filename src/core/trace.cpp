@@ -0,0 +1,189 @@
+#include "../../include/core/trace.hpp"
+#include "../../include/core/json.hpp"
+#include "../../include/core/path_utils.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <set>
+#include <sstream>
+
+namespace FFmpegMulti {
+namespace Core {
+
+// ============================================================================
+// SPAN
+// ============================================================================
+
+Trace::Span::Span(Span&& other) noexcept
+    : trace_(other.trace_), track_(other.track_), lane_(other.lane_), name_(std::move(other.name_)),
+      category_(std::move(other.category_)), start_(other.start_) {
+    other.trace_ = nullptr;
+}
+
+Trace::Span& Trace::Span::operator=(Span&& other) noexcept {
+    if (this != &other) {
+        end();
+        trace_ = other.trace_;
+        track_ = other.track_;
+        lane_ = other.lane_;
+        name_ = std::move(other.name_);
+        category_ = std::move(other.category_);
+        start_ = other.start_;
+        other.trace_ = nullptr;
+    }
+    return *this;
+}
+
+Trace::Span::~Span() {
+    end();
+}
+
+void Trace::Span::end() {
+    if (trace_) {
+        trace_->complete(track_, lane_, name_, category_, start_, Clock::now());
+        trace_ = nullptr;
+    }
+}
+
+// ============================================================================
+// RECORDING
+// ============================================================================
+
+Trace::Trace() : origin_(Clock::now()) {}
+
+int Trace::addTrack(const std::string& name, const std::string& lane_label) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Track track;
+    track.name = name;
+    track.lane_label = lane_label;
+    tracks_.push_back(track);
+    return static_cast<int>(tracks_.size()) - 1;
+}
+
+int Trace::acquireLane(int track) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<bool>& lanes = tracks_.at(static_cast<size_t>(track)).lanes;
+    auto free = std::find(lanes.begin(), lanes.end(), false);
+    if (free == lanes.end()) {
+        lanes.push_back(true);
+        return static_cast<int>(lanes.size());
+    }
+    *free = true;
+    return static_cast<int>(free - lanes.begin()) + 1;
+}
+
+void Trace::releaseLane(int track, int lane) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<bool>& lanes = tracks_.at(static_cast<size_t>(track)).lanes;
+    if (lane > 0 && static_cast<size_t>(lane) <= lanes.size()) {
+        lanes[static_cast<size_t>(lane) - 1] = false;
+    }
+}
+
+Trace::Span Trace::span(int track, int lane, const std::string& name, const std::string& category) {
+    Span span;
+    span.trace_ = this;
+    span.track_ = track;
+    span.lane_ = lane;
+    span.name_ = name;
+    span.category_ = category;
+    span.start_ = Clock::now();
+    return span;
+}
+
+int64_t Trace::microseconds(Clock::time_point at) const {
+    return std::chrono::duration_cast<std::chrono::microseconds>(at - origin_).count();
+}
+
+void Trace::complete(int track, int lane, const std::string& name, const std::string& category,
+                     Clock::time_point start, Clock::time_point end, const std::string& args) {
+    Event event{ 'X', track, lane, name, category, microseconds(start), std::max<int64_t>(0, microseconds(end) - microseconds(start)), args };
+    std::lock_guard<std::mutex> lock(mutex_);
+    events_.push_back(std::move(event));
+}
+
+void Trace::counter(int track, const std::string& name, Clock::time_point at, const std::vector<std::pair<std::string, double>>& values) {
+    std::ostringstream args;
+    for (size_t i = 0; i < values.size(); ++i) {
+        args << (i > 0 ? "," : "") << Json::quote(values[i].first) << ":" << values[i].second;
+    }
+    Event event{ 'C', track, 0, name, "counter", microseconds(at), 0, args.str() };
+    std::lock_guard<std::mutex> lock(mutex_);
+    events_.push_back(std::move(event));
+}
+
+// ============================================================================
+// OUTPUT
+// ============================================================================
+
+std::string Trace::toJson() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    // Spans are recorded when they end: parents must come before the children they contain
+    std::vector<const Event*> sorted;
+    for (const Event& event : events_) {
+        sorted.push_back(&event);
+    }
+    std::stable_sort(sorted.begin(), sorted.end(), [](const Event* a, const Event* b) {
+        return a->timestamp_us != b->timestamp_us ? a->timestamp_us < b->timestamp_us : a->duration_us > b->duration_us;
+    });
+
+    // Trace viewers expect positive process ids: track N is pid N + 1, lane L is tid L + 1
+    std::ostringstream json;
+    json.precision(6);
+    json << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    bool first = true;
+    auto separator = [&json, &first]() {
+        json << (first ? "\n" : ",\n");
+        first = false;
+    };
+
+    std::set<std::pair<int, int>> lanes;
+    for (const Event* event : sorted) {
+        if (event->phase == 'X') {
+            lanes.insert({ event->track, event->lane });
+        }
+    }
+    for (size_t i = 0; i < tracks_.size(); ++i) {
+        separator();
+        json << "{\"ph\":\"M\",\"name\":\"process_name\",\"pid\":" << i + 1 << ",\"args\":{\"name\":" << Json::quote(tracks_[i].name) << "}}";
+        separator();
+        json << "{\"ph\":\"M\",\"name\":\"process_sort_index\",\"pid\":" << i + 1 << ",\"args\":{\"sort_index\":" << i << "}}";
+    }
+    for (const auto& lane : lanes) {
+        const Track& track = tracks_.at(static_cast<size_t>(lane.first));
+        std::string name = lane.second == 0 ? "steps" : track.lane_label + " " + std::to_string(lane.second);
+        separator();
+        json << "{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":" << lane.first + 1 << ",\"tid\":" << lane.second + 1
+             << ",\"args\":{\"name\":" << Json::quote(name) << "}}";
+    }
+
+    for (const Event* event : sorted) {
+        separator();
+        json << "{\"ph\":\"" << event->phase << "\",\"name\":" << Json::quote(event->name) << ",\"cat\":" << Json::quote(event->category)
+             << ",\"pid\":" << event->track + 1 << ",\"tid\":" << event->lane + 1 << ",\"ts\":" << event->timestamp_us;
+        if (event->phase == 'X') {
+            json << ",\"dur\":" << event->duration_us;
+        }
+        if (!event->args.empty()) {
+            json << ",\"args\":{" << event->args << "}";
+        }
+        json << "}";
+    }
+    json << "\n]}\n";
+    return json.str();
+}
+
+bool Trace::write(const std::filesystem::path& file) const {
+    std::filesystem::path partial = PathUtils::getPartialPath(file);
+    {
+        std::ofstream out(partial, std::ios::binary | std::ios::trunc);
+        if (!out.is_open() || !(out << toJson())) {
+            return false;
+        }
+    }
+    return PathUtils::commitPartial(partial, file);
+}
+
+} // namespace Core
+} // namespace FFmpegMulti
@@ -0,0 +1,222 @@
+#include "../../include/jobs/auto_boost.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+namespace fs = std::filesystem;
+
+namespace FFmpegMulti {
+namespace Jobs {
+namespace AutoBoost {
+
+namespace {
+
+const double MAX_SSIM_DB = 60.0;
+const double MIN_CRF = 1.0;
+const double MAX_CRF = 63.0;
+
+const size_t IVF_HEADER_SIZE = 32;
+const size_t IVF_FRAME_HEADER_SIZE = 12;
+const size_t IVF_FRAME_COUNT_OFFSET = 24;
+
+uint64_t readLittleEndian(const unsigned char* data, size_t size) {
+    uint64_t value = 0;
+    for (size_t i = size; i > 0; --i) {
+        value = (value << 8) | data[i - 1];
+    }
+    return value;
+}
+
+void writeLittleEndian(unsigned char* data, uint64_t value, size_t size) {
+    for (size_t i = 0; i < size; ++i) {
+        data[i] = static_cast<unsigned char>(value >> (8 * i));
+    }
+}
+
+} // namespace
+
+// ============================================================================
+// ZONES
+// ============================================================================
+
+std::vector<Zone> planZones(const std::vector<SceneCut>& cuts, int64_t total_frames, int64_t max_frames) {
+    std::vector<int64_t> starts = { 0 };
+    for (const auto& cut : cuts) {
+        if (cut.frame > starts.back() && cut.frame < total_frames) {
+            starts.push_back(cut.frame);
+        }
+    }
+
+    std::vector<Zone> zones;
+    for (size_t i = 0; i < starts.size(); ++i) {
+        int64_t start = starts[i];
+        int64_t end = i + 1 < starts.size() ? starts[i + 1] : total_frames;
+        int64_t length = end - start;
+        if (length <= 0) {
+            continue;
+        }
+
+        // Equal parts rather than max-length parts plus a short tail
+        int64_t parts = max_frames > 0 ? (length + max_frames - 1) / max_frames : 1;
+        for (int64_t part = 0; part < parts; ++part) {
+            Zone zone;
+            zone.start_frame = start + length * part / parts;
+            zone.frame_count = start + length * (part + 1) / parts - zone.start_frame;
+            zones.push_back(zone);
+        }
+    }
+    return zones;
+}
+
+bool writeZones(const std::vector<Zone>& zones, double frame_rate, const fs::path& path) {
+    std::ofstream file(path);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    file << "start_frame,start_time,frames,mean_db,low_db,crf\n";
+    file << std::fixed;
+    for (const auto& zone : zones) {
+        file << zone.start_frame << ","
+             << std::setprecision(6) << (frame_rate > 0.0 ? zone.start_frame / frame_rate : 0.0) << ","
+             << zone.frame_count << ","
+             << std::setprecision(3) << zone.mean_db << "," << zone.low_db << ","
+             << std::setprecision(2) << zone.crf << "\n";
+    }
+    return static_cast<bool>(file);
+}
+
+// ============================================================================
+// QUALITY
+// ============================================================================
+
+std::vector<double> parseSsimStats(const std::string& stats) {
+    std::vector<double> values;
+    std::istringstream lines(stats);
+    std::string line;
+    while (std::getline(lines, line)) {
+        size_t pos = line.find("All:");
+        if (pos == std::string::npos) {
+            continue;
+        }
+        const char* start = line.c_str() + pos + 4;
+        char* end = nullptr;
+        double ssim = std::strtod(start, &end);
+        if (end == start) {
+            continue;
+        }
+        double db = ssim >= 1.0 ? MAX_SSIM_DB : -10.0 * std::log10(1.0 - ssim);
+        values.push_back(std::min(db, MAX_SSIM_DB));
+    }
+    return values;
+}
+
+double percentile(std::vector<double> values, double fraction) {
+    if (values.empty()) {
+        return 0.0;
+    }
+    fraction = std::clamp(fraction, 0.0, 1.0);
+    size_t rank = static_cast<size_t>(std::ceil(fraction * static_cast<double>(values.size())));
+    size_t index = rank > 0 ? rank - 1 : 0;
+    std::nth_element(values.begin(), values.begin() + static_cast<std::ptrdiff_t>(index), values.end());
+    return values[index];
+}
+
+double zoneCrf(double base_crf, double zone_low_db, double title_mean_db, double strength, double max_delta) {
+    if (title_mean_db <= 0.0 || zone_low_db <= 0.0) {
+        return base_crf; // Not measured
+    }
+    double adjustment = std::ceil((1.0 - zone_low_db / title_mean_db) * strength * 4.0) / 4.0;
+    adjustment = std::clamp(adjustment, -max_delta, max_delta);
+    return std::clamp(base_crf - adjustment, MIN_CRF, MAX_CRF);
+}
+
+// ============================================================================
+// IVF
+// ============================================================================
+
+bool concatIvf(const std::vector<fs::path>& parts, const fs::path& output, int64_t& frames, std::string& error) {
+    frames = 0;
+    if (parts.empty()) {
+        error = "no input";
+        return false;
+    }
+
+    std::ofstream out(output, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) {
+        error = "cannot create " + output.string();
+        return false;
+    }
+
+    std::vector<char> payload;
+    unsigned char header[IVF_HEADER_SIZE];
+    unsigned char frameHeader[IVF_FRAME_HEADER_SIZE];
+    uint64_t nextPts = 0;
+
+    for (size_t i = 0; i < parts.size(); ++i) {
+        std::ifstream in(parts[i], std::ios::binary);
+        if (!in.read(reinterpret_cast<char*>(header), IVF_HEADER_SIZE) || std::string(reinterpret_cast<char*>(header), 4) != "DKIF") {
+            error = "not an IVF file: " + parts[i].string();
+            return false;
+        }
+        size_t headerSize = static_cast<size_t>(readLittleEndian(header + 6, 2));
+        if (headerSize < IVF_HEADER_SIZE) {
+            error = "invalid IVF header size in " + parts[i].string();
+            return false;
+        }
+        if (i == 0) {
+            // The whole header, extension bytes included (frame count patched below)
+            std::vector<char> fullHeader(reinterpret_cast<const char*>(header), reinterpret_cast<const char*>(header) + IVF_HEADER_SIZE);
+            fullHeader.resize(headerSize);
+            if (!in.read(fullHeader.data() + IVF_HEADER_SIZE, static_cast<std::streamsize>(headerSize - IVF_HEADER_SIZE))) {
+                error = "truncated IVF header in " + parts[i].string();
+                return false;
+            }
+            out.write(fullHeader.data(), static_cast<std::streamsize>(headerSize));
+        } else {
+            in.seekg(static_cast<std::streamoff>(headerSize), std::ios::beg);
+        }
+
+        bool first = true;
+        uint64_t offset = 0;
+        while (in.read(reinterpret_cast<char*>(frameHeader), IVF_FRAME_HEADER_SIZE)) {
+            size_t size = static_cast<size_t>(readLittleEndian(frameHeader, 4));
+            uint64_t pts = readLittleEndian(frameHeader + 4, 8);
+            if (first) {
+                offset = nextPts - pts; // Wraps as intended when the part starts after nextPts
+                first = false;
+            }
+            payload.resize(size);
+            if (!in.read(payload.data(), static_cast<std::streamsize>(size))) {
+                error = "truncated frame in " + parts[i].string();
+                return false;
+            }
+
+            uint64_t shifted = pts + offset;
+            writeLittleEndian(frameHeader + 4, shifted, 8);
+            out.write(reinterpret_cast<const char*>(frameHeader), IVF_FRAME_HEADER_SIZE);
+            out.write(payload.data(), static_cast<std::streamsize>(size));
+            nextPts = std::max(nextPts, shifted + 1);
+            frames++;
+        }
+    }
+
+    unsigned char count[4];
+    writeLittleEndian(count, static_cast<uint64_t>(frames), 4);
+    out.seekp(static_cast<std::streamoff>(IVF_FRAME_COUNT_OFFSET), std::ios::beg);
+    out.write(reinterpret_cast<const char*>(count), 4);
+    out.close();
+    if (!out) {
+        error = "write error on " + output.string();
+        return false;
+    }
+    return true;
+}
+
+} // namespace AutoBoost
+} // namespace Jobs
+} // namespace FFmpegMulti
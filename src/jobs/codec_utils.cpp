@@ -1,4 +1,5 @@
 #include "../../include/jobs/codec_utils.hpp"
+#include <cstdlib>
 #include <stdexcept>
 
 namespace FFmpegMulti {
@@ -109,6 +110,50 @@ void CodecUtils::addFFV1Args(std::vector<std::string>& args, int level, int code
     args.push_back(std::to_string(slices));
 }
 
+// ============================================================================
+// SCHEDULING
+// ============================================================================
+
+unsigned CodecUtils::getTypicalThreadUsage(Encode::Codec codec, const std::string& preset) {
+    bool fastPreset = preset == "ultrafast" || preset == "superfast" || preset == "veryfast" || preset == "faster";
+    bool slowPreset = preset == "slow" || preset == "slower" || preset == "veryslow" || preset == "placebo";
+    
+    switch (codec) {
+        case Encode::Codec::X264:
+            // Frame threading scales well, fast presets are limited by decoding
+            return fastPreset ? 4 : 6;
+            
+        case Encode::Codec::X265:
+            // WPP + frame threads: slow presets saturate about 8 cores
+            return slowPreset ? 8 : (fastPreset ? 4 : 6);
+            
+        case Encode::Codec::AV1:
+            // libaom row-mt rarely goes past 4 cores
+            return 4;
+            
+        case Encode::Codec::SVT_AV1:
+        case Encode::Codec::SVT_AV1_ESSENTIAL: {
+            // Numeric presets: lower is slower and more parallel
+            int level = std::atoi(preset.c_str());
+            return (!preset.empty() && level <= 4) ? 12 : 8;
+        }
+            
+        case Encode::Codec::H264_NVENC:
+        case Encode::Codec::H265_NVENC:
+            // Encoding runs on the GPU, the CPU only decodes
+            return 2;
+            
+        case Encode::Codec::ProRes:
+            return 8;
+            
+        case Encode::Codec::FFV1:
+            // Slice threading (24 slices by default)
+            return 8;
+    }
+    
+    return 1;
+}
+
 // ============================================================================
 // CONTAINER UTILS
 // ============================================================================
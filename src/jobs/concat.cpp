@@ -1,9 +1,9 @@
 #include "../../include/jobs/concat.hpp"
 #include "../../include/core/colors.hpp"
 #include "../../include/core/path_utils.hpp"
+#include "../../include/core/ffmpeg_process.hpp"
 #include <iostream>
 #include <filesystem>
-#include <cstdlib>
 
 namespace fs = std::filesystem;
 
@@ -17,15 +17,8 @@ namespace Jobs {
 ConcatJob::ConcatJob(const std::vector<std::string>& inputs, const std::string& output) : m_inputs(inputs), m_output(output) {}
 
 std::string ConcatJob::getMkvMergePath() const {
-    // Use PathUtils to find the extern folder
-    fs::path extern_path = PathUtils::getExternPath();
-    fs::path mkvmerge_path = extern_path / "env" / "mkvtoolnix" / "mkvmerge.exe";
-
-    if (fs::exists(mkvmerge_path))
-        return mkvmerge_path.string();
-    
-    // Fallback: Hope it is in the PATH
-    return "mkvmerge"; 
+    // extern/env/mkvtoolnix/mkvmerge.exe, or mkvmerge from the PATH
+    return PathUtils::getToolPath("mkvmerge", fs::path("env") / "mkvtoolnix").string();
 }
 
 bool ConcatJob::execute() {
@@ -34,27 +27,42 @@ bool ConcatJob::execute() {
         return false;
     }
 
-    std::string mkvmerge = getMkvMergePath();
-    
     // Command construction
     // mkvmerge -o "output.mkv" "input1" + "input2" + "input3"
-    
-    std::string command = mkvmerge + " -o \"" + m_output + "\"";
+    // Written under a temporary name, so an interrupted join never looks complete
+    fs::path partial = PathUtils::getPartialPath(m_output);
+    std::vector<std::string> args;
+    args.push_back("-o");
+    args.push_back(partial.string());
     
     // First file
-    command += " \"" + m_inputs[0] + "\"";
+    args.push_back(m_inputs[0]);
     
     // Subsequent files with +
     for (size_t i = 1; i < m_inputs.size(); ++i) {
-        command += " + \"" + m_inputs[i] + "\"";
+        args.push_back("+");
+        args.push_back(m_inputs[i]);
     }
 
+    ffmpegProcess mkvmerge(getMkvMergePath(), args);
+    mkvmerge.setEcho(false);
+
     std::cout << std::endl;
-    std::cout << Colors::BLUE << "[CMD] " << command << Colors::RESET << std::endl;
+    std::cout << Colors::BLUE << "[CMD] " << mkvmerge.getCommandString() << Colors::RESET << std::endl;
     std::cout << std::endl;
     
-    int result = std::system(command.c_str());
-    return result == 0;
+    ProcessResult result = runProcess(mkvmerge);
+    if (!result.success()) {
+        std::cerr << Colors::RED << "[ERROR] mkvmerge failed (" << result.describe() << ")" << Colors::RESET << std::endl;
+        std::error_code ec;
+        fs::remove(partial, ec);
+        return false;
+    }
+    if (!PathUtils::commitPartial(partial, m_output)) {
+        std::cerr << Colors::RED << "[ERROR] Cannot move the joined file to " << m_output << " (kept as " << partial.string() << ")" << Colors::RESET << std::endl;
+        return false;
+    }
+    return true;
 }
 
 // ============================================================================
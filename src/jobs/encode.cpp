@@ -2,16 +2,134 @@
 #include "../../include/jobs/codec_utils.hpp"
 #include "../../include/core/path_utils.hpp"
 #include "../../include/core/ffmpeg_process.hpp"
+#include "../../include/jobs/probe.hpp"
+#include <algorithm>
+#include <cctype>
+#include <condition_variable>
+#include <cstdio>
 #include <iostream>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <set>
 #include <sstream>
 #include <filesystem>
-#include <cstdlib>
+#include <thread>
 
 namespace fs = std::filesystem;
 
 namespace FFmpegMulti {
 namespace Jobs {
 
+namespace {
+
+/**
+ * @brief Image2 pattern with a single number field ("%08d.png", "frame_%d.tiff")
+ */
+struct ImagePattern {
+    std::string prefix;
+    std::string width; // Digits between '%' and 'd' ("08"), may be empty
+    std::string suffix;
+
+    std::string name(int64_t number) const {
+        char digits[32];
+        std::snprintf(digits, sizeof(digits), ("%" + width + "lld").c_str(), static_cast<long long>(number));
+        return prefix + digits + suffix;
+    }
+};
+
+std::optional<ImagePattern> parsePattern(const std::string& pattern) {
+    size_t percent = pattern.find('%');
+    if (percent == std::string::npos) {
+        return std::nullopt;
+    }
+    size_t end = percent + 1;
+    while (end < pattern.size() && std::isdigit(static_cast<unsigned char>(pattern[end]))) {
+        end++;
+    }
+    if (end >= pattern.size() || pattern[end] != 'd' || pattern.find('%', end) != std::string::npos) {
+        return std::nullopt;
+    }
+    return ImagePattern{ pattern.substr(0, percent), pattern.substr(percent + 1, end - percent - 1), pattern.substr(end + 1) };
+}
+
+/**
+ * @brief First number and length of the sequence, read the way the image2 demuxer does:
+ * from the lowest number present up to the first missing one
+ */
+std::pair<int64_t, int64_t> findSequence(const fs::path& dir, const ImagePattern& pattern) {
+    std::set<int64_t> numbers;
+    for (const auto& entry : fs::directory_iterator(dir)) {
+        std::string name = entry.path().filename().string();
+        if (name.size() <= pattern.prefix.size() + pattern.suffix.size() || name.compare(0, pattern.prefix.size(), pattern.prefix) != 0 ||
+            name.compare(name.size() - pattern.suffix.size(), pattern.suffix.size(), pattern.suffix) != 0) {
+            continue;
+        }
+        std::string digits = name.substr(pattern.prefix.size(), name.size() - pattern.prefix.size() - pattern.suffix.size());
+        if (digits.size() > 18 || !std::all_of(digits.begin(), digits.end(), [](char c) { return std::isdigit(static_cast<unsigned char>(c)); })) {
+            continue;
+        }
+        int64_t number = std::stoll(digits);
+        if (pattern.name(number) == name) {
+            numbers.insert(number);
+        }
+    }
+    if (numbers.empty()) {
+        return { 0, 0 };
+    }
+    int64_t first = *numbers.begin();
+    int64_t count = 0;
+    while (numbers.count(first + count)) {
+        count++;
+    }
+    return { first, count };
+}
+
+/**
+ * @brief Bytes of one rawvideo frame
+ * @return 0 for a format the pipe does not carry (paletted, bitstream, unlisted)
+ */
+size_t rawFrameBytes(const std::string& pix_fmt, int width, int height) {
+    const size_t w = static_cast<size_t>(width);
+    const size_t h = static_cast<size_t>(height);
+
+    static const std::map<std::string, size_t> packed = {
+        { "gray", 1 }, { "gray16be", 2 }, { "gray16le", 2 }, { "ya8", 2 }, { "ya16be", 4 }, { "ya16le", 4 },
+        { "rgb24", 3 }, { "bgr24", 3 }, { "rgba", 4 }, { "bgra", 4 }, { "argb", 4 }, { "abgr", 4 }, { "rgb0", 4 }, { "bgr0", 4 },
+        { "rgb48be", 6 }, { "rgb48le", 6 }, { "rgba64be", 8 }, { "rgba64le", 8 }
+    };
+    auto it = packed.find(pix_fmt);
+    if (it != packed.end()) {
+        return w * h * it->second;
+    }
+
+    // Planar: full size planes (luma, alpha, or the three of GBR) plus two subsampled chroma planes
+    struct Planar {
+        int full_planes;
+        int chroma_planes;
+        int shift_x;
+        int shift_y;
+        size_t sample_bytes;
+    };
+    static const std::map<std::string, Planar> planar = {
+        { "yuv420p", { 1, 2, 1, 1, 1 } }, { "yuvj420p", { 1, 2, 1, 1, 1 } }, { "yuv422p", { 1, 2, 1, 0, 1 } },
+        { "yuvj422p", { 1, 2, 1, 0, 1 } }, { "yuv444p", { 1, 2, 0, 0, 1 } }, { "yuvj444p", { 1, 2, 0, 0, 1 } },
+        { "yuva420p", { 2, 2, 1, 1, 1 } }, { "yuva444p", { 2, 2, 0, 0, 1 } },
+        { "yuv420p10le", { 1, 2, 1, 1, 2 } }, { "yuv422p10le", { 1, 2, 1, 0, 2 } }, { "yuv444p10le", { 1, 2, 0, 0, 2 } },
+        { "yuva444p10le", { 2, 2, 0, 0, 2 } }, { "yuv420p16le", { 1, 2, 1, 1, 2 } }, { "yuv444p16le", { 1, 2, 0, 0, 2 } },
+        { "gbrp", { 3, 0, 0, 0, 1 } }, { "gbrap", { 4, 0, 0, 0, 1 } }, { "gbrp16le", { 3, 0, 0, 0, 2 } }, { "gbrap16le", { 4, 0, 0, 0, 2 } }
+    };
+    auto plane = planar.find(pix_fmt);
+    if (plane == planar.end()) {
+        return 0;
+    }
+    const Planar& p = plane->second;
+    size_t chroma = ((w + (size_t(1) << p.shift_x) - 1) >> p.shift_x) * ((h + (size_t(1) << p.shift_y) - 1) >> p.shift_y);
+    return (static_cast<size_t>(p.full_planes) * w * h + static_cast<size_t>(p.chroma_planes) * chroma) * p.sample_bytes;
+}
+
+} // namespace
+
 // ============================================================================
 // CONSTRUCTORS
 // ============================================================================
@@ -83,6 +201,27 @@ std::string EncodeJob::getCodecName() const {
     return Codec::CodecUtils::getEncoderName(config_.codec);
 }
 
+double EncodeJob::getExpectedDuration() const {
+    if (config_.framerate <= 0) {
+        return 0.0;
+    }
+
+    // Count the images sharing the pattern's extension
+    std::string extension = fs::path(config_.input_pattern).extension().string();
+    size_t count = 0;
+    try {
+        for (const auto& entry : fs::directory_iterator(config_.input_dir)) {
+            if (entry.is_regular_file() && entry.path().extension() == extension) {
+                count++;
+            }
+        }
+    } catch (const std::exception&) {
+        return 0.0;
+    }
+
+    return static_cast<double>(count) / config_.framerate;
+}
+
 void EncodeJob::addCodecSpecificArgs(std::vector<std::string>& args) const {
     Codec::CodecUtils::addCodecArgs(args, config_.codec, config_.quality, config_.preset);
 }
@@ -92,19 +231,19 @@ void EncodeJob::addCodecSpecificArgs(std::vector<std::string>& args) const {
 // ============================================================================
 
 std::vector<std::string> EncodeJob::buildCommand() const {
+    // Framerate and input pattern
+    std::string input_path = (fs::path(config_.input_dir) / config_.input_pattern).string();
+    return buildCommand({ "-framerate", std::to_string(config_.framerate), "-i", input_path });
+}
+
+std::vector<std::string> EncodeJob::buildCommand(const std::vector<std::string>& input_args) const {
     std::vector<std::string> args;
 
     // Global options
     args.push_back("-hide_banner");
     
-    // Framerate
-    args.push_back("-framerate");
-    args.push_back(std::to_string(config_.framerate));
-    
-    // Input pattern
-    args.push_back("-i");
-    std::string input_path = (fs::path(config_.input_dir) / config_.input_pattern).string();
-    args.push_back(input_path);
+    // Input
+    args.insert(args.end(), input_args.begin(), input_args.end());
     
     // Video codec
     args.push_back("-c:v");
@@ -144,6 +283,15 @@ std::string EncodeJob::getCommandString() const {
 // EXECUTION
 // ============================================================================
 
+unsigned EncodeJob::threadDemand() const {
+    // Each decoder process keeps about one core busy next to the encoder
+    return Codec::CodecUtils::getTypicalThreadUsage(config_.codec, config_.preset) + static_cast<unsigned>(std::max(0, config_.decode_workers));
+}
+
+std::string EncodeJob::encoderName() const {
+    return getCodecName();
+}
+
 bool EncodeJob::execute() {
     if (!validatePaths()) {
         return false;
@@ -160,6 +308,10 @@ bool EncodeJob::execute() {
         return false;
     }
 
+    if (config_.decode_workers > 0) {
+        return executePiped();
+    }
+
     // Build command
     auto args = buildCommand();
     
@@ -167,20 +319,194 @@ bool EncodeJob::execute() {
     std::cout << "[INFO] Encode command: " << getCommandString() << std::endl;
     
     // Execution via FFmpegProcess
-    std::filesystem::path extern_path = FFmpegMulti::PathUtils::getExternPath();
-    std::filesystem::path ffmpeg_path = extern_path / "ffmpeg.exe";
+    std::filesystem::path ffmpeg_path = FFmpegMulti::PathUtils::getToolPath("ffmpeg");
     
     ffmpegProcess process(ffmpeg_path, args);
-    bool success = process.execute();
+    if (hasProgressCallback()) {
+        trackProgress(process, getExpectedDuration());
+    }
+    ProcessResult result = runProcess(process);
 
-    if (success) {
+    if (result.success()) {
         std::cout << "[SUCCESS] Encoding finished successfully!" << std::endl;
         std::cout << "[INFO] File created: " << getOutputPath() << std::endl;
     } else {
-        std::cerr << "[ERROR] Encoding failed!" << std::endl;
+        std::cerr << "[ERROR] Encoding failed! (" << result.describe() << ")" << std::endl;
     }
 
-    return success;
+    return result.success();
+}
+
+// ============================================================================
+// PARALLEL DECODING
+// ============================================================================
+
+std::string EncodeJob::getPipePixelFormat(const std::string& image_pix_fmt) const {
+    // Frames arrive in the format the encoder works in, so the conversion runs in the decoders too
+    switch (config_.codec) {
+        case Encode::Codec::ProRes: return "yuva444p10le";
+        case Encode::Codec::FFV1:
+            // Lossless: the images are kept as they are, except formats rawvideo cannot carry
+            // (a paletted image would lose its palette): expanded to RGBA, which holds any 8-bit image
+            return rawFrameBytes(image_pix_fmt, 1, 1) > 0 ? image_pix_fmt : "rgba";
+        default: return "yuv420p";
+    }
+}
+
+bool EncodeJob::executePiped() {
+    std::optional<ImagePattern> pattern = parsePattern(config_.input_pattern);
+    if (!pattern) {
+        std::cerr << "[ERROR] Parallel decoding needs a pattern with one number field (e.g. %08d.png): " << config_.input_pattern << std::endl;
+        return false;
+    }
+    std::pair<int64_t, int64_t> sequence = findSequence(config_.input_dir, *pattern);
+    if (sequence.second == 0) {
+        std::cerr << "[ERROR] No image matches " << config_.input_pattern << " in " << config_.input_dir << std::endl;
+        return false;
+    }
+
+    // Every image of the sequence is expected to share the size of the first one
+    std::string firstImage = (fs::path(config_.input_dir) / pattern->name(sequence.first)).string();
+    ::Jobs::ProbeResult probe;
+    try {
+        probe = ::Jobs::ProbeJob::probe(firstImage);
+    } catch (const std::exception& e) {
+        std::cerr << "[ERROR] Cannot probe " << firstImage << ": " << e.what() << std::endl;
+        return false;
+    }
+    const ::Jobs::ProbeStream* image = probe.firstStream("video");
+    if (!image || image->width <= 0 || image->height <= 0 || image->pix_fmt.empty()) {
+        std::cerr << "[ERROR] Cannot probe the size of " << firstImage << std::endl;
+        return false;
+    }
+    std::string pixFmt = getPipePixelFormat(image->pix_fmt);
+    std::string size = std::to_string(image->width) + "x" + std::to_string(image->height);
+    const size_t frameBytes = rawFrameBytes(pixFmt, image->width, image->height);
+    if (frameBytes == 0) {
+        std::cerr << "[ERROR] Cannot pipe " << pixFmt << " frames" << std::endl;
+        return false;
+    }
+
+    std::filesystem::path ffmpeg_path = FFmpegMulti::PathUtils::getToolPath("ffmpeg");
+    ffmpegProcess encoder(ffmpeg_path, buildCommand({
+        "-f", "rawvideo", "-pix_fmt", pixFmt, "-video_size", size, "-framerate", std::to_string(config_.framerate), "-i", "pipe:0"
+    }));
+    if (hasProgressCallback() && config_.framerate > 0) {
+        trackProgress(encoder, static_cast<double>(sequence.second) / config_.framerate);
+    }
+
+    const int64_t chunkFrames = config_.decode_chunk_frames;
+    const size_t chunks = static_cast<size_t>((sequence.second + chunkFrames - 1) / chunkFrames);
+    const size_t workers = std::min(chunks, static_cast<size_t>(config_.decode_workers));
+    // Chunks being decoded or waiting for their turn: bounds the memory to about 2 x workers chunks
+    const size_t capacity = 2 * workers;
+    std::cout << "[INFO] Parallel decoding: " << sequence.second << " images (" << size << ", " << pixFmt << ") in " << chunks
+              << " chunks, " << workers << " decoders" << std::endl;
+    std::cout << "[INFO] Encode command: " << encoder.getCommandString() << std::endl;
+
+    // Reorder buffer: decoders finish out of order, the encoder takes the chunks in order
+    std::mutex mutex;
+    std::condition_variable changed;
+    std::map<size_t, std::string> decoded;
+    size_t nextDecode = 0;
+    size_t nextWrite = 0;
+    bool failed = false;
+    std::string error;
+
+    auto fail = [&](const std::string& message) {
+        if (!failed) {
+            failed = true;
+            error = message;
+        }
+        changed.notify_all();
+    };
+
+    auto decode = [&]() {
+        while (true) {
+            size_t chunk;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                changed.wait(lock, [&] { return failed || nextDecode >= chunks || nextDecode < nextWrite + capacity; });
+                if (failed || nextDecode >= chunks) {
+                    return;
+                }
+                chunk = nextDecode++;
+            }
+
+            int64_t first = sequence.first + static_cast<int64_t>(chunk) * chunkFrames;
+            int64_t frames = std::min(chunkFrames, sequence.first + sequence.second - first);
+            ffmpegProcess decoder(ffmpeg_path, {
+                "-hide_banner", "-loglevel", "error", "-threads", "1",
+                "-f", "image2", "-start_number", std::to_string(first), "-i", (fs::path(config_.input_dir) / config_.input_pattern).string(),
+                "-frames:v", std::to_string(frames), "-f", "rawvideo", "-pix_fmt", pixFmt, "pipe:1"
+            });
+            decoder.setEcho(false);
+            std::string data;
+            decoder.setOutputCallback([&data](const char* bytes, size_t length) { data.append(bytes, length); });
+            ProcessResult result = runProcess(decoder);
+
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!result.success()) {
+                fail("decoding images " + pattern->name(first) + " to " + pattern->name(first + frames - 1) + " failed (" + result.describe() + ")");
+                return;
+            }
+            // A different size or an image the decoder skipped: the frames would shift in the encode
+            if (data.size() != static_cast<size_t>(frames) * frameBytes) {
+                fail("images " + pattern->name(first) + " to " + pattern->name(first + frames - 1) + " did not decode to " + std::to_string(frames) +
+                     " frames of " + size + " (" + pixFmt + ") like " + pattern->name(sequence.first));
+                return;
+            }
+            decoded[chunk] = std::move(data);
+            changed.notify_all();
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for (size_t i = 0; i < workers; ++i) {
+        pool.emplace_back(decode);
+    }
+
+    ProcessResult result = runProcess(encoder, [&](InputPipe& input) {
+        for (size_t chunk = 0; chunk < chunks; ++chunk) {
+            std::string data;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                changed.wait(lock, [&] { return failed || decoded.count(chunk) > 0; });
+                if (failed) {
+                    return;
+                }
+                data = std::move(decoded[chunk]);
+                decoded.erase(chunk);
+                nextWrite = chunk + 1;
+            }
+            changed.notify_all();
+            if (!input.write(data.data(), data.size())) {
+                std::lock_guard<std::mutex> lock(mutex);
+                fail("the encoder stopped reading its input");
+                return;
+            }
+        }
+    });
+
+    {
+        // The encoder may have died first: stop the decoders still waiting for room
+        std::lock_guard<std::mutex> lock(mutex);
+        failed = failed || !result.success();
+    }
+    changed.notify_all();
+    for (auto& thread : pool) {
+        thread.join();
+    }
+
+    if (failed) {
+        std::string reason = result.success() ? error : result.describe() + (error.empty() ? "" : ", " + error);
+        std::cerr << "[ERROR] Encoding failed! (" << reason << ")" << std::endl;
+        return false;
+    }
+
+    std::cout << "[SUCCESS] Encoding finished successfully!" << std::endl;
+    std::cout << "[INFO] File created: " << getOutputPath() << std::endl;
+    return true;
 }
 
 } // namespace Jobs
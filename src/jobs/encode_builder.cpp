@@ -1,5 +1,7 @@
 #include "../../include/jobs/encode.hpp"
 
+#include <stdexcept>
+
 namespace FFmpegMulti {
 namespace Jobs {
 
@@ -119,11 +121,24 @@ EncodeJobBuilder& EncodeJobBuilder::preset(const std::string& p) {
     return *this;
 }
 
+// ============================================================================
+// INPUT DECODING
+// ============================================================================
+
+EncodeJobBuilder& EncodeJobBuilder::decodeWorkers(int workers, int chunk_frames) {
+    config_.decode_workers = workers;
+    config_.decode_chunk_frames = chunk_frames;
+    return *this;
+}
+
 // ============================================================================
 // BUILD
 // ============================================================================
 
 EncodeJob EncodeJobBuilder::build() const {
+    if (config_.decode_workers < 0 || config_.decode_chunk_frames < 1) {
+        throw std::runtime_error("Decode workers cannot be negative and chunks need at least one image");
+    }
     return EncodeJob(config_);
 }
 
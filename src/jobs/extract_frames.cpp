@@ -1,10 +1,17 @@
 #include "../../include/jobs/extract_frames.hpp"
+#include "../../include/jobs/probe.hpp"
 #include "../../include/core/ffmpeg_process.hpp"
 #include "../../include/core/path_utils.hpp"
+#include "../../include/pipeline/batch_runner.hpp"
+#include "../../include/pipeline/segments.hpp"
 #include <iostream>
 #include <sstream>
+#include <iomanip>
 #include <filesystem>
 #include <stdexcept>
+#include <algorithm>
+#include <limits>
+#include <chrono>
 
 namespace fs = std::filesystem;
 
@@ -51,13 +58,16 @@ bool ExtractFramesJob::validatePaths() const {
     return true;
 }
 
+std::string ExtractFramesJob::getTargetDir() const {
+    if (config_.create_subfolder && !config_.subfolder_name.empty()) {
+        return (fs::path(config_.output_dir) / config_.subfolder_name).string();
+    }
+    return config_.output_dir;
+}
+
 bool ExtractFramesJob::createOutputDirectory() const {
     try {
-        std::string target_dir = config_.output_dir;
-        
-        if (config_.create_subfolder && !config_.subfolder_name.empty()) {
-            target_dir = (fs::path(config_.output_dir) / config_.subfolder_name).string();
-        }
+        std::string target_dir = getTargetDir();
 
         if (!fs::exists(target_dir)) {
             fs::create_directories(target_dir);
@@ -72,14 +82,8 @@ bool ExtractFramesJob::createOutputDirectory() const {
 }
 
 std::string ExtractFramesJob::getOutputPattern() const {
-    std::string target_dir = config_.output_dir;
-    
-    if (config_.create_subfolder && !config_.subfolder_name.empty()) {
-        target_dir = (fs::path(config_.output_dir) / config_.subfolder_name).string();
-    }
-
     std::string extension = getFileExtension();
-    return (fs::path(target_dir) / ("%08d" + extension)).string();
+    return (fs::path(getTargetDir()) / ("%08d" + extension)).string();
 }
 
 std::string ExtractFramesJob::getFileExtension() const {
@@ -104,6 +108,18 @@ std::vector<std::string> ExtractFramesJob::buildCommand() const {
 
     // Global options
     args.push_back("-hide_banner");
+
+    // Segment of a parallel extraction (input seeking: decoding starts at the keyframe)
+    bool segment = config_.start_time > 0.0 || config_.duration > 0.0;
+    if (config_.start_time > 0.0) {
+        args.push_back("-ss");
+        args.push_back(Pipeline::formatSeconds(config_.start_time));
+    }
+    if (config_.duration > 0.0) {
+        args.push_back("-t");
+        args.push_back(Pipeline::formatSeconds(config_.duration));
+    }
+
     args.push_back("-i");
     args.push_back(config_.input_path);
 
@@ -111,6 +127,12 @@ std::vector<std::string> ExtractFramesJob::buildCommand() const {
     args.push_back("-sws_flags");
     args.push_back("spline+accurate_rnd+full_chroma_int");
 
+    // One image per decoded frame, so a segment writes exactly its planned number of images
+    if (segment) {
+        args.push_back("-vsync");
+        args.push_back("passthrough");
+    }
+
     // Configuration according to format
     switch (config_.format) {
         case ImageFormat::PNG:
@@ -127,7 +149,7 @@ std::vector<std::string> ExtractFramesJob::buildCommand() const {
             args.push_back("-pix_fmt");
             args.push_back("rgb24");
             args.push_back("-start_number");
-            args.push_back("0");
+            args.push_back(std::to_string(config_.start_number));
             break;
 
         case ImageFormat::TIFF:
@@ -146,7 +168,7 @@ std::vector<std::string> ExtractFramesJob::buildCommand() const {
             args.push_back("-compression_algo");
             args.push_back("deflate");
             args.push_back("-start_number");
-            args.push_back("0");
+            args.push_back(std::to_string(config_.start_number));
             args.push_back("-movflags");
             args.push_back("frag_keyframe+empty_moov+delay_moov+use_metadata_tags+write_colr");
             args.push_back("-bf");
@@ -169,7 +191,7 @@ std::vector<std::string> ExtractFramesJob::buildCommand() const {
             args.push_back("-q:v");
             args.push_back("1");
             args.push_back("-start_number");
-            args.push_back("0");
+            args.push_back(std::to_string(config_.start_number));
             break;
     }
 
@@ -206,6 +228,25 @@ bool ExtractFramesJob::execute() {
     if (!createOutputDirectory())
         return false;
 
+    if (config_.parallel_segments > 1) {
+        try {
+            return executeParallel();
+        } catch (const std::exception& e) {
+            std::cerr << "[ERROR] Extraction failed: " << e.what() << std::endl;
+            return false;
+        }
+    }
+    return executeSingle();
+}
+
+unsigned ExtractFramesJob::threadDemand() const {
+    if (config_.parallel_segments > 1) {
+        return Core::availableCores();
+    }
+    return 1; // The image encoder runs on a single thread
+}
+
+bool ExtractFramesJob::executeSingle() {
     // Build command
     auto args = buildCommand();
     
@@ -213,21 +254,168 @@ bool ExtractFramesJob::execute() {
     std::cout << "[INFO] Extract frames command: " << getCommandString() << std::endl;
     
     // Execution via FFmpegProcess
-    std::filesystem::path extern_path = FFmpegMulti::PathUtils::getExternPath();
-    std::filesystem::path ffmpeg_path = extern_path / "ffmpeg.exe";
+    std::filesystem::path ffmpeg_path = FFmpegMulti::PathUtils::getToolPath("ffmpeg");
     
     ffmpegProcess ffmpeg(ffmpeg_path, args);
-    bool success = ffmpeg.execute();
+    if (hasProgressCallback()) {
+        trackProgress(ffmpeg, ::Jobs::ProbeJob::probeDuration(config_.input_path) - config_.start_time);
+    }
+    ProcessResult result = runProcess(ffmpeg);
 
-    if (success) {
+    if (result.success()) {
         std::cout << "[SUCCESS] Extraction completed successfully!" << std::endl;
-        std::cout << "[INFO] Frames extracted to: " << (config_.create_subfolder && !config_.subfolder_name.empty() 
-        ? (fs::path(config_.output_dir) / config_.subfolder_name).string() : config_.output_dir) << std::endl;
+        std::cout << "[INFO] Frames extracted to: " << getTargetDir() << std::endl;
     } else {
-        std::cerr << "[ERROR] Extraction failed!" << std::endl;
+        std::cerr << "[ERROR] Extraction failed! (" << result.describe() << ")" << std::endl;
+    }
+
+    return result.success();
+}
+
+// ============================================================================
+// PARALLEL EXECUTION
+// ============================================================================
+
+bool ExtractFramesJob::executeParallel() {
+    // Images of an earlier run may sit in the target directory: only those written from now on are checked
+    // (with a margin for file systems storing coarse modification times)
+    const fs::file_time_type runStart = fs::file_time_type::clock::now() - std::chrono::seconds(2);
+
+    // 1. Keyframe-aligned segments of about the same length
+    Core::Trace::Span step = traceStep("probe packets");
+    ::Jobs::PacketIndex index = ::Jobs::ProbeJob::probePackets(config_.input_path);
+    step.end();
+    if (index.packets.empty()) {
+        std::cout << "[INFO] No video packet found, extracting in a single process" << std::endl;
+        return executeSingle();
+    }
+
+    double end = index.packets.back() + Pipeline::SEGMENT_BOUNDARY_MARGIN;
+    double target = end / config_.parallel_segments;
+    std::vector<double> starts = Pipeline::planSegmentStarts(index.keyframes, 0.0, end, target);
+    if (starts.size() < 2) {
+        std::cout << "[INFO] Too few keyframes to split, extracting in a single process" << std::endl;
+        return executeSingle();
+    }
+
+    // 2. Frames of each segment, counted from the packet timestamps, give the first image number
+    std::vector<double> bounds;
+    for (size_t i = 1; i < starts.size(); ++i) {
+        bounds.push_back(starts[i] - Pipeline::SEGMENT_BOUNDARY_MARGIN);
+    }
+    std::vector<int64_t> firstNumbers = { 0 };
+    for (double bound : bounds) {
+        auto it = std::lower_bound(index.packets.begin(), index.packets.end(), bound);
+        firstNumbers.push_back(static_cast<int64_t>(it - index.packets.begin()));
+    }
+
+    std::string targetDir = getTargetDir();
+    fs::path logDir = fs::path(targetDir) / "logs";
+    std::cout << "[INFO] Parallel extraction: " << starts.size() << " segments, " << index.packets.size() << " frames" << std::endl;
+
+    auto progress = std::make_shared<Pipeline::SegmentProgress>();
+    progress->segments.resize(starts.size());
+    progress->duration_seconds = end;
+
+    Pipeline::BatchOptions options;
+    options.concurrency = static_cast<unsigned>(starts.size());
+    options.max_retries = 1; // A retry rewrites the same image numbers
+    options.log_dir = logDir;
+    options.resources = getCpuAllocation(); // Segments share the CPUs planned for this job
+    options.should_stop = [this]() { return isCancelled(); };
+    Pipeline::BatchRunner runner(options);
+
+    for (size_t i = 0; i < starts.size(); ++i) {
+        ExtractFramesJob segment(*this);
+        segment.config_.parallel_segments = 0;
+        segment.config_.start_time = i == 0 ? 0.0 : bounds[i - 1];
+        segment.config_.duration = i + 1 < starts.size() ? bounds[i] - segment.config_.start_time : 0.0;
+        segment.config_.start_number = firstNumbers[i];
+
+        if (hasProgressCallback()) {
+            segment.setProgressCallback([this, progress, i](const Core::Progress& p) {
+                std::lock_guard<std::mutex> lock(progress->mutex);
+                progress->segments[i] = p;
+                reportProgress(progress->merged());
+            });
+        } else {
+            segment.setProgressCallback(nullptr);
+        }
+
+        std::ostringstream name;
+        name << "segment_" << std::setw(4) << std::setfill('0') << i;
+        runner.add(std::make_unique<ExtractFramesJob>(std::move(segment)), name.str());
+    }
+
+    step = traceStep("extract segments");
+    Pipeline::BatchSummary summary = runner.run();
+    step.end();
+    for (const auto& result : summary.results) {
+        addMetrics(result.metrics);
+    }
+
+    if (hasProgressCallback()) {
+        std::lock_guard<std::mutex> lock(progress->mutex);
+        Core::Progress last = progress->merged();
+        last.finished = true;
+        reportProgress(last);
+    }
+
+    if (!summary.allSucceeded()) {
+        for (const auto& result : summary.results) {
+            if (!result.success && !result.cancelled)
+                std::cerr << "[ERROR] " << result.name << " failed after " << result.attempts << " attempt(s), see " << result.log_file.string() << std::endl;
+        }
+        std::cerr << "[ERROR] Parallel extraction failed!" << std::endl;
+        return false;
+    }
+
+    // 3. Numbering must be continuous and match the frame count reported by the container
+    int64_t expected = static_cast<int64_t>(index.packets.size());
+    ::Jobs::ProbeResult probe = ::Jobs::ProbeJob::probe(config_.input_path);
+    const ::Jobs::ProbeStream* video = probe.firstStream("video");
+    if (video && video->nb_frames > 0) {
+        expected = video->nb_frames;
+    }
+
+    std::string extension = getFileExtension();
+    auto imagePath = [&](int64_t number) {
+        std::ostringstream name;
+        name << std::setw(8) << std::setfill('0') << number << extension;
+        return fs::path(targetDir) / name.str();
+    };
+    auto writtenByRun = [&](const fs::path& image) {
+        std::error_code ec;
+        fs::file_time_type written = fs::last_write_time(image, ec);
+        return !ec && written >= runStart;
+    };
+
+    int64_t missing = 0;
+    for (int64_t n = 0; n < expected; ++n) {
+        if (!writtenByRun(imagePath(n))) {
+            missing++;
+        }
+    }
+    int64_t extra = 0;
+    for (int64_t n = expected; fs::exists(imagePath(n)); ++n) {
+        if (writtenByRun(imagePath(n))) {
+            extra++;
+        }
+    }
+
+    if (missing > 0 || extra > 0) {
+        std::cerr << "[ERROR] Frame numbering check failed: " << expected << " frames expected, "
+                  << missing << " missing, " << extra << " extra (logs in " << logDir.string() << ")" << std::endl;
+        return false;
     }
 
-    return success;
+    std::error_code ec;
+    fs::remove_all(logDir, ec);
+
+    std::cout << "[SUCCESS] Extraction completed successfully! (" << expected << " frames, " << starts.size() << " segments, "
+              << std::fixed << std::setprecision(1) << summary.wall_seconds << " s)" << std::endl;
+    std::cout << "[INFO] Frames extracted to: " << targetDir << std::endl;
+    return true;
 }
 
 } // namespace Jobs
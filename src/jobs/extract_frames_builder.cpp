@@ -1,4 +1,5 @@
 #include "../../include/jobs/extract_frames.hpp"
+#include <stdexcept>
 
 namespace FFmpegMulti {
 namespace Jobs {
@@ -32,6 +33,14 @@ ExtractFramesBuilder& ExtractFramesBuilder::format(ImageFormat fmt) {
     return *this;
 }
 
+ExtractFramesBuilder& ExtractFramesBuilder::parallel(int segments) {
+    if (segments < 0) {
+        throw std::invalid_argument("Number of parallel segments cannot be negative");
+    }
+    config_.parallel_segments = segments;
+    return *this;
+}
+
 // ============================================================================
 // FORMAT SHORTCUTS
 // ============================================================================
@@ -0,0 +1,284 @@
+#include "../../include/jobs/ladder.hpp"
+#include "../../include/jobs/codec_utils.hpp"
+#include "../../include/jobs/probe.hpp"
+#include "../../include/jobs/reencode.hpp"
+#include "../../include/jobs/streaming.hpp"
+#include "../../include/core/ffmpeg_process.hpp"
+#include "../../include/core/path_utils.hpp"
+#include "../../include/pipeline/segments.hpp"
+#include <algorithm>
+#include <filesystem>
+#include <iostream>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+namespace fs = std::filesystem;
+
+namespace FFmpegMulti {
+namespace Jobs {
+
+// ============================================================================
+// CONSTRUCTORS
+// ============================================================================
+
+LadderJob::LadderJob(const std::string& input_path) : input_path_(input_path) {}
+
+// ============================================================================
+// CONFIGURATION
+// ============================================================================
+
+void LadderJob::setInputPath(const std::string& path) {
+    input_path_ = path;
+}
+
+std::string LadderJob::getInputPath() const {
+    return input_path_;
+}
+
+void LadderJob::addRendition(const Rendition& rendition) {
+    renditions_.push_back(rendition);
+}
+
+const std::vector<Rendition>& LadderJob::renditions() const {
+    return renditions_;
+}
+
+void LadderJob::setMasterPlaylist(const std::string& path) {
+    master_playlist_ = path;
+}
+
+// ============================================================================
+// COMMAND CONSTRUCTION
+// ============================================================================
+
+std::string LadderJob::buildFilterGraph() const {
+    // [0:v:0]split=3[s0][s1][s2];[s0]scale=-2:1080[v0];[s1]scale=-2:720[v1];...
+    std::ostringstream graph;
+    if (renditions_.size() > 1) {
+        graph << "[0:v:0]split=" << renditions_.size();
+        for (size_t i = 0; i < renditions_.size(); ++i)
+            graph << "[s" << i << "]";
+        graph << ";";
+    }
+    for (size_t i = 0; i < renditions_.size(); ++i) {
+        const Rendition& rendition = renditions_[i];
+        if (i > 0)
+            graph << ";";
+        graph << (renditions_.size() > 1 ? "[s" + std::to_string(i) + "]" : std::string("[0:v:0]"));
+        if (rendition.width > 0 || rendition.height > 0) {
+            // -2 keeps the aspect ratio with an even size, as 4:2:0 encoders require
+            graph << "scale=" << (rendition.width > 0 ? rendition.width : -2) << ":" << (rendition.height > 0 ? rendition.height : -2);
+        } else {
+            graph << "null";
+        }
+        graph << "[v" << i << "]";
+    }
+    return graph.str();
+}
+
+std::vector<std::string> LadderJob::buildCommand() const {
+    std::vector<std::string> args = { "-y" };
+
+    // Input range shared by every output: one decode for all of them
+    const Encode::EncodeConfig& first = renditions_.front().config;
+    if (first.start_time > 0.0)
+        args.insert(args.end(), { "-ss", Pipeline::formatSeconds(first.start_time) });
+    if (first.duration > 0.0)
+        args.insert(args.end(), { "-t", Pipeline::formatSeconds(first.duration) });
+    args.insert(args.end(), { "-i", input_path_, "-filter_complex", buildFilterGraph() });
+
+    for (size_t i = 0; i < renditions_.size(); ++i) {
+        const Rendition& rendition = renditions_[i];
+        args.insert(args.end(), { "-map", "[v" + std::to_string(i) + "]" });
+        if (!rendition.config.audio.disabled)
+            args.insert(args.end(), { "-map", "0:a:0?" });
+
+        // The renditions share the threads planned for the job
+        ReencodeJob output(input_path_, rendition.output_path);
+        output.setConfig(rendition.config);
+        if (getCpuAllocation().threads > 0) {
+            Core::CpuAllocation share;
+            share.threads = std::max<unsigned>(1, getCpuAllocation().threads / static_cast<unsigned>(renditions_.size()));
+            output.setCpuAllocation(share);
+        }
+        std::vector<std::string> outputArgs = output.buildOutputArgs();
+        args.insert(args.end(), outputArgs.begin(), outputArgs.end());
+    }
+    return args;
+}
+
+std::string LadderJob::getCommandString() const {
+    ffmpegProcess process(PathUtils::getToolPath("ffmpeg"), buildCommand());
+    return process.getCommandString();
+}
+
+// ============================================================================
+// VALIDATION
+// ============================================================================
+
+bool LadderJob::validate() const {
+    if (input_path_.empty())
+        throw std::runtime_error("Input path is empty");
+    if (renditions_.empty())
+        throw std::runtime_error("A ladder needs at least one rendition");
+
+    std::set<std::string> outputs;
+    const Encode::EncodeConfig& first = renditions_.front().config;
+    for (const auto& rendition : renditions_) {
+        const Encode::EncodeConfig& config = rendition.config;
+        if (rendition.output_path.empty())
+            throw std::runtime_error("Rendition output path is empty");
+        if (!outputs.insert(fs::absolute(rendition.output_path).lexically_normal().string()).second)
+            throw std::runtime_error("Two renditions write " + rendition.output_path);
+        if (rendition.width < 0 || rendition.height < 0)
+            throw std::runtime_error("Rendition size cannot be negative");
+        if ((config.rate_control == Encode::RateControl::VBR || config.rate_control == Encode::RateControl::CBR) && config.bitrate_kbps <= 0)
+            throw std::runtime_error("Bitrate must be > 0 for VBR/CBR modes");
+        if (config.start_time != first.start_time || config.duration != first.duration)
+            throw std::runtime_error("Every rendition of a ladder covers the same range of the source");
+        if (config.chunk_seconds > 0.0 || config.target_quality || config.output_cache)
+            throw std::runtime_error("Chunked encoding, target quality and the output cache are not available in a ladder");
+        
+        // Players switch renditions on segment boundaries, which must be the same keyframes everywhere
+        if (config.streaming.has_value() != first.streaming.has_value() ||
+            (config.streaming && config.streaming->segment_seconds != first.streaming->segment_seconds))
+            throw std::runtime_error("Streaming renditions of a ladder need the same segment duration");
+        if (config.streaming && config.streaming->segment_seconds <= 0.0)
+            throw std::runtime_error("Streaming segment duration must be > 0");
+        if (!master_playlist_.empty() && (!config.streaming || config.streaming->format != Encode::StreamingFormat::HLS))
+            throw std::runtime_error("A master playlist lists HLS renditions only");
+    }
+    return true;
+}
+
+// ============================================================================
+// EXECUTION
+// ============================================================================
+
+unsigned LadderJob::threadDemand() const {
+    unsigned demand = 0;
+    for (const auto& rendition : renditions_) {
+        const Encode::EncodeConfig& config = rendition.config;
+        demand += config.threads > 0 ? static_cast<unsigned>(config.threads) : Codec::CodecUtils::getTypicalThreadUsage(config.codec, config.preset);
+    }
+    return std::max(1u, std::min(demand, Core::availableCores()));
+}
+
+std::string LadderJob::encoderName() const {
+    std::string name;
+    for (const auto& rendition : renditions_) {
+        ReencodeJob output(input_path_, rendition.output_path);
+        output.setConfig(rendition.config);
+        std::string encoder = output.encoderName();
+        if (("+" + name + "+").find("+" + encoder + "+") == std::string::npos)
+            name += (name.empty() ? "" : "+") + encoder;
+    }
+    return name;
+}
+
+void LadderJob::removePartials() const {
+    for (const auto& rendition : renditions_) {
+        std::error_code ec;
+        fs::remove(PathUtils::getPartialPath(rendition.output_path), ec);
+        if (rendition.config.streaming)
+            Streaming::removeSegments(rendition.config.streaming->format, rendition.output_path);
+    }
+}
+
+bool LadderJob::execute() {
+    try {
+        validate();
+        for (const auto& rendition : renditions_) {
+            if (!rendition.config.overwrite && fs::exists(rendition.output_path)) {
+                std::cerr << "[ERROR] Output file already exists (enable overwrite to replace it): " << rendition.output_path << std::endl;
+                return false;
+            }
+        }
+
+        // Segments of an earlier encode would mix with the new ones
+        for (const auto& rendition : renditions_) {
+            if (rendition.config.streaming)
+                Streaming::removeSegments(rendition.config.streaming->format, rendition.output_path);
+        }
+        
+        ffmpegProcess process(PathUtils::getToolPath("ffmpeg"), buildCommand());
+        std::cout << "[INFO] Ladder command: " << process.getCommandString() << std::endl;
+
+        if (hasProgressCallback()) {
+            const Encode::EncodeConfig& first = renditions_.front().config;
+            double duration = first.duration > 0.0 ? first.duration : ::Jobs::ProbeJob::probeDuration(input_path_) - first.start_time;
+            trackProgress(process, duration);
+        }
+
+        ProcessResult result = runProcess(process);
+        if (!result.success()) {
+            std::cerr << "[ERROR] Ladder encode failed! (" << result.describe() << ")" << std::endl;
+            removePartials();
+            return false;
+        }
+
+        bool committed = true;
+        for (const auto& rendition : renditions_) {
+            if (!PathUtils::commitPartial(PathUtils::getPartialPath(rendition.output_path), rendition.output_path)) {
+                std::cerr << "[ERROR] Cannot move the finished encode to " << rendition.output_path
+                          << " (kept as " << PathUtils::getPartialPath(rendition.output_path).string() << ")" << std::endl;
+                committed = false;
+            }
+        }
+        if (!committed)
+            return false;
+        
+        if (!master_playlist_.empty()) {
+            std::vector<fs::path> playlists;
+            for (const auto& rendition : renditions_)
+                playlists.push_back(rendition.output_path);
+            std::string error;
+            if (!Streaming::writeMasterPlaylist(playlists, master_playlist_, error)) {
+                std::cerr << "[ERROR] Master playlist failed: " << error << std::endl;
+                return false;
+            }
+            std::cout << "[INFO] Master playlist: " << master_playlist_ << std::endl;
+        }
+
+        std::cout << "[SUCCESS] " << renditions_.size() << " rendition(s) encoded from a single decode" << std::endl;
+        return true;
+
+    } catch (const std::exception& e) {
+        std::cerr << "[ERROR] Ladder encode failed: " << e.what() << std::endl;
+        return false;
+    }
+}
+
+// ============================================================================
+// LADDER BUILDER
+// ============================================================================
+
+LadderBuilder& LadderBuilder::input(const std::string& path) {
+    job_.setInputPath(path);
+    return *this;
+}
+
+LadderBuilder& LadderBuilder::rendition(const std::string& output, int width, int height, const Encode::EncodeConfig& config) {
+    Rendition rendition;
+    rendition.output_path = output;
+    rendition.width = width;
+    rendition.height = height;
+    rendition.config = config;
+    job_.addRendition(rendition);
+    return *this;
+}
+
+LadderBuilder& LadderBuilder::masterPlaylist(const std::string& path) {
+    job_.setMasterPlaylist(path);
+    return *this;
+}
+
+LadderJob LadderBuilder::build() {
+    job_.validate();
+    return job_;
+}
+
+} // namespace Jobs
+} // namespace FFmpegMulti
@@ -1,22 +1,118 @@
 #include "jobs/probe.hpp"
+#include "jobs/probe_cache.hpp"
 #include "core/path_utils.hpp"
+#include "core/ffmpeg_process.hpp"
+#include "core/json.hpp"
 #include <iostream>
 #include <fstream>
 #include <sstream>
 #include <iomanip>
 #include <filesystem>
+#include <stdexcept>
+#include <algorithm>
 #include <cstdlib>
-#include <array>
-#include <memory>
-
-#ifdef _WIN32
-#include <windows.h>
-#endif
 
 namespace fs = std::filesystem;
 
 namespace Jobs {
 
+// ============================================================================
+// PROBE RESULT
+// ============================================================================
+
+double ProbeStream::frameRate() const {
+    size_t slash = r_frame_rate.find('/');
+    if (slash == std::string::npos) {
+        return std::strtod(r_frame_rate.c_str(), nullptr);
+    }
+    
+    double num = std::strtod(r_frame_rate.c_str(), nullptr);
+    double den = std::strtod(r_frame_rate.c_str() + slash + 1, nullptr);
+    return den > 0.0 ? num / den : 0.0;
+}
+
+std::string ProbeStream::dynamicRange() const {
+    if (color_transfer == "smpte2084") {
+        return "HDR10";
+    }
+    if (color_transfer == "arib-std-b67") {
+        return "HLG";
+    }
+    return "SDR";
+}
+
+ProbeResult ProbeResult::fromJson(const std::string& json) {
+    using FFmpegMulti::Json::Value;
+    
+    Value root = Value::parse(json);
+    ProbeResult result;
+    
+    const Value& format = root["format"];
+    result.format.filename = format["filename"].asString();
+    result.format.format_name = format["format_name"].asString();
+    result.format.format_long_name = format["format_long_name"].asString();
+    result.format.duration = format["duration"].asNumber();
+    result.format.start_time = format["start_time"].asNumber();
+    result.format.size = format["size"].asInt();
+    result.format.bit_rate = format["bit_rate"].asInt();
+    result.format.nb_streams = static_cast<int>(format["nb_streams"].asInt());
+    
+    const Value& streams = root["streams"];
+    result.streams.reserve(streams.size());
+    for (const Value& s : streams.items()) {
+        ProbeStream stream;
+        stream.index = static_cast<int>(s["index"].asInt(-1));
+        stream.codec_type = s["codec_type"].asString();
+        stream.codec_name = s["codec_name"].asString();
+        stream.codec_long_name = s["codec_long_name"].asString();
+        stream.profile = s["profile"].asString();
+        stream.bit_rate = s["bit_rate"].asInt();
+        stream.duration = s["duration"].asNumber();
+        stream.nb_frames = s["nb_frames"].asInt();
+        
+        stream.width = static_cast<int>(s["width"].asInt());
+        stream.height = static_cast<int>(s["height"].asInt());
+        stream.pix_fmt = s["pix_fmt"].asString();
+        stream.r_frame_rate = s["r_frame_rate"].asString();
+        stream.avg_frame_rate = s["avg_frame_rate"].asString();
+        stream.color_range = s["color_range"].asString();
+        stream.color_space = s["color_space"].asString();
+        stream.color_transfer = s["color_transfer"].asString();
+        stream.color_primaries = s["color_primaries"].asString();
+        
+        stream.sample_rate = static_cast<int>(s["sample_rate"].asInt());
+        stream.channels = static_cast<int>(s["channels"].asInt());
+        stream.channel_layout = s["channel_layout"].asString();
+        
+        const Value& tags = s["tags"];
+        stream.language = tags["language"].asString();
+        stream.title = tags["title"].asString();
+        
+        result.streams.push_back(std::move(stream));
+    }
+    
+    return result;
+}
+
+const ProbeStream* ProbeResult::firstStream(const std::string& codec_type) const {
+    for (const auto& stream : streams) {
+        if (stream.codec_type == codec_type) {
+            return &stream;
+        }
+    }
+    return nullptr;
+}
+
+int ProbeResult::countStreams(const std::string& codec_type) const {
+    return static_cast<int>(std::count_if(streams.begin(), streams.end(), [&codec_type](const ProbeStream& stream) {
+        return stream.codec_type == codec_type;
+    }));
+}
+
+// ============================================================================
+// PROBE JOB
+// ============================================================================
+
 ProbeJob::ProbeJob(const std::string& inputFile)
     : inputFile_(inputFile)
     , shouldExport_(false)
@@ -24,36 +120,111 @@ ProbeJob::ProbeJob(const std::string& inputFile)
 }
 
 void ProbeJob::execute() {
-    executeFFProbe();
+    std::cout << "[INFO] Analyzing media with FFProbe..." << std::endl;
+    output_ = runFFProbe(inputFile_, true);
+    result_ = ProbeResult::fromJson(output_);
+    ProbeCache::instance().store(inputFile_, result_);
     parseAndFormatOutput();
     
     // Display formatted output
     std::cout << formattedOutput_ << std::endl;
 }
 
-std::string ProbeJob::buildFFProbeCommand() const {
+std::vector<std::string> ProbeJob::buildFFProbeArgs(const std::string& inputFile) {
     std::vector<std::string> args;
     
-    // Path to ffprobe (using PathUtils to get correct path)
-    std::filesystem::path externPath = FFmpegMulti::PathUtils::getExternPath();
-    std::string ffprobePath = (externPath / "ffprobe.exe").string();
-    
-    args.push_back(ffprobePath);
     args.push_back("-v");
     args.push_back("quiet");
     args.push_back("-print_format");
     args.push_back("json");
     args.push_back("-show_format");
     args.push_back("-show_streams");
-    args.push_back("\"" + inputFile_ + "\"");
+    args.push_back(inputFile);
     
-    std::string cmd;
-    for (const auto& arg : args) {
-        if (!cmd.empty()) cmd += " ";
-        cmd += arg;
+    return args;
+}
+
+ProbeResult ProbeJob::probe(const std::string& inputFile) {
+    ProbeCache& cache = ProbeCache::instance();
+    if (auto cached = cache.lookup(inputFile)) {
+        return *cached;
     }
     
-    return cmd;
+    ProbeResult result = ProbeResult::fromJson(runFFProbe(inputFile));
+    cache.store(inputFile, result);
+    return result;
+}
+
+double ProbeJob::probeDuration(const std::string& inputFile) {
+    try {
+        return probe(inputFile).format.duration;
+    } catch (const std::exception&) {
+        return 0.0; // Unreadable file or no known duration
+    }
+}
+
+std::vector<double> ProbeJob::probeKeyframes(const std::string& inputFile) {
+    return probePackets(inputFile).keyframes;
+}
+
+PacketIndex ProbeJob::probePackets(const std::string& inputFile) {
+    // Packets only: no decoding, so this stays fast on long files
+    std::vector<std::string> args = {
+        "-v", "error",
+        "-select_streams", "v:0",
+        "-show_entries", "format=start_time:packet=pts_time,flags",
+        "-of", "compact",
+        inputFile
+    };
+    
+    ffmpegProcess ffprobe(FFmpegMulti::PathUtils::getToolPath("ffprobe"), args);
+    ffprobe.setEcho(false);
+    ffprobe.setCaptureOutput(true);
+    
+    ProcessResult result = ffprobe.run();
+    if (!result.success()) {
+        throw std::runtime_error("ffprobe failed on " + inputFile + " (" + result.describe() + ")");
+    }
+    
+    // Lines look like "packet|pts_time=12.345000|flags=K__" and "format|start_time=0.000000"
+    PacketIndex index;
+    double startTime = 0.0;
+    std::istringstream lines(result.output);
+    std::string line;
+    while (std::getline(lines, line)) {
+        if (line.rfind("format|", 0) == 0) {
+            size_t pos = line.find("start_time=");
+            if (pos != std::string::npos) {
+                startTime = std::strtod(line.c_str() + pos + 11, nullptr);
+            }
+            continue;
+        }
+        
+        size_t flags = line.find("flags=");
+        size_t pts = line.find("pts_time=");
+        if (line.rfind("packet|", 0) != 0 || flags == std::string::npos || pts == std::string::npos) {
+            continue;
+        }
+        if (line.compare(pts + 9, 3, "N/A") == 0) {
+            continue;
+        }
+        double time = std::strtod(line.c_str() + pts + 9, nullptr);
+        index.packets.push_back(time);
+        if (line.compare(flags + 6, 1, "K") == 0) {
+            index.keyframes.push_back(time);
+        }
+    }
+    
+    // Input seeking (-ss) counts from the container start time
+    for (auto& time : index.packets) {
+        time -= startTime;
+    }
+    for (auto& time : index.keyframes) {
+        time -= startTime;
+    }
+    std::sort(index.packets.begin(), index.packets.end());
+    std::sort(index.keyframes.begin(), index.keyframes.end());
+    return index;
 }
 
 std::string ProbeJob::readFileContent(const std::string& filePath) const {
@@ -86,32 +257,6 @@ std::string ProbeJob::generateExportPath(bool isJson) const {
     return exportPath.string();
 }
 
-std::string ProbeJob::extractJsonValue(const std::string& json, const std::string& key) const {
-    std::string searchKey = "\"" + key + "\":";
-    size_t pos = json.find(searchKey);
-    if (pos == std::string::npos) return "N/A";
-    
-    pos += searchKey.length();
-    while (pos < json.length() && (json[pos] == ' ' || json[pos] == '\t')) pos++;
-    
-    if (pos >= json.length()) return "N/A";
-    
-    // Handle string values
-    if (json[pos] == '"') {
-        pos++;
-        size_t endPos = json.find('"', pos);
-        if (endPos == std::string::npos) return "N/A";
-        return json.substr(pos, endPos - pos);
-    }
-    
-    // Handle numeric values
-    size_t endPos = pos;
-    while (endPos < json.length() && (isdigit(json[endPos]) || json[endPos] == '.' || json[endPos] == '-')) {
-        endPos++;
-    }
-    return json.substr(pos, endPos - pos);
-}
-
 std::string ProbeJob::formatBytes(long long bytes) const {
     const char* units[] = {"B", "KB", "MB", "GB", "TB"};
     int unitIndex = 0;
@@ -157,109 +302,69 @@ void ProbeJob::parseAndFormatOutput() {
     formatted << BLUE << "║  " << CYAN << BOLD << "📊 MEDIA INFORMATION" << RESET << BLUE << "                            ║" << RESET << "\n";
     formatted << BLUE << "╚═══════════════════════════════════════════════════════╝" << RESET << "\n\n";
     
-    // Extract format info
-    std::string filename = extractJsonValue(output_, "filename");
-    std::string formatName = extractJsonValue(output_, "format_name");
-    std::string formatLongName = extractJsonValue(output_, "format_long_name");
-    std::string durationStr = extractJsonValue(output_, "duration");
-    std::string sizeStr = extractJsonValue(output_, "size");
-    std::string bitRateStr = extractJsonValue(output_, "bit_rate");
+    const ProbeFormat& format = result_.format;
+    auto orNA = [](const std::string& value) { return value.empty() ? std::string("N/A") : value; };
     
     formatted << GREEN << "📁 File" << RESET << "\n";
-    formatted << "   " << filename << "\n\n";
+    formatted << "   " << orNA(format.filename) << "\n\n";
     
     formatted << GREEN << "🎬 Format" << RESET << "\n";
-    formatted << "   Type      : " << formatName << "\n";
-    formatted << "   Name      : " << formatLongName << "\n";
+    formatted << "   Type      : " << orNA(format.format_name) << "\n";
+    formatted << "   Name      : " << orNA(format.format_long_name) << "\n";
     
-    if (durationStr != "N/A") {
-        double duration = std::stod(durationStr);
-        formatted << "   Duration  : " << formatDuration(duration) << "\n";
+    if (format.duration > 0.0) {
+        formatted << "   Duration  : " << formatDuration(format.duration) << "\n";
     }
     
-    if (sizeStr != "N/A") {
-        long long size = std::stoll(sizeStr);
-        formatted << "   Size      : " << formatBytes(size) << "\n";
+    if (format.size > 0) {
+        formatted << "   Size      : " << formatBytes(format.size) << "\n";
     }
     
-    if (bitRateStr != "N/A") {
-        long long bitRate = std::stoll(bitRateStr);
-        formatted << "   Bitrate   : " << (bitRate / 1000) << " kb/s\n";
+    if (format.bit_rate > 0) {
+        formatted << "   Bitrate   : " << (format.bit_rate / 1000) << " kb/s\n";
     }
     
     // Count streams
-    int videoStreams = 0;
-    int audioStreams = 0;
-    int subtitleStreams = 0;
-    
-    size_t pos = 0;
-    while ((pos = output_.find("\"codec_type\"", pos)) != std::string::npos) {
-        std::string codecType = extractJsonValue(output_.substr(pos), "codec_type");
-        if (codecType == "video") videoStreams++;
-        else if (codecType == "audio") audioStreams++;
-        else if (codecType == "subtitle") subtitleStreams++;
-        pos += 12;
-    }
-    
     formatted << "\n" << GREEN << "🎞️  Streams" << RESET << "\n";
-    formatted << "   Video     : " << videoStreams << "\n";
-    formatted << "   Audio     : " << audioStreams << "\n";
-    formatted << "   Subtitle  : " << subtitleStreams << "\n";
-    
-    // Extract first video stream info
-    pos = output_.find("\"codec_type\": \"video\"");
-    if (pos != std::string::npos) {
-        std::string videoSection = output_.substr(pos, 1000);
-        std::string codecName = extractJsonValue(videoSection, "codec_name");
-        std::string codecLongName = extractJsonValue(videoSection, "codec_long_name");
-        std::string width = extractJsonValue(videoSection, "width");
-        std::string height = extractJsonValue(videoSection, "height");
-        std::string pixFmt = extractJsonValue(videoSection, "pix_fmt");
-        std::string rFrameRate = extractJsonValue(videoSection, "r_frame_rate");
-        
+    formatted << "   Video     : " << result_.countStreams("video") << "\n";
+    formatted << "   Audio     : " << result_.countStreams("audio") << "\n";
+    formatted << "   Subtitle  : " << result_.countStreams("subtitle") << "\n";
+    
+    // First video stream info
+    if (const ProbeStream* video = result_.firstStream("video")) {
         formatted << "\n" << YELLOW << "📹 Video" << RESET << "\n";
-        formatted << "   Codec     : " << codecName;
-        if (codecLongName != "N/A") formatted << " (" << codecLongName << ")";
+        formatted << "   Codec     : " << orNA(video->codec_name);
+        if (!video->codec_long_name.empty()) formatted << " (" << video->codec_long_name << ")";
         formatted << "\n";
         
-        if (width != "N/A" && height != "N/A") {
-            formatted << "   Resolution: " << width << "x" << height << "\n";
+        if (video->width > 0 && video->height > 0) {
+            formatted << "   Resolution: " << video->width << "x" << video->height << "\n";
         }
         
-        if (pixFmt != "N/A") {
-            formatted << "   Format    : " << pixFmt << "\n";
+        if (!video->pix_fmt.empty()) {
+            formatted << "   Format    : " << video->pix_fmt << "\n";
         }
         
-        if (rFrameRate != "N/A" && rFrameRate.find('/') != std::string::npos) {
-            size_t slashPos = rFrameRate.find('/');
-            double num = std::stod(rFrameRate.substr(0, slashPos));
-            double den = std::stod(rFrameRate.substr(slashPos + 1));
-            formatted << "   FPS       : " << std::fixed << std::setprecision(2) << (num / den) << "\n";
+        double fps = video->frameRate();
+        if (fps > 0.0) {
+            formatted << "   FPS       : " << std::fixed << std::setprecision(2) << fps << "\n";
         }
     }
     
-    // Extract first audio stream info
-    pos = output_.find("\"codec_type\": \"audio\"");
-    if (pos != std::string::npos) {
-        std::string audioSection = output_.substr(pos, 1000);
-        std::string codecName = extractJsonValue(audioSection, "codec_name");
-        std::string codecLongName = extractJsonValue(audioSection, "codec_long_name");
-        std::string sampleRate = extractJsonValue(audioSection, "sample_rate");
-        std::string channels = extractJsonValue(audioSection, "channels");
-        std::string channelLayout = extractJsonValue(audioSection, "channel_layout");
-        
+    // First audio stream info
+    if (const ProbeStream* audio = result_.firstStream("audio")) {
         formatted << "\n" << MAGENTA << "🔊 Audio" << RESET << "\n";
-        formatted << "   Codec     : " << codecName;
-        if (codecLongName != "N/A") formatted << " (" << codecLongName << ")";
+        formatted << "   Codec     : " << orNA(audio->codec_name);
+        if (!audio->codec_long_name.empty()) formatted << " (" << audio->codec_long_name << ")";
         formatted << "\n";
         
-        if (sampleRate != "N/A") {
-            formatted << "   Sample Rate: " << sampleRate << " Hz\n";
+        if (audio->sample_rate > 0) {
+            formatted << "   Sample Rate: " << audio->sample_rate << " Hz\n";
         }
         
-        if (channels != "N/A") {
-            formatted << "   Channels  : " << channels;
-            if (channelLayout != "N/A") formatted << " (" << channelLayout << ")";
+        if (audio->channels > 0) {
+            formatted << "   Channels  : " << audio->channels;
+            if (!audio->channel_layout.empty()) formatted << " (" << audio->channel_layout << ")";
             formatted << "\n";
         }
     }
@@ -268,82 +373,24 @@ void ProbeJob::parseAndFormatOutput() {
     formattedOutput_ = formatted.str();
 }
 
-void ProbeJob::executeFFProbe() {
-    std::cout << "[INFO] Analyzing media with FFProbe..." << std::endl;
-    
-    std::string cmd = buildFFProbeCommand();
-    
-    std::cout << "[CMD] " << cmd << std::endl;
-    
-    // Execute command and capture output
-    std::string output;
-    
-#ifdef _WIN32
-    // Create pipe for reading output
-    HANDLE hReadPipe, hWritePipe;
-    SECURITY_ATTRIBUTES sa = { sizeof(SECURITY_ATTRIBUTES), NULL, TRUE };
-    
-    if (!CreatePipe(&hReadPipe, &hWritePipe, &sa, 0)) {
-        throw std::runtime_error("Failed to create pipe");
-    }
-    
-    STARTUPINFOA si = { 0 };
-    si.cb = sizeof(STARTUPINFOA);
-    si.dwFlags = STARTF_USESTDHANDLES;
-    si.hStdOutput = hWritePipe;
-    si.hStdError = hWritePipe;
-    
-    PROCESS_INFORMATION pi = { 0 };
-    
-    if (!CreateProcessA(NULL, const_cast<char*>(cmd.c_str()), NULL, NULL, TRUE, 
-                        CREATE_NO_WINDOW, NULL, NULL, &si, &pi)) {
-        CloseHandle(hReadPipe);
-        CloseHandle(hWritePipe);
-        throw std::runtime_error("Failed to execute FFProbe");
-    }
-    
-    CloseHandle(hWritePipe);
-    
-    // Read output
-    char buffer[4096];
-    DWORD bytesRead;
-    
-    while (ReadFile(hReadPipe, buffer, sizeof(buffer) - 1, &bytesRead, NULL) && bytesRead > 0) {
-        buffer[bytesRead] = '\0';
-        output += buffer;
-    }
-    
-    WaitForSingleObject(pi.hProcess, INFINITE);
-    
-    DWORD exitCode;
-    GetExitCodeProcess(pi.hProcess, &exitCode);
-    
-    CloseHandle(hReadPipe);
-    CloseHandle(pi.hProcess);
-    CloseHandle(pi.hThread);
+std::string ProbeJob::runFFProbe(const std::string& inputFile, bool verbose) {
+    // Path to ffprobe (using PathUtils to get correct path)
+    ffmpegProcess ffprobe(FFmpegMulti::PathUtils::getToolPath("ffprobe"), buildFFProbeArgs(inputFile));
+    ffprobe.setEcho(false);
+    ffprobe.setCaptureOutput(true);
     
-    if (exitCode != 0) {
-        throw std::runtime_error("FFProbe failed with exit code: " + std::to_string(exitCode));
-    }
-#else
-    // Unix-like systems
-    FILE* pipe = popen(cmd.c_str(), "r");
-    if (!pipe) {
-        throw std::runtime_error("Failed to execute FFProbe");
+    if (verbose) {
+        std::cout << "[CMD] " << ffprobe.getCommandString() << std::endl;
     }
     
-    char buffer[4096];
-    while (fgets(buffer, sizeof(buffer), pipe) != nullptr) {
-        output += buffer;
-    }
+    // Execute command and capture output
+    ProcessResult result = ffprobe.run();
     
-    int exitCode = pclose(pipe);
-    if (exitCode != 0) {
-        throw std::runtime_error("FFProbe failed with exit code: " + std::to_string(exitCode));
+    if (!result.success()) {
+        throw std::runtime_error("FFProbe failed (" + result.describe() + ")");
     }
-#endif
     
-    output_ = output;
+    return std::move(result.output);
 }
 
 } // namespace Jobs
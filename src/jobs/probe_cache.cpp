@@ -0,0 +1,435 @@
+#include "jobs/probe_cache.hpp"
+#include "core/path_utils.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <system_error>
+
+#ifndef _WIN32
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace fs = std::filesystem;
+
+namespace Jobs {
+
+namespace {
+
+// Bump when the layout of ProbeResult or of the file changes: older files are then discarded
+const char CACHE_MAGIC[4] = {'F', 'M', 'P', 'C'};
+const uint64_t CACHE_VERSION = 1;
+
+/**
+ * @brief Appends fixed-size integers and length-prefixed strings (native byte order)
+ */
+class Writer {
+public:
+    void u64(uint64_t value) { raw(&value, sizeof(value)); }
+    void i64(int64_t value) { raw(&value, sizeof(value)); }
+    void f64(double value) { raw(&value, sizeof(value)); }
+    void str(const std::string& value) {
+        u64(value.size());
+        buffer_.append(value);
+    }
+    void raw(const void* data, size_t size) { buffer_.append(static_cast<const char*>(data), size); }
+
+    const std::string& buffer() const { return buffer_; }
+
+private:
+    std::string buffer_;
+};
+
+/**
+ * @brief Bounds-checked counterpart of Writer; any overrun marks the reader as failed
+ */
+class Reader {
+public:
+    Reader(const char* data, size_t size) : data_(data), size_(size) {}
+
+    uint64_t u64() { uint64_t v = 0; raw(&v, sizeof(v)); return v; }
+    int64_t i64() { int64_t v = 0; raw(&v, sizeof(v)); return v; }
+    double f64() { double v = 0.0; raw(&v, sizeof(v)); return v; }
+    std::string str() {
+        uint64_t length = u64();
+        if (!ok_ || length > size_ - pos_) {
+            ok_ = false;
+            return {};
+        }
+        std::string value(data_ + pos_, static_cast<size_t>(length));
+        pos_ += static_cast<size_t>(length);
+        return value;
+    }
+    void raw(void* out, size_t size) {
+        if (!ok_ || size > size_ - pos_) {
+            ok_ = false;
+            return;
+        }
+        std::memcpy(out, data_ + pos_, size);
+        pos_ += size;
+    }
+
+    bool ok() const { return ok_; }
+    bool atEnd() const { return pos_ == size_; }
+
+private:
+    const char* data_;
+    size_t size_;
+    size_t pos_{0};
+    bool ok_{true};
+};
+
+void writeResult(Writer& w, const ProbeResult& result) {
+    const ProbeFormat& f = result.format;
+    w.str(f.filename);
+    w.str(f.format_name);
+    w.str(f.format_long_name);
+    w.f64(f.duration);
+    w.f64(f.start_time);
+    w.i64(f.size);
+    w.i64(f.bit_rate);
+    w.i64(f.nb_streams);
+
+    w.u64(result.streams.size());
+    for (const auto& s : result.streams) {
+        w.i64(s.index);
+        w.str(s.codec_type);
+        w.str(s.codec_name);
+        w.str(s.codec_long_name);
+        w.str(s.profile);
+        w.i64(s.bit_rate);
+        w.f64(s.duration);
+        w.i64(s.nb_frames);
+        w.i64(s.width);
+        w.i64(s.height);
+        w.str(s.pix_fmt);
+        w.str(s.r_frame_rate);
+        w.str(s.avg_frame_rate);
+        w.str(s.color_range);
+        w.str(s.color_space);
+        w.str(s.color_transfer);
+        w.str(s.color_primaries);
+        w.i64(s.sample_rate);
+        w.i64(s.channels);
+        w.str(s.channel_layout);
+        w.str(s.language);
+        w.str(s.title);
+    }
+}
+
+ProbeResult readResult(Reader& r) {
+    ProbeResult result;
+    ProbeFormat& f = result.format;
+    f.filename = r.str();
+    f.format_name = r.str();
+    f.format_long_name = r.str();
+    f.duration = r.f64();
+    f.start_time = r.f64();
+    f.size = r.i64();
+    f.bit_rate = r.i64();
+    f.nb_streams = static_cast<int>(r.i64());
+
+    uint64_t count = r.u64();
+    for (uint64_t i = 0; i < count && r.ok(); ++i) {
+        ProbeStream s;
+        s.index = static_cast<int>(r.i64());
+        s.codec_type = r.str();
+        s.codec_name = r.str();
+        s.codec_long_name = r.str();
+        s.profile = r.str();
+        s.bit_rate = r.i64();
+        s.duration = r.f64();
+        s.nb_frames = r.i64();
+        s.width = static_cast<int>(r.i64());
+        s.height = static_cast<int>(r.i64());
+        s.pix_fmt = r.str();
+        s.r_frame_rate = r.str();
+        s.avg_frame_rate = r.str();
+        s.color_range = r.str();
+        s.color_space = r.str();
+        s.color_transfer = r.str();
+        s.color_primaries = r.str();
+        s.sample_rate = static_cast<int>(r.i64());
+        s.channels = static_cast<int>(r.i64());
+        s.channel_layout = r.str();
+        s.language = r.str();
+        s.title = r.str();
+        result.streams.push_back(std::move(s));
+    }
+    return result;
+}
+
+} // namespace
+
+// ============================================================================
+// CONSTRUCTOR / INSTANCE
+// ============================================================================
+
+ProbeCache::ProbeCache(fs::path file) : file_(std::move(file)) {}
+
+ProbeCache::~ProbeCache() {
+    flush();
+}
+
+ProbeCache& ProbeCache::instance() {
+    static ProbeCache cache(FFmpegMulti::PathUtils::getCacheDir() / "probe_cache.bin");
+    return cache;
+}
+
+// ============================================================================
+// LOOKUP / STORE
+// ============================================================================
+
+bool ProbeCache::stampFile(const std::string& inputFile, std::string& key, FileStamp& stamp) {
+    std::error_code ec;
+    fs::path canonical = fs::canonical(inputFile, ec);
+    if (ec) {
+        return false;
+    }
+    key = canonical.string();
+
+#ifdef _WIN32
+    uintmax_t size = fs::file_size(canonical, ec);
+    if (ec) {
+        return false;
+    }
+    auto mtime = fs::last_write_time(canonical, ec);
+    if (ec) {
+        return false;
+    }
+    stamp.size = size;
+    stamp.mtime_ns = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(mtime.time_since_epoch()).count());
+    stamp.inode = 0;
+#else
+    struct stat st;
+    if (::stat(key.c_str(), &st) != 0 || !S_ISREG(st.st_mode)) {
+        return false;
+    }
+    stamp.size = static_cast<uint64_t>(st.st_size);
+#ifdef __APPLE__
+    stamp.mtime_ns = static_cast<uint64_t>(st.st_mtimespec.tv_sec) * 1000000000ull + static_cast<uint64_t>(st.st_mtimespec.tv_nsec);
+#else
+    stamp.mtime_ns = static_cast<uint64_t>(st.st_mtim.tv_sec) * 1000000000ull + static_cast<uint64_t>(st.st_mtim.tv_nsec);
+#endif
+    stamp.inode = static_cast<uint64_t>(st.st_ino);
+#endif
+    return true;
+}
+
+std::optional<ProbeResult> ProbeCache::lookup(const std::string& inputFile) {
+    std::string key;
+    FileStamp stamp;
+    if (!stampFile(inputFile, key, stamp)) {
+        return std::nullopt;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    load();
+
+    auto it = entries_.find(key);
+    if (it == entries_.end()) {
+        return std::nullopt;
+    }
+    if (it->second.stamp != stamp) {
+        // Stale: the file was modified or replaced since it was probed
+        entries_.erase(it);
+        markChanged(key);
+        return std::nullopt;
+    }
+    return it->second.result;
+}
+
+void ProbeCache::store(const std::string& inputFile, const ProbeResult& result) {
+    std::string key;
+    FileStamp stamp;
+    if (!stampFile(inputFile, key, stamp)) {
+        return;
+    }
+
+    bool due = false;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        load();
+        entries_[key] = Entry{stamp, result};
+        markChanged(key);
+        // Rewriting the file costs its whole size: the interval grows with it so a long scan stays linear
+        due = ++pending_stores_ >= std::max<size_t>(FLUSH_INTERVAL, entries_.size() / 8);
+    }
+    if (due) {
+        flush(false);
+    }
+}
+
+void ProbeCache::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries_.clear();
+    changed_.clear();
+    loaded_ = true;
+    dirty_ = true;
+    cleared_ = true;
+}
+
+void ProbeCache::markChanged(const std::string& key) {
+    changed_.insert(key);
+    dirty_ = true;
+}
+
+size_t ProbeCache::size() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    load();
+    return entries_.size();
+}
+
+// ============================================================================
+// PERSISTENCE
+// ============================================================================
+
+void ProbeCache::load() {
+    if (loaded_) {
+        return;
+    }
+    loaded_ = true;
+    readFile(file_, entries_);
+}
+
+bool ProbeCache::readFile(const fs::path& file, EntryMap& entries) {
+    std::ifstream in(file, std::ios::binary);
+    if (!in.is_open()) {
+        return false; // First run
+    }
+    std::string data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+
+    Reader r(data.data(), data.size());
+    char magic[4] = {};
+    r.raw(magic, sizeof(magic));
+    uint64_t version = r.u64();
+    if (!r.ok() || std::memcmp(magic, CACHE_MAGIC, sizeof(magic)) != 0 || version != CACHE_VERSION) {
+        return false; // Foreign or outdated file: rebuilt on the next flush
+    }
+
+    uint64_t count = r.u64();
+    EntryMap read;
+    for (uint64_t i = 0; i < count && r.ok(); ++i) {
+        std::string key = r.str();
+        Entry entry;
+        entry.stamp.size = r.u64();
+        entry.stamp.mtime_ns = r.u64();
+        entry.stamp.inode = r.u64();
+        entry.result = readResult(r);
+        read.emplace(std::move(key), std::move(entry));
+    }
+
+    // A truncated or corrupt file is dropped as a whole rather than half-trusted
+    if (!r.ok() || !r.atEnd()) {
+        return false;
+    }
+    entries = std::move(read);
+    return true;
+}
+
+bool ProbeCache::flush() {
+    return flush(true);
+}
+
+bool ProbeCache::flush(bool wait) {
+    // One flush at a time; a periodic one skips its turn rather than stall the probe that triggered it
+    std::unique_lock<std::mutex> flushing(flush_mutex_, std::defer_lock);
+    if (wait) {
+        flushing.lock();
+    } else if (!flushing.try_lock()) {
+        return true;
+    }
+
+    // The changes are taken under the lock, the file is read, merged and written without it
+    std::vector<std::pair<std::string, std::optional<Entry>>> changes;
+    bool cleared = false;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!dirty_) {
+            return true;
+        }
+        for (const std::string& key : changed_) {
+            auto it = entries_.find(key);
+            changes.emplace_back(key, it != entries_.end() ? std::optional<Entry>(it->second) : std::nullopt);
+        }
+        cleared = cleared_;
+        changed_.clear();
+        pending_stores_ = 0;
+        dirty_ = false;
+        cleared_ = false;
+    }
+
+    if (writeMerged(changes, cleared)) {
+        return true;
+    }
+
+    // Not written: the changes stay pending, unless newer ones replaced them meanwhile
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& change : changes) {
+        changed_.insert(change.first);
+    }
+    dirty_ = true;
+    cleared_ = cleared_ || cleared;
+    return false;
+}
+
+bool ProbeCache::writeMerged(const std::vector<std::pair<std::string, std::optional<Entry>>>& changes, bool cleared) const {
+    // Entries written by other processes since the file was read are kept, ours replace theirs
+    EntryMap merged;
+    if (!cleared) {
+        readFile(file_, merged);
+    }
+    for (const auto& [key, entry] : changes) {
+        if (entry) {
+            merged[key] = *entry;
+        } else {
+            merged.erase(key);
+        }
+    }
+
+    Writer w;
+    w.raw(CACHE_MAGIC, sizeof(CACHE_MAGIC));
+    w.u64(CACHE_VERSION);
+    w.u64(merged.size());
+    for (const auto& [key, entry] : merged) {
+        w.str(key);
+        w.u64(entry.stamp.size);
+        w.u64(entry.stamp.mtime_ns);
+        w.u64(entry.stamp.inode);
+        writeResult(w, entry.result);
+    }
+
+    // Write then rename so a crash or a concurrent reader never sees a partial file
+    std::error_code ec;
+    fs::create_directories(file_.parent_path(), ec);
+#ifdef _WIN32
+    fs::path temp = file_;
+    temp += ".tmp";
+#else
+    fs::path temp = file_;
+    temp += ".tmp." + std::to_string(::getpid());
+#endif
+    {
+        std::ofstream out(temp, std::ios::binary | std::ios::trunc);
+        if (!out.is_open()) {
+            return false;
+        }
+        out.write(w.buffer().data(), static_cast<std::streamsize>(w.buffer().size()));
+        if (!out) {
+            out.close();
+            fs::remove(temp, ec);
+            return false;
+        }
+    }
+
+    fs::rename(temp, file_, ec);
+    if (ec) {
+        fs::remove(temp, ec);
+        return false;
+    }
+    return true;
+}
+
+} // namespace Jobs
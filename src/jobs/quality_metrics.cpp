@@ -0,0 +1,199 @@
+#include "../../include/jobs/quality_metrics.hpp"
+#include "../../include/core/ffmpeg_process.hpp"
+#include "../../include/core/json.hpp"
+#include "../../include/core/path_utils.hpp"
+#include "../../include/pipeline/segments.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <mutex>
+#include <sstream>
+
+namespace fs = std::filesystem;
+
+namespace FFmpegMulti {
+namespace Jobs {
+namespace Metrics {
+
+namespace {
+
+// Frames compared in 10-bit 4:2:0, which every metric filter accepts
+const char* COMPARE_PIXEL_FORMAT = "yuv420p10le";
+
+// Identical frames have an infinite PSNR
+const double MAX_PSNR = 100.0;
+
+// Escapes a filter option value, then the result for the filtergraph parser
+std::string escapeFilterValue(const std::string& value) {
+    std::string option;
+    for (char c : value) {
+        if (c == '\\' || c == '\'' || c == ':') {
+            option += '\\';
+        }
+        option += c;
+    }
+    std::string graph;
+    for (char c : option) {
+        if (c == '\\' || c == '\'' || c == '[' || c == ']' || c == ',' || c == ';') {
+            graph += '\\';
+        }
+        graph += c;
+    }
+    return graph;
+}
+
+// Mean of the number following `key` on every line that has it
+std::optional<double> meanOfField(const std::string& output, const std::string& key, double cap) {
+    std::istringstream lines(output);
+    std::string line;
+    double sum = 0.0;
+    size_t count = 0;
+    while (std::getline(lines, line)) {
+        size_t pos = line.find(key);
+        if (pos == std::string::npos) {
+            continue;
+        }
+        const char* start = line.c_str() + pos + key.size();
+        char* end = nullptr;
+        double value = std::strtod(start, &end);
+        if (end == start) {
+            continue;
+        }
+        sum += std::min(value, cap);
+        count++;
+    }
+    if (count == 0) {
+        return std::nullopt;
+    }
+    return sum / static_cast<double>(count);
+}
+
+} // namespace
+
+// ============================================================================
+// METRICS
+// ============================================================================
+
+const char* metricName(Encode::QualityMetric metric) {
+    switch (metric) {
+        case Encode::QualityMetric::SSIM: return "SSIM";
+        case Encode::QualityMetric::PSNR: return "PSNR";
+        case Encode::QualityMetric::VMAF: return "VMAF";
+    }
+    return "unknown";
+}
+
+bool isAvailable(Encode::QualityMetric metric) {
+    if (metric != Encode::QualityMetric::VMAF) {
+        return true; // Built into every ffmpeg
+    }
+
+    static std::once_flag once;
+    static bool available = false;
+    std::call_once(once, []() {
+        ffmpegProcess ffmpeg(PathUtils::getToolPath("ffmpeg"), { "-hide_banner", "-filters" });
+        ffmpeg.setEcho(false);
+        ffmpeg.setCaptureOutput(true);
+        ProcessResult result = ffmpeg.run();
+        available = result.success() && result.output.find(" libvmaf ") != std::string::npos;
+    });
+    return available;
+}
+
+// ============================================================================
+// COMPARISON
+// ============================================================================
+
+std::vector<std::string> buildCompareArgs(Encode::QualityMetric metric, const fs::path& distorted, const std::string& reference,
+                                          double start, double duration, const fs::path& log_path, unsigned threads) {
+    std::vector<std::string> args = { "-hide_banner", "-loglevel", "error", "-i", distorted.string() };
+    if (start > 0.0) {
+        args.push_back("-ss");
+        args.push_back(Pipeline::formatSeconds(start));
+    }
+    if (duration > 0.0) {
+        args.push_back("-t");
+        args.push_back(Pipeline::formatSeconds(duration));
+    }
+    args.push_back("-i");
+    args.push_back(reference);
+
+    std::string compare;
+    switch (metric) {
+        case Encode::QualityMetric::SSIM:
+            compare = "ssim=stats_file=-";
+            break;
+        case Encode::QualityMetric::PSNR:
+            compare = "psnr=stats_file=-";
+            break;
+        case Encode::QualityMetric::VMAF:
+            compare = "libvmaf=log_fmt=json:log_path=" + escapeFilterValue(log_path.string()) + ":n_threads=" + std::to_string(std::max(1u, threads));
+            break;
+    }
+
+    // libvmaf takes the distorted input first, the reference second
+    std::ostringstream graph;
+    graph << "[0:v:0]setpts=PTS-STARTPTS,format=" << COMPARE_PIXEL_FORMAT << "[dist];"
+          << "[1:v:0]setpts=PTS-STARTPTS,format=" << COMPARE_PIXEL_FORMAT << "[ref];"
+          << "[dist][ref]" << compare;
+    args.insert(args.end(), { "-filter_complex", graph.str(), "-f", "null", "-" });
+    return args;
+}
+
+std::optional<double> parseScore(Encode::QualityMetric metric, const std::string& output, const fs::path& log_path) {
+    switch (metric) {
+        case Encode::QualityMetric::SSIM:
+            return meanOfField(output, "All:", 1.0);
+        case Encode::QualityMetric::PSNR:
+            return meanOfField(output, "psnr_avg:", MAX_PSNR);
+        case Encode::QualityMetric::VMAF: {
+            std::ifstream file(log_path, std::ios::binary);
+            if (!file.is_open()) {
+                return std::nullopt;
+            }
+            std::string text((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+            try {
+                Json::Value log = Json::Value::parse(text);
+                const Json::Value& mean = log["pooled_metrics"]["vmaf"]["mean"];
+                if (mean.isNumber()) {
+                    return mean.asNumber();
+                }
+            } catch (const Json::ParseError&) {
+            }
+            return std::nullopt;
+        }
+    }
+    return std::nullopt;
+}
+
+// ============================================================================
+// SEARCH
+// ============================================================================
+
+double interpolateCrf(const std::map<int, double>& scores, double target) {
+    if (scores.empty()) {
+        return 0.0;
+    }
+    if (scores.begin()->second < target) {
+        return scores.begin()->first; // Even the best measure misses the target
+    }
+
+    // First crossing from the low CRF side: conservative when the curve is not monotonic
+    auto previous = scores.begin();
+    for (auto it = std::next(scores.begin()); it != scores.end(); ++it) {
+        if (it->second < target) {
+            double span = previous->second - it->second;
+            double fraction = span > 0.0 ? (previous->second - target) / span : 0.0;
+            return previous->first + fraction * (it->first - previous->first);
+        }
+        previous = it;
+    }
+    return scores.rbegin()->first;
+}
+
+} // namespace Metrics
+} // namespace Jobs
+} // namespace FFmpegMulti
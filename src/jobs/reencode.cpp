@@ -1,10 +1,28 @@
 #include "../../include/jobs/reencode.hpp"
 #include "../../include/jobs/codec_utils.hpp"
+#include "../../include/jobs/probe.hpp"
 #include "../../include/core/ffmpeg_process.hpp"
 #include "../../include/core/path_utils.hpp"
+#include "../../include/jobs/concat.hpp"
+#include "../../include/jobs/quality_metrics.hpp"
+#include "../../include/jobs/streaming.hpp"
+#include "../../include/pipeline/batch_runner.hpp"
+#include "../../include/pipeline/output_cache.hpp"
+#include "../../include/pipeline/segments.hpp"
 #include <iostream>
 #include <sstream>
+#include <iomanip>
 #include <stdexcept>
+#include <algorithm>
+#include <atomic>
+#include <map>
+#include <filesystem>
+#include <limits>
+#include <cmath>
+#include <mutex>
+#include <thread>
+
+namespace fs = std::filesystem;
 
 namespace FFmpegMulti {
 namespace Jobs {
@@ -62,6 +80,15 @@ std::vector<std::string> ReencodeJob::buildCommand() const {
     // [global options] -i input [video options] [audio options] output
     
     addInputArgs(args);
+    std::vector<std::string> output = buildOutputArgs();
+    args.insert(args.end(), output.begin(), output.end());
+    
+    return args;
+}
+
+std::vector<std::string> ReencodeJob::buildOutputArgs() const {
+    std::vector<std::string> args;
+    
     addVideoCodecArgs(args);
     addRateControlArgs(args);
     addEncodingParams(args);
@@ -100,6 +127,20 @@ std::string ReencodeJob::getCommandString() const {
 // ============================================================================
 
 void ReencodeJob::addInputArgs(std::vector<std::string>& args) const {
+    // The output goes to a .partial file owned by this job (leftover of a crash
+    // included); `overwrite` is enforced on the final name by checkOutput()
+    args.push_back("-y");
+    
+    // Input seeking: fast, and exact when the position is a keyframe
+    if (config_.start_time > 0.0) {
+        args.push_back("-ss");
+        args.push_back(Pipeline::formatSeconds(config_.start_time));
+    }
+    if (config_.duration > 0.0) {
+        args.push_back("-t");
+        args.push_back(Pipeline::formatSeconds(config_.duration));
+    }
+    
     args.push_back("-i");
     args.push_back(input_path_);
 }
@@ -226,14 +267,30 @@ void ReencodeJob::addEncodingParams(std::vector<std::string>& args) const {
         args.push_back(std::to_string(config_.gop_size));
     }
     
+    // Segmented output: a keyframe opens every segment, at the same times in every rendition
+    if (config_.streaming) {
+        args.push_back("-force_key_frames");
+        args.push_back(Streaming::keyframeExpression(config_.streaming->segment_seconds));
+    }
+    
     // B-frames
     args.push_back("-bf");
     args.push_back(std::to_string(config_.bframes));
     
-    // Threads
-    if (config_.threads > 0) {
+    // Threads: explicit, or the share of the machine planned for the job
+    unsigned threads = config_.threads > 0 ? static_cast<unsigned>(config_.threads) : getCpuAllocation().threads;
+    if (threads > 0) {
         args.push_back("-threads");
-        args.push_back(std::to_string(config_.threads));
+        args.push_back(std::to_string(threads));
+        
+        // Encoders sizing their own pools from the CPU count ignore -threads
+        if (config_.codec == Encode::Codec::X265) {
+            args.push_back("-x265-params");
+            args.push_back("pools=" + std::to_string(threads));
+        } else if (config_.codec == Encode::Codec::SVT_AV1) {
+            args.push_back("-svtav1-params");
+            args.push_back("lp=" + std::to_string(threads));
+        }
     }
 }
 
@@ -304,7 +361,9 @@ void ReencodeJob::addHDRMetadata(std::vector<std::string>& args) const {
 // ============================================================================
 
 void ReencodeJob::addAudioArgs(std::vector<std::string>& args) const {
-    if (config_.audio.copy_audio) {
+    if (config_.audio.disabled) {
+        args.push_back("-an");
+    } else if (config_.audio.copy_audio) {
         args.push_back("-c:a");
         args.push_back("copy");
     } else {
@@ -329,7 +388,12 @@ void ReencodeJob::addAudioArgs(std::vector<std::string>& args) const {
 // ============================================================================
 
 void ReencodeJob::addOutputArgs(std::vector<std::string>& args) const {
-    args.push_back(output_path_);
+    if (config_.streaming) {
+        std::vector<std::string> muxer = Streaming::buildMuxerArgs(*config_.streaming, output_path_);
+        args.insert(args.end(), muxer.begin(), muxer.end());
+        return;
+    }
+    args.push_back(PathUtils::getPartialPath(output_path_).string());
 }
 
 // ============================================================================
@@ -449,6 +513,85 @@ bool ReencodeJob::validate() const {
             throw std::runtime_error("Bitrate must be > 0 for VBR/CBR modes");
     }
     
+    if (config_.target_quality) {
+        const Encode::QualityTarget& target = *config_.target_quality;
+        if (config_.codec != Encode::Codec::X264 && config_.codec != Encode::Codec::X265 &&
+            config_.codec != Encode::Codec::AV1 && config_.codec != Encode::Codec::SVT_AV1)
+            throw std::runtime_error("Target quality needs a CRF encoder (x264, x265, AV1, SVT-AV1)");
+        if (target.score <= 0.0)
+            throw std::runtime_error("Target quality score must be > 0");
+        if (target.samples <= 0 || target.sample_seconds <= 0.0 || target.probes < 2)
+            throw std::runtime_error("Target quality needs at least one sample and two probe CRFs");
+        if (target.min_crf < 0 || target.max_crf < 0 || (target.max_crf > 0 && target.min_crf >= target.max_crf))
+            throw std::runtime_error("Invalid target quality CRF range");
+    }
+    
+    if (config_.streaming) {
+        if (config_.streaming->segment_seconds <= 0.0)
+            throw std::runtime_error("Streaming segment duration must be > 0");
+        if (config_.chunk_seconds > 0.0)
+            throw std::runtime_error("Chunked encoding cannot write streaming segments (keyframes are forced on segment boundaries)");
+    }
+    
+    return true;
+}
+
+bool ReencodeJob::checkOutput() const {
+    if (!config_.overwrite && fs::exists(output_path_)) {
+        std::cerr << "[ERROR] Output file already exists (enable overwrite to replace it): " << output_path_ << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool ReencodeJob::commitOutput() const {
+    if (!PathUtils::commitPartial(PathUtils::getPartialPath(output_path_), output_path_)) {
+        std::cerr << "[ERROR] Cannot move the finished encode to " << output_path_ << " (kept as " << PathUtils::getPartialPath(output_path_).string() << ")" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+std::string ReencodeJob::getCacheKey() const {
+    // The cache holds single files
+    if (config_.streaming)
+        return "";
+    
+    // Threads picked by the planner depend on the batch, not on the encode: only explicit ones are part of the key
+    ReencodeJob unplanned(*this);
+    unplanned.setCpuAllocation({});
+    // A searched CRF is keyed on its target, so the lookup can run before the search
+    if (config_.target_quality)
+        unplanned.config_.quality = 0;
+    
+    // The output path does not change the encode, only its container (extension) does
+    std::vector<std::string> args = unplanned.buildCommand();
+    args.back() = fs::path(output_path_).extension().string();
+    if (config_.target_quality) {
+        const Encode::QualityTarget& target = *config_.target_quality;
+        std::ostringstream quality;
+        quality << "target=" << Metrics::metricName(target.metric) << ":" << target.score << ":" << target.samples << ":"
+                << target.sample_seconds << ":" << target.probes << ":" << target.min_crf << "-" << target.max_crf;
+        args.push_back(quality.str());
+    }
+    if (config_.chunk_seconds > 0.0) {
+        // Segment boundaries change the GOP layout, so chunked encodes are distinct entries
+        std::ostringstream chunk;
+        chunk << "chunk_seconds=" << config_.chunk_seconds;
+        args.push_back(chunk.str());
+    }
+    std::string version = Pipeline::OutputCache::toolVersion(PathUtils::getToolPath("ffmpeg"));
+    return Pipeline::OutputCache::makeKey(input_path_, args, version);
+}
+
+bool ReencodeJob::fetchFromCache(const std::string& key) const {
+    fs::path partial = PathUtils::getPartialPath(output_path_);
+    if (!Pipeline::OutputCache::instance().fetch(key, partial))
+        return false;
+    if (!commitOutput())
+        return false;
+    
+    std::cout << "[CACHE] Identical encode found in the cache (" << key << "), output reused: " << output_path_ << std::endl;
     return true;
 }
 
@@ -456,30 +599,48 @@ bool ReencodeJob::validate() const {
 // EXECUTION
 // ============================================================================
 
+unsigned ReencodeJob::threadDemand() const {
+    // Segments are encoded side by side and fill the machine
+    if (config_.chunk_seconds > 0.0)
+        return Core::availableCores();
+    if (config_.threads > 0)
+        return static_cast<unsigned>(config_.threads);
+    return Codec::CodecUtils::getTypicalThreadUsage(config_.codec, config_.preset);
+}
+
+std::string ReencodeJob::encoderName() const {
+    return getEncoderName();
+}
+
 bool ReencodeJob::execute() {
     try {
         // Validation
         validate();
+        if (!checkOutput())
+            return false;
         
-        // Build command
-        auto args = buildCommand();
-        
-        // Log command
-        std::cout << "[INFO] Encode command: " << getCommandString() << std::endl;
-        
-        // Execution via FFmpegProcess with absolute path
-        std::filesystem::path extern_path = FFmpegMulti::PathUtils::getExternPath();
-        std::filesystem::path ffmpeg_path = extern_path / "ffmpeg.exe";
-        ffmpegProcess process(ffmpeg_path, args);
+        // Before the target quality search, so a cache hit skips its probe encodes
+        std::string cacheKey;
+        if (config_.output_cache) {
+            Core::Trace::Span step = traceStep("cache lookup");
+            cacheKey = getCacheKey();
+            if (!cacheKey.empty() && fetchFromCache(cacheKey))
+                return true;
+        }
         
-        // Actually execute the command
-        bool success = process.execute();
+        if (config_.target_quality) {
+            Core::Trace::Span step = traceStep("target quality search");
+            if (!searchTargetCrf())
+                return false;
+        }
         
-        if (success)
-            std::cout << "[SUCCESS] Encoding finished successfully!" << std::endl;
-        else
-            std::cerr << "[ERROR] Encoding failed!" << std::endl;
+        bool success = config_.chunk_seconds > 0.0 ? executeChunked() : encodeSingle();
         
+        if (success && !cacheKey.empty()) {
+            Core::Trace::Span step = traceStep("cache store");
+            if (!Pipeline::OutputCache::instance().store(cacheKey, output_path_))
+                std::cerr << "[WARN] Could not add the output to the cache" << std::endl;
+        }
         return success;
         
     } catch (const std::exception& e) {
@@ -488,5 +649,387 @@ bool ReencodeJob::execute() {
     }
 }
 
+bool ReencodeJob::encodeSingle() {
+    // Build command
+    auto args = buildCommand();
+    
+    // Log command
+    std::cout << "[INFO] Encode command: " << getCommandString() << std::endl;
+    
+    // Execution via FFmpegProcess (argument vector, no shell)
+    std::filesystem::path ffmpeg_path = FFmpegMulti::PathUtils::getToolPath("ffmpeg");
+    ffmpegProcess process(ffmpeg_path, args);
+    
+    // Live progress: the probed duration gives percent and ETA
+    if (hasProgressCallback()) {
+        double duration = config_.duration > 0.0 ? config_.duration : ::Jobs::ProbeJob::probeDuration(input_path_) - config_.start_time;
+        trackProgress(process, duration);
+    }
+    
+    // Segments of an earlier encode would mix with the new ones
+    if (config_.streaming)
+        Streaming::removeSegments(config_.streaming->format, output_path_);
+    
+    // Actually execute the command
+    ProcessResult result = runProcess(process);
+    
+    if (!result.success()) {
+        std::cerr << "[ERROR] Encoding failed! (" << result.describe() << ")" << std::endl;
+        std::error_code ec;
+        fs::remove(PathUtils::getPartialPath(output_path_), ec);
+        if (config_.streaming)
+            Streaming::removeSegments(config_.streaming->format, output_path_);
+        return false;
+    }
+    if (!commitOutput())
+        return false;
+    
+    std::cout << "[SUCCESS] Encoding finished successfully!" << std::endl;
+    return true;
+}
+
+// ============================================================================
+// CHUNKED EXECUTION
+// ============================================================================
+
+fs::path ReencodeJob::getChunkDir() const {
+    return fs::path(output_path_ + ".chunks");
+}
+
+bool ReencodeJob::executeChunked() {
+    // 1. Keyframe-aligned segments, so every segment starts on a clean GOP
+    Core::Trace::Span step = traceStep("probe keyframes");
+    double total = ::Jobs::ProbeJob::probeDuration(input_path_);
+    double rangeStart = config_.start_time;
+    double rangeEnd = std::numeric_limits<double>::infinity();
+    if (config_.duration > 0.0)
+        rangeEnd = rangeStart + config_.duration;
+    else if (total > 0.0)
+        rangeEnd = total;
+    
+    std::vector<double> keyframes = ::Jobs::ProbeJob::probeKeyframes(input_path_);
+    std::vector<double> starts = Pipeline::planSegmentStarts(keyframes, rangeStart, rangeEnd, config_.chunk_seconds);
+    
+    step.end();
+    
+    if (starts.size() < 2) {
+        std::cout << "[INFO] Source too short to split, encoding in a single process" << std::endl;
+        return encodeSingle();
+    }
+    
+    fs::path chunkDir = getChunkDir();
+    fs::create_directories(chunkDir);
+    std::cout << "[INFO] Chunked encode: " << starts.size() << " segments of ~" << config_.chunk_seconds << " s in " << chunkDir.string() << std::endl;
+    
+    // 2. One video-only encode per segment, all with the same settings
+    auto progress = std::make_shared<Pipeline::SegmentProgress>();
+    progress->segments.resize(starts.size());
+    progress->duration_seconds = std::isinf(rangeEnd) ? 0.0 : rangeEnd - rangeStart;
+    
+    Pipeline::BatchOptions options;
+    options.concurrency = static_cast<unsigned>(config_.chunk_workers);
+    options.max_retries = config_.chunk_retries;
+    options.log_dir = chunkDir / "logs";
+    options.resources = getCpuAllocation(); // Segments share the CPUs planned for this job
+    options.should_stop = [this]() { return isCancelled(); };
+    Pipeline::BatchRunner runner(options);
+    
+    std::vector<std::string> chunkFiles;
+    for (size_t i = 0; i < starts.size(); ++i) {
+        std::ostringstream name;
+        name << "chunk_" << std::setw(4) << std::setfill('0') << i << ".mkv";
+        fs::path chunkPath = chunkDir / name.str();
+        chunkFiles.push_back(chunkPath.string());
+        
+        double start = (i == 0) ? starts[i] : starts[i] - Pipeline::SEGMENT_BOUNDARY_MARGIN;
+        
+        ReencodeJob chunk(*this);
+        chunk.output_path_ = chunkPath.string();
+        chunk.config_.chunk_seconds = 0.0;
+        chunk.config_.target_quality.reset(); // Already searched for the whole range
+        chunk.config_.start_time = start;
+        chunk.config_.duration = 0.0;
+        if (i + 1 < starts.size())
+            chunk.config_.duration = starts[i + 1] - Pipeline::SEGMENT_BOUNDARY_MARGIN - start;
+        else if (config_.duration > 0.0)
+            chunk.config_.duration = rangeEnd - start;
+        chunk.config_.audio.disabled = true;
+        chunk.config_.overwrite = true; // Retries replace a partial segment
+        chunk.config_.output_cache = false; // Only the final output is cached
+        
+        if (hasProgressCallback()) {
+            chunk.setProgressCallback([this, progress, i](const Core::Progress& p) {
+                std::lock_guard<std::mutex> lock(progress->mutex);
+                progress->segments[i] = p;
+                reportProgress(progress->merged());
+            });
+        } else {
+            chunk.setProgressCallback(nullptr);
+        }
+        
+        runner.add(std::make_unique<ReencodeJob>(std::move(chunk)), name.str());
+    }
+    
+    step = traceStep("encode segments");
+    Pipeline::BatchSummary summary = runner.run();
+    step.end();
+    for (const auto& result : summary.results)
+        addMetrics(result.metrics);
+    
+    if (hasProgressCallback()) {
+        std::lock_guard<std::mutex> lock(progress->mutex);
+        Core::Progress last = progress->merged();
+        last.finished = true;
+        reportProgress(last);
+    }
+    
+    if (!summary.allSucceeded()) {
+        for (const auto& result : summary.results) {
+            if (!result.success && !result.cancelled)
+                std::cerr << "[ERROR] Segment " << result.name << " failed after " << result.attempts << " attempt(s), see " << result.log_file.string() << std::endl;
+        }
+        std::cerr << "[ERROR] Chunked encode failed, segments kept in " << chunkDir.string() << std::endl;
+        return false;
+    }
+    
+    // 3. Lossless join of the segments
+    step = traceStep("join segments");
+    std::string joined = (chunkDir / "video.mkv").string();
+    ConcatJob concat(chunkFiles, joined);
+    concat.setLogFile(getLogFile());
+    concat.setTrace(getTrace(), getTraceTrack());
+    if (isCancelled() || !concat.execute()) {
+        std::cerr << "[ERROR] Joining the segments failed, segments kept in " << chunkDir.string() << std::endl;
+        return false;
+    }
+    
+    // 4. Final mux: joined video + audio and metadata of the source
+    step = traceStep("final mux");
+    std::vector<std::string> args = { "-y", "-i", joined };
+    if (config_.start_time > 0.0)
+        args.insert(args.end(), { "-ss", Pipeline::formatSeconds(config_.start_time) });
+    if (config_.duration > 0.0)
+        args.insert(args.end(), { "-t", Pipeline::formatSeconds(config_.duration) });
+    args.insert(args.end(), { "-i", input_path_, "-map", "0:v:0", "-map", "1:a:0?", "-map_metadata", "1", "-map_chapters", "1", "-c:v", "copy" });
+    addAudioArgs(args);
+    addOutputArgs(args);
+    
+    ffmpegProcess mux(FFmpegMulti::PathUtils::getToolPath("ffmpeg"), args);
+    ProcessResult result = runProcess(mux);
+    if (!result.success()) {
+        std::cerr << "[ERROR] Final mux failed! (" << result.describe() << "), segments kept in " << chunkDir.string() << std::endl;
+        std::error_code ec;
+        fs::remove(PathUtils::getPartialPath(output_path_), ec);
+        return false;
+    }
+    if (!commitOutput())
+        return false;
+    
+    std::error_code ec;
+    fs::remove_all(chunkDir, ec);
+    
+    std::cout << "[SUCCESS] Encoding finished successfully! (" << starts.size() << " segments, "
+              << std::fixed << std::setprecision(1) << summary.wall_seconds << " s)" << std::endl;
+    return true;
+}
+
+// ============================================================================
+// TARGET QUALITY
+// ============================================================================
+
+namespace {
+
+// CRF ranges searched by default: the useful part of each encoder's scale
+std::pair<int, int> defaultCrfRange(Encode::Codec codec) {
+    if (codec == Encode::Codec::AV1 || codec == Encode::Codec::SVT_AV1)
+        return { 15, 55 };
+    return { 14, 36 };
+}
+
+} // namespace
+
+fs::path ReencodeJob::getProbeDir() const {
+    return fs::path(output_path_ + ".probes");
+}
+
+bool ReencodeJob::searchTargetCrf() {
+    const Encode::QualityTarget& target = *config_.target_quality;
+    const char* metric = Metrics::metricName(target.metric);
+    if (!Metrics::isAvailable(target.metric)) {
+        std::cerr << "[ERROR] This ffmpeg build cannot measure " << metric << " (libvmaf missing)" << std::endl;
+        return false;
+    }
+    
+    std::pair<int, int> range = defaultCrfRange(config_.codec);
+    int minCrf = target.min_crf > 0 ? target.min_crf : range.first;
+    int maxCrf = target.max_crf > 0 ? target.max_crf : range.second;
+    if (minCrf >= maxCrf) {
+        std::cerr << "[ERROR] Empty target quality CRF range " << minCrf << "-" << maxCrf << std::endl;
+        return false;
+    }
+    
+    // 1. Samples centred in equal parts of the range, so every part of the source counts
+    double rangeStart = config_.start_time;
+    double length = config_.duration > 0.0 ? config_.duration : ::Jobs::ProbeJob::probeDuration(input_path_) - rangeStart;
+    if (length <= 0.0) {
+        std::cerr << "[ERROR] Cannot probe the duration of " << input_path_ << ", needed to place the quality samples" << std::endl;
+        return false;
+    }
+    size_t sampleCount = static_cast<size_t>(target.samples);
+    double sampleLength = std::min(target.sample_seconds, length / static_cast<double>(sampleCount));
+    std::vector<double> sampleStarts;
+    for (size_t i = 0; i < sampleCount; ++i)
+        sampleStarts.push_back(rangeStart + length * (static_cast<double>(i) + 0.5) / static_cast<double>(sampleCount) - sampleLength / 2.0);
+    
+    fs::path probeDir = getProbeDir();
+    fs::create_directories(probeDir);
+    std::string extension = config_.streaming ? ".mp4" : fs::path(output_path_).extension().string();
+    if (extension.empty())
+        extension = ".mkv";
+    
+    std::ostringstream intro;
+    intro << "[INFO] Target quality: " << metric << " >= " << target.score << ", " << sampleCount << " samples of "
+          << std::fixed << std::setprecision(1) << sampleLength << " s, CRF " << minCrf << "-" << maxCrf << " in " << probeDir.string();
+    std::cout << intro.str() << std::endl;
+    
+    // Mean score over the samples of every CRF measured so far
+    std::map<int, double> scores;
+    auto measure = [&](const std::vector<int>& crfs) -> bool {
+        struct Probe {
+            size_t sample;
+            int crf;
+            fs::path path;
+            double score{0.0};
+        };
+        std::vector<Probe> probes;
+        for (int crf : crfs) {
+            for (size_t i = 0; i < sampleCount; ++i) {
+                std::ostringstream name;
+                name << "sample_" << std::setw(2) << std::setfill('0') << i << "_crf" << crf << extension;
+                probes.push_back({ i, crf, probeDir / name.str() });
+            }
+        }
+        
+        // 2. Every (sample, CRF) encode at once, with the settings of the real encode
+        Pipeline::BatchOptions options;
+        options.concurrency = static_cast<unsigned>(config_.chunk_workers);
+        options.log_dir = probeDir / "logs";
+        options.resources = getCpuAllocation();
+        options.should_stop = [this]() { return isCancelled(); };
+        Pipeline::BatchRunner runner(options);
+        for (const auto& probe : probes) {
+            ReencodeJob encode(*this);
+            encode.output_path_ = probe.path.string();
+            encode.config_.target_quality.reset();
+            encode.config_.rate_control = Encode::RateControl::CRF;
+            encode.config_.quality = probe.crf;
+            encode.config_.chunk_seconds = 0.0;
+            encode.config_.start_time = sampleStarts[probe.sample];
+            encode.config_.duration = sampleLength;
+            encode.config_.audio.disabled = true;
+            encode.config_.overwrite = true;
+            encode.config_.output_cache = false;
+            encode.config_.streaming.reset(); // Probes are plain files, whatever the real output
+            encode.setProgressCallback(nullptr);
+            runner.add(std::make_unique<ReencodeJob>(std::move(encode)), probe.path.filename().string());
+        }
+        
+        Pipeline::BatchSummary summary = runner.run();
+        for (const auto& result : summary.results)
+            addMetrics(result.metrics);
+        if (!summary.allSucceeded()) {
+            for (const auto& result : summary.results) {
+                if (!result.success && !result.cancelled)
+                    std::cerr << "[ERROR] Probe encode " << result.name << " failed, see " << result.log_file.string() << std::endl;
+            }
+            return false;
+        }
+        
+        // 3. Each probe against the same range of the source; the metric filters are threaded, a few at once fill the machine
+        unsigned cores = getCpuAllocation().threads > 0 ? getCpuAllocation().threads : Core::availableCores();
+        size_t workerCount = std::min<size_t>(std::max(1u, cores / 4), probes.size());
+        unsigned compareThreads = std::max(1u, cores / static_cast<unsigned>(workerCount));
+        std::atomic<size_t> next{0};
+        std::atomic<bool> failed{false};
+        auto worker = [&]() {
+            while (!isCancelled() && !failed) {
+                size_t index = next++;
+                if (index >= probes.size())
+                    return;
+                Probe& probe = probes[index];
+                fs::path vmafLog = fs::path(probe.path).replace_extension(".json");
+                ffmpegProcess compare(PathUtils::getToolPath("ffmpeg"),
+                                      Metrics::buildCompareArgs(target.metric, probe.path, input_path_, sampleStarts[probe.sample], sampleLength, vmafLog,
+                                                                compareThreads));
+                compare.setEcho(false);
+                compare.setCaptureOutput(true);
+                ProcessResult result = runProcess(compare);
+                std::optional<double> score = result.success() ? Metrics::parseScore(target.metric, result.output, vmafLog) : std::nullopt;
+                if (!score) {
+                    std::cerr << "[ERROR] Measuring " << metric << " of " << probe.path.string() << " failed (" << result.describe() << ")" << std::endl;
+                    failed = true;
+                    return;
+                }
+                probe.score = *score;
+            }
+        };
+        std::vector<std::thread> workers;
+        for (size_t i = 0; i < workerCount; ++i)
+            workers.emplace_back(worker);
+        for (auto& w : workers)
+            w.join();
+        if (failed || isCancelled())
+            return false;
+        
+        std::map<int, double> sums;
+        for (const auto& probe : probes)
+            sums[probe.crf] += probe.score;
+        for (const auto& entry : sums) {
+            scores[entry.first] = entry.second / static_cast<double>(sampleCount);
+            std::ostringstream line;
+            line << std::fixed << std::setprecision(3) << "[INFO] CRF " << entry.first << ": " << metric << " " << scores[entry.first];
+            std::cout << line.str() << std::endl;
+        }
+        return true;
+    };
+    
+    // Round 1: CRFs spread over the whole range
+    std::vector<int> round;
+    for (int i = 0; i < target.probes; ++i) {
+        int crf = minCrf + static_cast<int>(std::lround(static_cast<double>(i) * (maxCrf - minCrf) / (target.probes - 1)));
+        if (round.empty() || round.back() != crf)
+            round.push_back(crf);
+    }
+    bool measured = measure(round);
+    
+    // Round 2: the two whole CRFs around the interpolated one, when the target lies inside the range
+    if (measured && scores.begin()->second >= target.score && scores.rbegin()->second < target.score) {
+        int estimate = static_cast<int>(std::floor(Metrics::interpolateCrf(scores, target.score)));
+        round.clear();
+        for (int crf : { estimate, estimate + 1 }) {
+            if (crf >= minCrf && crf <= maxCrf && scores.count(crf) == 0)
+                round.push_back(crf);
+        }
+        if (!round.empty())
+            measured = measure(round);
+    }
+    if (!measured) {
+        std::cerr << "[ERROR] Target quality search failed, probes kept in " << probeDir.string() << std::endl;
+        return false;
+    }
+    
+    int crf = std::clamp(static_cast<int>(std::floor(Metrics::interpolateCrf(scores, target.score))), minCrf, maxCrf);
+    if (scores.begin()->second < target.score)
+        std::cerr << "[WARN] " << metric << " " << target.score << " is out of reach, even CRF " << minCrf << " scores " << scores.begin()->second << std::endl;
+    
+    config_.rate_control = Encode::RateControl::CRF;
+    config_.quality = crf;
+    std::cout << "[INFO] Target quality: encoding with CRF " << crf << " (" << scores.size() << " CRFs x " << sampleCount << " samples measured)" << std::endl;
+    
+    std::error_code ec;
+    fs::remove_all(probeDir, ec);
+    return true;
+}
+
 } // namespace Jobs
 } // namespace FFmpegMulti
@@ -115,6 +115,31 @@ ReencodeJobBuilder& ReencodeJobBuilder::vbr(int kbps) {
     return bitrate(kbps);
 }
 
+ReencodeJobBuilder& ReencodeJobBuilder::targetQuality(Encode::QualityMetric metric, double score) {
+    config_.rate_control = Encode::RateControl::CRF;
+    if (!config_.target_quality)
+        config_.target_quality.emplace();
+    config_.target_quality->metric = metric;
+    config_.target_quality->score = score;
+    return *this;
+}
+
+ReencodeJobBuilder& ReencodeJobBuilder::targetSamples(int count, double seconds) {
+    if (!config_.target_quality)
+        config_.target_quality.emplace();
+    config_.target_quality->samples = count;
+    config_.target_quality->sample_seconds = seconds;
+    return *this;
+}
+
+ReencodeJobBuilder& ReencodeJobBuilder::targetCrfRange(int min_crf, int max_crf) {
+    if (!config_.target_quality)
+        config_.target_quality.emplace();
+    config_.target_quality->min_crf = min_crf;
+    config_.target_quality->max_crf = max_crf;
+    return *this;
+}
+
 // ============================================================================
 // ENCODING PARAMETERS
 // ============================================================================
@@ -429,6 +454,31 @@ ReencodeJobBuilder& ReencodeJobBuilder::ffv1Preset() {
     return *this;
 }
 
+// ============================================================================
+// INPUT RANGE
+// ============================================================================
+
+ReencodeJobBuilder& ReencodeJobBuilder::range(double start_seconds, double duration_seconds) {
+    config_.start_time = start_seconds;
+    config_.duration = duration_seconds;
+    return *this;
+}
+
+// ============================================================================
+// CHUNKED ENCODING
+// ============================================================================
+
+ReencodeJobBuilder& ReencodeJobBuilder::chunked(double segment_seconds, int workers) {
+    config_.chunk_seconds = segment_seconds;
+    config_.chunk_workers = workers;
+    return *this;
+}
+
+ReencodeJobBuilder& ReencodeJobBuilder::chunkRetries(int retries) {
+    config_.chunk_retries = retries;
+    return *this;
+}
+
 // ============================================================================
 // ADVANCED OPTIONS
 // ============================================================================
@@ -438,6 +488,31 @@ ReencodeJobBuilder& ReencodeJobBuilder::container(const std::string& ext) {
     return *this;
 }
 
+ReencodeJobBuilder& ReencodeJobBuilder::overwrite(bool enabled) {
+    config_.overwrite = enabled;
+    return *this;
+}
+
+ReencodeJobBuilder& ReencodeJobBuilder::outputCache(bool enabled) {
+    config_.output_cache = enabled;
+    return *this;
+}
+
+ReencodeJobBuilder& ReencodeJobBuilder::hls(double segment_seconds) {
+    config_.streaming = Encode::StreamingOutput{Encode::StreamingFormat::HLS, segment_seconds};
+    return *this;
+}
+
+ReencodeJobBuilder& ReencodeJobBuilder::dash(double segment_seconds) {
+    config_.streaming = Encode::StreamingOutput{Encode::StreamingFormat::DASH, segment_seconds};
+    return *this;
+}
+
+ReencodeJobBuilder& ReencodeJobBuilder::noAudio() {
+    config_.audio.disabled = true;
+    return *this;
+}
+
 ReencodeJobBuilder& ReencodeJobBuilder::extraArgs(const std::vector<std::string>& args) {
     config_.extra_args = args;
     return *this;
@@ -474,6 +549,24 @@ void ReencodeJobBuilder::validate() const {
             throw std::runtime_error("Quality/CRF value must be between 0 and 51");
         }
     }
+    
+    // Range and chunking validation
+    if (config_.start_time < 0.0 || config_.duration < 0.0) {
+        throw std::runtime_error("Input range cannot be negative");
+    }
+    if (config_.chunk_seconds < 0.0 || config_.chunk_workers < 0 || config_.chunk_retries < 0) {
+        throw std::runtime_error("Chunk settings cannot be negative");
+    }
+    
+    // Streaming validation
+    if (config_.streaming) {
+        if (config_.streaming->segment_seconds <= 0.0) {
+            throw std::runtime_error("Streaming segment duration must be > 0");
+        }
+        if (config_.chunk_seconds > 0.0) {
+            throw std::runtime_error("Chunked encoding cannot write streaming segments");
+        }
+    }
 }
 
 // ============================================================================
@@ -0,0 +1,192 @@
+#include "../../include/jobs/scene_detector.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define SCENE_DETECTOR_AVX2 1
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define SCENE_DETECTOR_SSE2 1
+#endif
+
+namespace FFmpegMulti {
+namespace Jobs {
+
+// ============================================================================
+// CONSTRUCTOR
+// ============================================================================
+
+SceneDetector::SceneDetector(int width, int height, double frame_rate, double threshold, double min_scene_seconds)
+    : width_(width)
+    , height_(height)
+    , frame_rate_(frame_rate)
+    , threshold_(threshold)
+{
+    if (width <= 0 || height <= 0) {
+        throw std::invalid_argument("Scene detector frame size must be positive");
+    }
+    if (frame_rate <= 0.0) {
+        throw std::invalid_argument("Scene detector frame rate must be positive");
+    }
+
+    min_scene_frames_ = std::max<int64_t>(1, static_cast<int64_t>(std::llround(min_scene_seconds * frame_rate)));
+
+    size_t frameSize = static_cast<size_t>(width) * static_cast<size_t>(height);
+    current_.resize(frameSize);
+    previous_.resize(frameSize);
+    histogram_.assign(HISTOGRAM_BINS, 0);
+    previous_histogram_.assign(HISTOGRAM_BINS, 0);
+}
+
+void SceneDetector::setCutCallback(CutCallback callback) {
+    callback_ = std::move(callback);
+}
+
+// ============================================================================
+// ANALYSIS STREAM
+// ============================================================================
+
+std::pair<int, int> SceneDetector::analysisSize(int width, int height, int downscale) {
+    int w = std::max(64, width / std::max(1, downscale)) & ~1;
+    int h = std::max(2, static_cast<int>(static_cast<long long>(height) * w / width) & ~1);
+    return { w, h };
+}
+
+std::vector<std::string> SceneDetector::buildAnalysisArgs(const std::string& input, const std::string& frame_rate, int width, int height) {
+    std::ostringstream filter;
+    filter << "fps=" << frame_rate << ",scale=" << width << ":" << height << ":flags=area,format=gray";
+
+    return {
+        "-hide_banner",
+        "-i", input,
+        "-map", "0:v:0",
+        "-an", "-sn", "-dn",
+        "-vf", filter.str(),
+        "-f", "rawvideo",
+        "-pix_fmt", "gray",
+        "pipe:1"
+    };
+}
+
+// ============================================================================
+// METRICS
+// ============================================================================
+
+double SceneDetector::meanAbsoluteDifference(const uint8_t* a, const uint8_t* b, size_t size) {
+    if (size == 0) {
+        return 0.0;
+    }
+
+    uint64_t sum = 0;
+    size_t i = 0;
+
+#if defined(SCENE_DETECTOR_AVX2)
+    __m256i acc = _mm256_setzero_si256();
+    for (; i + 32 <= size; i += 32) {
+        __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+        __m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
+        acc = _mm256_add_epi64(acc, _mm256_sad_epu8(va, vb));
+    }
+    alignas(32) uint64_t lanes[4];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), acc);
+    sum = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+#elif defined(SCENE_DETECTOR_SSE2)
+    __m128i acc = _mm_setzero_si128();
+    for (; i + 16 <= size; i += 16) {
+        __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+        __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i));
+        acc = _mm_add_epi64(acc, _mm_sad_epu8(va, vb));
+    }
+    alignas(16) uint64_t lanes[2];
+    _mm_store_si128(reinterpret_cast<__m128i*>(lanes), acc);
+    sum = lanes[0] + lanes[1];
+#endif
+
+    // Tail, or the whole buffer without SIMD
+    for (; i < size; ++i) {
+        sum += static_cast<uint64_t>(a[i] > b[i] ? a[i] - b[i] : b[i] - a[i]);
+    }
+
+    return static_cast<double>(sum) / static_cast<double>(size);
+}
+
+// ============================================================================
+// FRAME STREAM
+// ============================================================================
+
+void SceneDetector::feed(const char* data, size_t size) {
+    while (size > 0) {
+        size_t take = std::min(size, current_.size() - filled_);
+        std::memcpy(current_.data() + filled_, data, take);
+        filled_ += take;
+        data += take;
+        size -= take;
+
+        if (filled_ == current_.size()) {
+            processFrame();
+            filled_ = 0;
+        }
+    }
+}
+
+void SceneDetector::processFrame() {
+    // Luma histogram, counted in 4 interleaved tables to avoid store-to-load stalls on flat areas
+    uint32_t counts[4][HISTOGRAM_BINS] = {};
+    const uint8_t* pixels = current_.data();
+    size_t size = current_.size();
+    size_t i = 0;
+    for (; i + 4 <= size; i += 4) {
+        counts[0][pixels[i] >> 2]++;
+        counts[1][pixels[i + 1] >> 2]++;
+        counts[2][pixels[i + 2] >> 2]++;
+        counts[3][pixels[i + 3] >> 2]++;
+    }
+    for (; i < size; ++i) {
+        counts[0][pixels[i] >> 2]++;
+    }
+    for (int bin = 0; bin < HISTOGRAM_BINS; ++bin) {
+        histogram_[bin] = counts[0][bin] + counts[1][bin] + counts[2][bin] + counts[3][bin];
+    }
+
+    if (frame_count_ > 0) {
+        double sad = meanAbsoluteDifference(current_.data(), previous_.data(), size) / 255.0;
+
+        // Half the L1 distance of the normalised histograms: 0 = identical, 1 = disjoint
+        uint64_t histDiff = 0;
+        for (int bin = 0; bin < HISTOGRAM_BINS; ++bin) {
+            histDiff += histogram_[bin] > previous_histogram_[bin] ? histogram_[bin] - previous_histogram_[bin]
+                                                                  : previous_histogram_[bin] - histogram_[bin];
+        }
+        double hist = static_cast<double>(histDiff) / (2.0 * static_cast<double>(size));
+
+        // Like ffmpeg's scene score, only the jump over the previous difference counts, so steady
+        // motion does not read as a cut; the histogram term must agree
+        double jump = std::min(sad, std::fabs(sad - previous_sad_));
+        double score = std::min(1.0, std::sqrt(jump * hist) * 2.0);
+        previous_sad_ = sad;
+
+        if (score >= threshold_ && frame_count_ - last_cut_frame_ >= min_scene_frames_) {
+            SceneCut cut;
+            cut.frame = frame_count_;
+            cut.time = static_cast<double>(frame_count_) / frame_rate_;
+            cut.score = score;
+            cuts_.push_back(cut);
+            last_cut_frame_ = frame_count_;
+            if (callback_) {
+                callback_(cut);
+            }
+        }
+    }
+
+    current_.swap(previous_);
+    histogram_.swap(previous_histogram_);
+    frame_count_++;
+}
+
+} // namespace Jobs
+} // namespace FFmpegMulti
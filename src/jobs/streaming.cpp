@@ -0,0 +1,230 @@
+#include "../../include/jobs/streaming.hpp"
+#include "../../include/jobs/probe.hpp"
+#include "../../include/core/path_utils.hpp"
+#include "../../include/pipeline/segments.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+
+namespace fs = std::filesystem;
+
+namespace FFmpegMulti {
+namespace Jobs {
+namespace Streaming {
+
+namespace {
+
+const char* SEGMENT_EXTENSION = ".m4s";
+const char* HLS_INIT_SUFFIX = "_init.mp4";
+const size_t SEGMENT_NUMBER_DIGITS = 5; // %05d
+
+// At least `min_digits` digits and nothing else
+bool isNumber(const std::string& text, size_t min_digits) {
+    return text.size() >= min_digits && std::all_of(text.begin(), text.end(), [](unsigned char c) { return std::isdigit(c) != 0; });
+}
+
+// ffmpeg expands % in segment names (printf-like numbering)
+std::string escapePercent(const std::string& name) {
+    std::string escaped;
+    for (char c : name) {
+        if (c == '%') {
+            escaped += '%';
+        }
+        escaped += c;
+    }
+    return escaped;
+}
+
+struct Variant {
+    fs::path playlist;
+    double peak_bps{0.0};
+    double average_bps{0.0};
+    int width{0};
+    int height{0};
+};
+
+// Segment durations and sizes of a media playlist written by the hls muxer
+bool measureVariant(Variant& variant, std::string& error) {
+    std::ifstream file(variant.playlist);
+    if (!file.is_open()) {
+        error = "cannot read " + variant.playlist.string();
+        return false;
+    }
+
+    fs::path dir = variant.playlist.parent_path();
+    double totalSeconds = 0.0;
+    double totalBits = 0.0;
+    double segmentSeconds = 0.0;
+    std::string line;
+    while (std::getline(file, line)) {
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+        if (line.rfind("#EXTINF:", 0) == 0) {
+            segmentSeconds = std::strtod(line.c_str() + 8, nullptr);
+            continue;
+        }
+        if (line.rfind("#EXT-X-MAP:URI=\"", 0) == 0) {
+            // The init segment is loaded once per switch: counted in the average only
+            std::error_code ec;
+            uintmax_t size = fs::file_size(dir / line.substr(16, line.find('"', 16) - 16), ec);
+            totalBits += ec ? 0.0 : static_cast<double>(size) * 8.0;
+            continue;
+        }
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+
+        std::error_code ec;
+        uintmax_t size = fs::file_size(dir / line, ec);
+        if (ec) {
+            error = "missing segment " + (dir / line).string();
+            return false;
+        }
+        double bits = static_cast<double>(size) * 8.0;
+        if (segmentSeconds > 0.0) {
+            variant.peak_bps = std::max(variant.peak_bps, bits / segmentSeconds);
+        }
+        totalBits += bits;
+        totalSeconds += segmentSeconds;
+        segmentSeconds = 0.0;
+    }
+    if (totalSeconds <= 0.0) {
+        error = "no segment in " + variant.playlist.string();
+        return false;
+    }
+    variant.average_bps = totalBits / totalSeconds;
+    variant.peak_bps = std::max(variant.peak_bps, variant.average_bps);
+
+    try {
+        const ::Jobs::ProbeStream* video = ::Jobs::ProbeJob::probe(variant.playlist.string()).firstStream("video");
+        if (video) {
+            variant.width = video->width;
+            variant.height = video->height;
+        }
+    } catch (const std::exception&) {
+        // RESOLUTION is optional
+    }
+    return true;
+}
+
+} // namespace
+
+// ============================================================================
+// MUXER ARGUMENTS
+// ============================================================================
+
+std::string keyframeExpression(double segment_seconds) {
+    return "expr:gte(t,n_forced*" + Pipeline::formatSeconds(segment_seconds) + ")";
+}
+
+std::vector<std::string> buildMuxerArgs(const Encode::StreamingOutput& streaming, const fs::path& playlist) {
+    std::string stem = escapePercent(playlist.stem().string());
+    std::string seconds = Pipeline::formatSeconds(streaming.segment_seconds);
+    std::vector<std::string> args;
+
+    if (streaming.format == Encode::StreamingFormat::HLS) {
+        fs::path segments = playlist.parent_path() / (stem + "_%05d" + SEGMENT_EXTENSION);
+        args = { "-f", "hls", "-hls_time", seconds, "-hls_playlist_type", "vod", "-hls_list_size", "0",
+                 "-hls_segment_type", "fmp4", "-hls_fmp4_init_filename", stem + HLS_INIT_SUFFIX,
+                 "-hls_segment_filename", segments.string(), "-hls_flags", "independent_segments" };
+    } else {
+        // Segment names are relative to the manifest
+        args = { "-f", "dash", "-seg_duration", seconds, "-use_template", "1", "-use_timeline", "1",
+                 "-init_seg_name", stem + "_init_$RepresentationID$" + SEGMENT_EXTENSION,
+                 "-media_seg_name", stem + "_$RepresentationID$_$Number%05d$" + SEGMENT_EXTENSION };
+    }
+    args.push_back(PathUtils::getPartialPath(playlist).string());
+    return args;
+}
+
+void removeSegments(Encode::StreamingFormat format, const fs::path& playlist) {
+    fs::path dir = playlist.parent_path().empty() ? fs::path(".") : playlist.parent_path();
+    std::string stem = playlist.stem().string();
+    std::string prefix = stem + "_";
+
+    // HLS: <stem>_init.mp4, <stem>_NNNNN.m4s
+    // DASH: <stem>_init_<id>.m4s, <stem>_<id>_NNNNN.m4s
+    auto isSegment = [&](const std::string& name) {
+        if (format == Encode::StreamingFormat::HLS && name == stem + HLS_INIT_SUFFIX) {
+            return true;
+        }
+        std::string extension = SEGMENT_EXTENSION;
+        if (name.size() <= prefix.size() + extension.size() || name.rfind(prefix, 0) != 0 ||
+            name.compare(name.size() - extension.size(), extension.size(), extension) != 0) {
+            return false;
+        }
+        std::string middle = name.substr(prefix.size(), name.size() - prefix.size() - extension.size());
+        if (format == Encode::StreamingFormat::HLS) {
+            return isNumber(middle, SEGMENT_NUMBER_DIGITS);
+        }
+        if (middle.rfind("init_", 0) == 0) {
+            return isNumber(middle.substr(5), 1);
+        }
+        size_t separator = middle.find('_');
+        return separator != std::string::npos && isNumber(middle.substr(0, separator), 1) &&
+               isNumber(middle.substr(separator + 1), SEGMENT_NUMBER_DIGITS);
+    };
+
+    std::error_code ec;
+    std::vector<fs::path> segments;
+    for (const auto& entry : fs::directory_iterator(dir, ec)) {
+        if (isSegment(entry.path().filename().string()) && entry.is_regular_file(ec)) {
+            segments.push_back(entry.path());
+        }
+    }
+    for (const auto& segment : segments) {
+        fs::remove(segment, ec);
+    }
+}
+
+// ============================================================================
+// MASTER PLAYLIST
+// ============================================================================
+
+bool writeMasterPlaylist(const std::vector<fs::path>& playlists, const fs::path& master, std::string& error) {
+    std::vector<Variant> variants;
+    for (const auto& playlist : playlists) {
+        Variant variant;
+        variant.playlist = playlist;
+        if (!measureVariant(variant, error)) {
+            return false;
+        }
+        variants.push_back(variant);
+    }
+    std::sort(variants.begin(), variants.end(), [](const Variant& a, const Variant& b) { return a.peak_bps > b.peak_bps; });
+
+    fs::path base = master.parent_path().empty() ? fs::path(".") : master.parent_path();
+    std::ostringstream text;
+    text << "#EXTM3U\n#EXT-X-VERSION:7\n#EXT-X-INDEPENDENT-SEGMENTS\n";
+    for (const auto& variant : variants) {
+        text << "#EXT-X-STREAM-INF:BANDWIDTH=" << static_cast<long long>(std::ceil(variant.peak_bps))
+             << ",AVERAGE-BANDWIDTH=" << static_cast<long long>(std::ceil(variant.average_bps));
+        if (variant.width > 0 && variant.height > 0) {
+            text << ",RESOLUTION=" << variant.width << "x" << variant.height;
+        }
+        text << "\n" << fs::relative(variant.playlist, base).generic_string() << "\n";
+    }
+
+    fs::path partial = PathUtils::getPartialPath(master);
+    {
+        std::ofstream file(partial, std::ios::binary | std::ios::trunc);
+        if (!file.is_open() || !(file << text.str())) {
+            error = "cannot write " + partial.string();
+            return false;
+        }
+    }
+    if (!PathUtils::commitPartial(partial, master)) {
+        error = "cannot move the master playlist to " + master.string();
+        return false;
+    }
+    return true;
+}
+
+} // namespace Streaming
+} // namespace Jobs
+} // namespace FFmpegMulti
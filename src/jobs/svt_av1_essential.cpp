@@ -1,19 +1,55 @@
 #include "../../include/jobs/svt_av1_essential.hpp"
 #include "../../include/core/path_utils.hpp"
 #include "../../include/core/colors.hpp"
+#include "../../include/core/ffmpeg_process.hpp"
+#include "../../include/jobs/probe.hpp"
+#include "../../include/pipeline/segments.hpp"
 #include <iostream>
+#include <iomanip>
 #include <sstream>
-#include <cstdlib>
 #include <stdexcept>
 #include <algorithm>
-
-#ifdef _WIN32
-#include <windows.h>
-#endif
+#include <atomic>
+#include <cmath>
+#include <mutex>
+#include <thread>
 
 namespace FFmpegMulti {
 namespace Jobs {
 
+namespace {
+
+// Native Auto-Boost settings
+const int PROBE_PRESET = 10; // Fast first pass, only used to measure each scene
+const double SCENE_THRESHOLD = 0.2;
+const int ANALYSIS_DOWNSCALE = 8;
+const double MIN_ZONE_SECONDS = 1.0; // Shorter scenes join the previous one (a keyframe each is costly)
+const double LOW_PERCENTILE = 0.15; // A zone is judged on its worst frames, not its average
+const double BOOST_STRENGTH = 40.0;
+const double AGGRESSIVE_BOOST_STRENGTH = 60.0;
+const double MAX_CRF_DELTA = 10.0;
+const double UNSHACKLED_MAX_CRF_DELTA = 20.0;
+
+// SVT-AV1-Essential takes CRF in quarter steps: "27.25", "30"
+std::string formatCrf(double crf) {
+    std::ostringstream text;
+    text << std::fixed << std::setprecision(2) << crf;
+    std::string value = text.str();
+    value.erase(value.find_last_not_of('0') + 1);
+    if (!value.empty() && value.back() == '.') {
+        value.pop_back();
+    }
+    return value;
+}
+
+std::filesystem::path zonePath(const std::filesystem::path& dir, const char* prefix, size_t index, const char* extension) {
+    std::ostringstream name;
+    name << prefix << "_" << std::setw(5) << std::setfill('0') << index << extension;
+    return dir / name.str();
+}
+
+} // namespace
+
 // ============================================================================
 // CONSTRUCTOR
 // ============================================================================
@@ -47,6 +83,18 @@ void SvtAv1EssentialJob::setCleanup(bool enabled) {
     config_.cleanup = enabled;
 }
 
+void SvtAv1EssentialJob::setExtractAudio(bool enabled) {
+    config_.extract_audio = enabled;
+}
+
+void SvtAv1EssentialJob::setNative(bool enabled) {
+    config_.native = enabled;
+}
+
+void SvtAv1EssentialJob::setWorkers(unsigned workers) {
+    config_.workers = workers;
+}
+
 SvtAv1EssentialJob::Config& SvtAv1EssentialJob::config() {
     return config_;
 }
@@ -91,32 +139,30 @@ std::filesystem::path SvtAv1EssentialJob::getAudioPath() const {
     return parent / (stem + "_audio.mka");
 }
 
-std::string SvtAv1EssentialJob::buildABECommand() const {
-    std::ostringstream cmd;
+std::vector<std::string> SvtAv1EssentialJob::buildABEArgs() const {
+    std::vector<std::string> args;
     
     std::filesystem::path extern_path = PathUtils::getExternPath();
     std::filesystem::path abe_script = extern_path / "scripts" / "ABE.ps1";
     
-    // Convert paths with forward slashes
-    std::string abe_str = abe_script.string();
-    std::string input_str = config_.input_path;
-    
-    std::replace(abe_str.begin(), abe_str.end(), '\\', '/');
-    std::replace(input_str.begin(), input_str.end(), '\\', '/');
-    
-    // PowerShell command
-    cmd << "powershell -ExecutionPolicy Bypass -File \"" << abe_str << "\"";
-    cmd << " -inputFile \"" << input_str << "\"";
-    cmd << " -quality " << getQualityString();
+    // PowerShell arguments (passed as a vector, no shell quoting needed)
+    args.push_back("-ExecutionPolicy");
+    args.push_back("Bypass");
+    args.push_back("-File");
+    args.push_back(abe_script.string());
+    args.push_back("-inputFile");
+    args.push_back(config_.input_path);
+    args.push_back("-quality");
+    args.push_back(getQualityString());
     
     if (config_.aggressive)
-        cmd << " -aggressive";
+        args.push_back("-aggressive");
     if (config_.unshackle)
-        cmd << " -unshackle";
+        args.push_back("-unshackle");
     if (config_.verbose)
-        cmd << " -verboseOutput";
+        args.push_back("-verboseOutput");
     
-    return cmd.str();
+    return args;
 }
 
 // ============================================================================
@@ -150,7 +196,7 @@ bool SvtAv1EssentialJob::validatePaths() {
 
 bool SvtAv1EssentialJob::extractAudio() {
     std::cout << std::endl;
-    std::cout << Colors::SAPPHIRE << Colors::BOLD << "[STEP 1/4] Extracting audio..." << Colors::RESET << std::endl;
+    std::cout << Colors::SAPPHIRE << Colors::BOLD << (config_.extract_audio ? "[STEP 1/4] Extracting audio..." : "[STEP 1/4] Audio") << Colors::RESET << std::endl;
     std::cout << Colors::BLUE << "────────────────────────────────────────────" << Colors::RESET << std::endl;
     
     // Create temporary directory
@@ -159,35 +205,32 @@ bool SvtAv1EssentialJob::extractAudio() {
         std::filesystem::create_directories(temp_dir);
     }
     
-    std::filesystem::path audio_path = getAudioPath();
-    std::filesystem::path extern_path = PathUtils::getExternPath();
-    std::filesystem::path ffmpeg_exe = extern_path / "ffmpeg.exe";
-    
-    // Convert paths to string with normal slashes for the command
-    std::string ffmpeg_str = ffmpeg_exe.string();
-    std::string input_str = config_.input_path;
-    std::string audio_str = audio_path.string();
+    if (!config_.extract_audio) {
+        // mkvmerge reads the audio tracks from the source during the final mux:
+        // one full read of the source and one audio write less
+        std::cout << Colors::GREEN << "[OK] Audio will be muxed straight from the source" << Colors::RESET << std::endl;
+        return true;
+    }
     
-    // Replace backslashes with forward slashes
-    std::replace(ffmpeg_str.begin(), ffmpeg_str.end(), '\\', '/');
-    std::replace(input_str.begin(), input_str.end(), '\\', '/');
-    std::replace(audio_str.begin(), audio_str.end(), '\\', '/');
+    std::filesystem::path audio_path = getAudioPath();
     
-    // FFmpeg command to extract audio
-    std::ostringstream cmd;
-    cmd << ffmpeg_str
-        << " -i \"" << input_str << "\""
-        << " -vn" // No video
-        << " -c:a copy" // Copy audio without re-encoding
-        << " \"" << audio_str << "\""
-        << " -y"; // Overwrite if exists
+    // FFmpeg arguments to extract audio
+    std::vector<std::string> args = {
+        "-y", // Overwrite if exists
+        "-i", config_.input_path,
+        "-vn", // No video
+        "-c:a", "copy", // Copy audio without re-encoding
+        audio_path.string()
+    };
     
-    std::cout << Colors::SUBTEXT << "[CMD] " << cmd.str() << Colors::RESET << std::endl;
+    ffmpegProcess ffmpeg(PathUtils::getToolPath("ffmpeg"), args);
+    ffmpeg.setEcho(false);
+    std::cout << Colors::SUBTEXT << "[CMD] " << ffmpeg.getCommandString() << Colors::RESET << std::endl;
     
-    int result = std::system(cmd.str().c_str());
+    ProcessResult result = runProcess(ffmpeg);
     
-    if (result != 0) {
-        std::cerr << Colors::RED << Colors::BOLD << "[ERROR] Audio extraction failed" << Colors::RESET << std::endl;
+    if (!result.success()) {
+        std::cerr << Colors::RED << Colors::BOLD << "[ERROR] Audio extraction failed (" << result.describe() << ")" << Colors::RESET << std::endl;
         return false;
     }
     
@@ -204,16 +247,17 @@ bool SvtAv1EssentialJob::runAutoBoost() {
     std::cout << Colors::SAPPHIRE << Colors::BOLD << "[STEP 2/4] SVT-AV1 Encoding via Auto-Boost..." << Colors::RESET << std::endl;
     std::cout << Colors::BLUE << "────────────────────────────────────────────" << Colors::RESET << std::endl;
     
-    std::string cmd = buildABECommand();
-    std::cout << Colors::SUBTEXT << "[CMD] " << cmd << Colors::RESET << std::endl;
+    ffmpegProcess powershell("powershell", buildABEArgs());
+    powershell.setEcho(false);
+    std::cout << Colors::SUBTEXT << "[CMD] " << powershell.getCommandString() << Colors::RESET << std::endl;
     std::cout << std::endl;
     std::cout << Colors::PEACH << "⏳ Encoding in progress (this may take a while)..." << Colors::RESET << std::endl;
     std::cout << std::endl;
     
-    int result = std::system(cmd.c_str());
+    ProcessResult result = runProcess(powershell);
     
-    if (result != 0) {
-        std::cerr << Colors::RED << Colors::BOLD << "[ERROR] Auto-Boost encoding failed" << Colors::RESET << std::endl;
+    if (!result.success()) {
+        std::cerr << Colors::RED << Colors::BOLD << "[ERROR] Auto-Boost encoding failed (" << result.describe() << ")" << Colors::RESET << std::endl;
         return false;
     }
     
@@ -229,6 +273,320 @@ bool SvtAv1EssentialJob::runAutoBoost() {
     return true;
 }
 
+// ============================================================================
+// STEP 2 (NATIVE): AUTO-BOOST WITHOUT POWERSHELL
+// ============================================================================
+
+double SvtAv1EssentialJob::getBaseCrf() const {
+    switch (config_.quality) {
+        case Quality::LOW: return 35.0;
+        case Quality::MEDIUM: return 30.0;
+        case Quality::HIGH: return 25.0;
+        default: return 25.0;
+    }
+}
+
+int SvtAv1EssentialJob::getFinalPreset() const {
+    switch (config_.quality) {
+        case Quality::LOW: return 6;
+        case Quality::MEDIUM: return 4;
+        case Quality::HIGH: return 2;
+        default: return 2;
+    }
+}
+
+std::filesystem::path SvtAv1EssentialJob::getNativeDir() const {
+    return getTempDir() / "native";
+}
+
+bool SvtAv1EssentialJob::detectZones(std::vector<AutoBoost::Zone>& zones, double& frameRate) {
+    ::Jobs::ProbeResult probe;
+    try {
+        probe = ::Jobs::ProbeJob::probe(config_.input_path);
+    } catch (const std::exception& e) {
+        std::cerr << Colors::RED << Colors::BOLD << "[ERROR] Cannot analyze input: " << Colors::RESET << Colors::RED << e.what() << Colors::RESET << std::endl;
+        return false;
+    }
+
+    const ::Jobs::ProbeStream* video = probe.firstStream("video");
+    frameRate = video ? video->frameRate() : 0.0;
+    if (!video || video->width <= 0 || video->height <= 0 || frameRate <= 0.0) {
+        std::cerr << Colors::RED << Colors::BOLD << "[ERROR] No video stream with a known size and frame rate in: "
+                  << Colors::RESET << Colors::RED << config_.input_path << Colors::RESET << std::endl;
+        return false;
+    }
+    frame_rate_ = video->r_frame_rate.empty() ? std::to_string(frameRate) : video->r_frame_rate;
+    frame_rate_value_ = frameRate;
+
+    auto analysis = SceneDetector::analysisSize(video->width, video->height, ANALYSIS_DOWNSCALE);
+    SceneDetector detector(analysis.first, analysis.second, frameRate, SCENE_THRESHOLD, MIN_ZONE_SECONDS);
+
+    ffmpegProcess ffmpeg(PathUtils::getToolPath("ffmpeg"),
+                         SceneDetector::buildAnalysisArgs(config_.input_path, frame_rate_, analysis.first, analysis.second));
+    ffmpeg.setEcho(false);
+    ffmpeg.setOutputCallback([&detector](const char* data, size_t size) { detector.feed(data, size); });
+    trackProgress(ffmpeg, probe.format.duration);
+    std::cout << Colors::SUBTEXT << "[INFO] Detecting scenes at " << analysis.first << "x" << analysis.second << Colors::RESET << std::endl;
+
+    ProcessResult result = runProcess(ffmpeg);
+    if (!result.success()) {
+        std::cerr << Colors::RED << Colors::BOLD << "[ERROR] Scene detection failed (" << result.describe() << ")" << Colors::RESET << std::endl;
+        return false;
+    }
+
+    int64_t maxFrames = static_cast<int64_t>(std::llround(config_.max_scene_seconds * frameRate));
+    zones = AutoBoost::planZones(detector.cuts(), detector.frameCount(), maxFrames);
+    if (zones.empty()) {
+        std::cerr << Colors::RED << Colors::BOLD << "[ERROR] No video frame decoded from: "
+                  << Colors::RESET << Colors::RED << config_.input_path << Colors::RESET << std::endl;
+        return false;
+    }
+
+    std::cout << Colors::GREEN << "[OK] " << detector.cuts().size() << " scene cut(s), " << zones.size() << " zone(s), "
+              << detector.frameCount() << " frames" << Colors::RESET << std::endl;
+    return true;
+}
+
+std::vector<std::string> SvtAv1EssentialJob::buildDecodeArgs(const AutoBoost::Zone& zone) const {
+    std::vector<std::string> args = { "-hide_banner", "-loglevel", "error" };
+    if (zone.start_frame > 0) {
+        // A quarter frame early so that rounding never drops the first frame of the zone
+        args.push_back("-ss");
+        args.push_back(Pipeline::formatSeconds((static_cast<double>(zone.start_frame) - 0.25) / frame_rate_value_));
+    }
+
+    // Same constant rate as the scene analysis, so frame indexes match
+    std::vector<std::string> tail = {
+        "-i", config_.input_path,
+        "-map", "0:v:0",
+        "-an", "-sn", "-dn",
+        "-vf", "fps=" + frame_rate_,
+        "-frames:v", std::to_string(zone.frame_count),
+        "-pix_fmt", "yuv420p10le",
+        "-strict", "-1",
+        "-f", "yuv4mpegpipe",
+        "pipe:1"
+    };
+    args.insert(args.end(), tail.begin(), tail.end());
+    return args;
+}
+
+bool SvtAv1EssentialJob::encodeZone(const AutoBoost::Zone& zone, int preset, double crf, const std::filesystem::path& ivf, const std::filesystem::path& log) {
+    ffmpegProcess decoder(PathUtils::getToolPath("ffmpeg"), buildDecodeArgs(zone));
+
+    std::vector<std::string> args = {
+        "-i", "stdin",
+        "--preset", std::to_string(preset),
+        "--crf", formatCrf(crf),
+        "--progress", "0",
+        "-b", ivf.string()
+    };
+    // Planned threads are shared by the zones encoded at once
+    unsigned threads = getCpuAllocation().threads;
+    if (threads > 0) {
+        args.insert(args.end() - 2, { "--lp", std::to_string(std::max(1u, threads / zoneWorkers())) });
+    }
+    ffmpegProcess encoder(PathUtils::getToolPath("SvtAv1EncApp", std::filesystem::path("env") / "svt-av1"), args);
+
+    for (ffmpegProcess* process : { &decoder, &encoder }) {
+        process->setEcho(false);
+        process->setLogFile(log);
+    }
+
+    // y4m frames go from the decoder to the encoder without touching the disk
+    auto results = runPipeline(decoder, encoder);
+    if (!results.first.success() || !results.second.success()) {
+        std::error_code ec;
+        std::filesystem::remove(ivf, ec);
+        if (!isCancelled()) {
+            std::cerr << Colors::RED << "[ERROR] Zone at frame " << zone.start_frame << " failed (decoder: " << results.first.describe()
+                      << ", encoder: " << results.second.describe() << "), see " << log << Colors::RESET << std::endl;
+        }
+        return false;
+    }
+    return true;
+}
+
+bool SvtAv1EssentialJob::measureZone(AutoBoost::Zone& zone, const std::filesystem::path& ivf, const std::filesystem::path& log, std::vector<double>& frameDb) {
+    std::vector<std::string> args = { "-hide_banner", "-loglevel", "error", "-i", ivf.string() };
+    if (zone.start_frame > 0) {
+        args.push_back("-ss");
+        args.push_back(Pipeline::formatSeconds((static_cast<double>(zone.start_frame) - 0.25) / frame_rate_value_));
+    }
+
+    // Per-frame SSIM of the probe encode against the source, printed on stdout
+    std::vector<std::string> tail = {
+        "-i", config_.input_path,
+        "-filter_complex", "[1:v:0]fps=" + frame_rate_ + ",format=yuv420p10le[ref];[0:v:0]format=yuv420p10le[dist];[dist][ref]ssim=stats_file=-",
+        "-frames:v", std::to_string(zone.frame_count),
+        "-f", "null", "-"
+    };
+    args.insert(args.end(), tail.begin(), tail.end());
+
+    ffmpegProcess ffmpeg(PathUtils::getToolPath("ffmpeg"), args);
+    ffmpeg.setEcho(false);
+    ffmpeg.setCaptureOutput(true);
+    ffmpeg.setLogFile(log);
+
+    ProcessResult result = runProcess(ffmpeg);
+    frameDb = AutoBoost::parseSsimStats(result.output);
+    if (!result.success() || frameDb.empty()) {
+        if (!isCancelled()) {
+            std::cerr << Colors::RED << "[ERROR] Quality measure of the zone at frame " << zone.start_frame << " failed ("
+                      << result.describe() << "), see " << log << Colors::RESET << std::endl;
+        }
+        return false;
+    }
+
+    double sum = 0.0;
+    for (double db : frameDb) {
+        sum += db;
+    }
+    zone.mean_db = sum / static_cast<double>(frameDb.size());
+    zone.low_db = AutoBoost::percentile(frameDb, LOW_PERCENTILE);
+    return true;
+}
+
+unsigned SvtAv1EssentialJob::zoneWorkers() const {
+    // SvtAv1EncApp is multi-threaded itself: a few zones at once are enough to fill the machine
+    unsigned cores = getCpuAllocation().threads > 0 ? getCpuAllocation().threads : Core::availableCores();
+    return config_.workers > 0 ? config_.workers : std::max(1u, cores / 4);
+}
+
+bool SvtAv1EssentialJob::forEachZone(size_t count, const std::function<bool(size_t)>& task) {
+    size_t workerCount = std::min<size_t>(zoneWorkers(), count);
+
+    std::atomic<size_t> next{0};
+    std::atomic<bool> failed{false};
+    auto worker = [&]() {
+        while (!isCancelled() && !failed) {
+            size_t index = next++;
+            if (index >= count) {
+                return;
+            }
+            if (!task(index)) {
+                failed = true;
+            }
+        }
+    };
+
+    std::vector<std::thread> workers;
+    for (size_t i = 0; i < workerCount; ++i) {
+        workers.emplace_back(worker);
+    }
+    for (auto& w : workers) {
+        w.join();
+    }
+    return !failed && !isCancelled();
+}
+
+bool SvtAv1EssentialJob::runNativeBoost() {
+    std::cout << std::endl;
+    std::cout << Colors::SAPPHIRE << Colors::BOLD << "[STEP 2/4] SVT-AV1 Encoding (native Auto-Boost)..." << Colors::RESET << std::endl;
+    std::cout << Colors::BLUE << "────────────────────────────────────────────" << Colors::RESET << std::endl;
+
+    std::filesystem::path dir = getNativeDir();
+    std::filesystem::create_directories(dir);
+
+    std::vector<AutoBoost::Zone> zones;
+    double frameRate = 0.0;
+    if (!detectZones(zones, frameRate)) {
+        return false;
+    }
+
+    // Pass 1: fast encode of every zone at the base CRF, then its SSIM against the source
+    double baseCrf = getBaseCrf();
+    std::mutex mutex;
+    double titleDbSum = 0.0;
+    size_t titleFrames = 0;
+
+    std::cout << Colors::PEACH << "⏳ Probe encode of " << zones.size() << " zone(s) (preset " << PROBE_PRESET
+              << ", CRF " << formatCrf(baseCrf) << ")..." << Colors::RESET << std::endl;
+    bool probed = forEachZone(zones.size(), [&](size_t index) {
+        std::filesystem::path ivf = zonePath(dir, "probe", index, ".ivf");
+        std::filesystem::path log = zonePath(dir, "zone", index, ".log");
+        std::vector<double> frameDb;
+        if (!encodeZone(zones[index], PROBE_PRESET, baseCrf, ivf, log) || !measureZone(zones[index], ivf, log, frameDb)) {
+            return false;
+        }
+        std::error_code ec;
+        std::filesystem::remove(ivf, ec);
+
+        double sum = 0.0;
+        for (double db : frameDb) {
+            sum += db;
+        }
+        std::lock_guard<std::mutex> lock(mutex);
+        titleDbSum += sum;
+        titleFrames += frameDb.size();
+        return true;
+    });
+    if (!probed) {
+        std::cerr << Colors::RED << Colors::BOLD << "[ERROR] Probe encode failed" << Colors::RESET << std::endl;
+        return false;
+    }
+
+    // One CRF per zone, from its worst frames relative to the title average
+    double titleMean = titleFrames > 0 ? titleDbSum / static_cast<double>(titleFrames) : 0.0;
+    double strength = config_.aggressive ? AGGRESSIVE_BOOST_STRENGTH : BOOST_STRENGTH;
+    double maxDelta = config_.unshackle ? UNSHACKLED_MAX_CRF_DELTA : MAX_CRF_DELTA;
+    double minCrf = baseCrf;
+    double maxCrf = baseCrf;
+    for (auto& zone : zones) {
+        zone.crf = AutoBoost::zoneCrf(baseCrf, zone.low_db, titleMean, strength, maxDelta);
+        minCrf = std::min(minCrf, zone.crf);
+        maxCrf = std::max(maxCrf, zone.crf);
+    }
+    AutoBoost::writeZones(zones, frameRate, dir / "zones.csv");
+    std::ostringstream summary;
+    summary << "[OK] Mean SSIM " << std::fixed << std::setprecision(2) << titleMean << " dB, zone CRF " << formatCrf(minCrf) << " - " << formatCrf(maxCrf);
+    std::cout << Colors::GREEN << summary.str() << Colors::RESET << std::endl;
+
+    // Pass 2: final encode of every zone at its own CRF
+    int64_t totalFrames = 0;
+    for (const auto& zone : zones) {
+        totalFrames += zone.frame_count;
+    }
+    std::atomic<int64_t> framesDone{0};
+    std::vector<std::filesystem::path> parts;
+    for (size_t i = 0; i < zones.size(); ++i) {
+        parts.push_back(zonePath(dir, "zone", i, ".ivf"));
+    }
+
+    std::cout << Colors::PEACH << "⏳ Final encode (preset " << getFinalPreset() << "), this may take a while..." << Colors::RESET << std::endl;
+    bool encoded = forEachZone(zones.size(), [&](size_t index) {
+        if (!encodeZone(zones[index], getFinalPreset(), zones[index].crf, parts[index], zonePath(dir, "zone", index, ".log"))) {
+            return false;
+        }
+        int64_t done = framesDone += zones[index].frame_count;
+        Core::Progress progress;
+        progress.frame = done;
+        progress.out_time_us = static_cast<int64_t>(static_cast<double>(done) / frameRate * 1e6);
+        progress.duration_seconds = static_cast<double>(totalFrames) / frameRate;
+        progress.finished = done == totalFrames;
+        reportProgress(progress);
+        return true;
+    });
+    if (!encoded) {
+        std::cerr << Colors::RED << Colors::BOLD << "[ERROR] Final encode failed" << Colors::RESET << std::endl;
+        return false;
+    }
+
+    std::filesystem::path ivf_path = getAviPath();
+    int64_t frames = 0;
+    std::string error;
+    if (!AutoBoost::concatIvf(parts, ivf_path, frames, error)) {
+        std::cerr << Colors::RED << Colors::BOLD << "[ERROR] Cannot join the zones: " << Colors::RESET << Colors::RED << error << Colors::RESET << std::endl;
+        return false;
+    }
+    if (frames != totalFrames) {
+        std::cerr << Colors::YELLOW << "[WARNING] " << frames << " frames encoded, " << totalFrames << " expected" << Colors::RESET << std::endl;
+    }
+
+    std::cout << Colors::GREEN << "[OK] Encoding finished: " << Colors::TEXT << ivf_path << Colors::RESET << std::endl;
+    return true;
+}
+
 // ============================================================================
 // STEP 3: FINAL MUXING
 // ============================================================================
@@ -241,54 +599,43 @@ bool SvtAv1EssentialJob::muxFinal() {
     std::filesystem::path ivf_path = getAviPath();
     std::filesystem::path audio_path = getAudioPath();
     
-    // Create output_temp.mkv next to the source video, not in the subfolder
-    std::filesystem::path input(config_.input_path);
-    std::filesystem::path parent = input.parent_path();
-    std::filesystem::path temp_mkv = parent / "output_temp.mkv";
-    
-    std::filesystem::path extern_path = PathUtils::getExternPath();
-    std::filesystem::path mkvmerge_exe = extern_path / "env" / "mkvtoolnix" / "mkvmerge.exe";
-    
-    // Convert paths to string with normal slashes
-    std::string mkvmerge_str = mkvmerge_exe.string();
-    std::string temp_mkv_str = temp_mkv.string();
-    std::string ivf_str = ivf_path.string();
-    std::string audio_str = audio_path.string();
-    
-    std::replace(mkvmerge_str.begin(), mkvmerge_str.end(), '\\', '/');
-    std::replace(temp_mkv_str.begin(), temp_mkv_str.end(), '\\', '/');
-    std::replace(ivf_str.begin(), ivf_str.end(), '\\', '/');
-    std::replace(audio_str.begin(), audio_str.end(), '\\', '/');
-    
-    // mkvmerge command to merge video and audio
-    std::ostringstream cmd;
-    cmd << mkvmerge_str
-        << " -o \"" << temp_mkv_str << "\""
-        << " \"" << ivf_str << "\""
-        << " \"" << audio_str << "\"";
+    // mkvmerge writes a temporary file in the destination folder, renamed once complete:
+    // no second copy of the output, and an interrupted mux never carries the final name
+    std::filesystem::path partial = PathUtils::getPartialPath(config_.output_path);
+    
+    std::filesystem::path mkvmerge_exe = PathUtils::getToolPath("mkvmerge", std::filesystem::path("env") / "mkvtoolnix");
+    
+    // mkvmerge arguments to merge video and audio
+    std::vector<std::string> args = {
+        "-o", partial.string(),
+        ivf_path.string()
+    };
+    if (config_.extract_audio) {
+        args.push_back(audio_path.string());
+    } else {
+        // Only the audio tracks (and chapters) of the source, its video being replaced by the IVF
+        args.insert(args.end(), {"--no-video", "--no-subtitles", "--no-buttons", "--no-attachments", config_.input_path});
+    }
     
-    std::cout << Colors::SUBTEXT << "[CMD] " << cmd.str() << Colors::RESET << std::endl;
+    ffmpegProcess mkvmerge(mkvmerge_exe, args);
+    mkvmerge.setEcho(false);
+    std::cout << Colors::SUBTEXT << "[CMD] " << mkvmerge.getCommandString() << Colors::RESET << std::endl;
     
-    int result = std::system(cmd.str().c_str());
+    ProcessResult result = runProcess(mkvmerge);
     
-    if (result != 0) {
-        std::cerr << Colors::RED << Colors::BOLD << "[ERROR] Muxing failed" << Colors::RESET << std::endl;
+    if (!result.success()) {
+        std::error_code ec;
+        std::filesystem::remove(partial, ec);
+        std::cerr << Colors::RED << Colors::BOLD << "[ERROR] Muxing failed (" << result.describe() << ")" << Colors::RESET << std::endl;
         return false;
     }
     
-    // Move the final file to the destination
-    try {
-        std::filesystem::copy_file(
-            temp_mkv, 
-            config_.output_path,
-            std::filesystem::copy_options::overwrite_existing
-        );
-        std::cout << Colors::GREEN << "[OK] Final file created: " << Colors::TEXT << config_.output_path << Colors::RESET << std::endl;
-    } catch (const std::exception& e) {
-        std::cerr << Colors::RED << Colors::BOLD << "[ERROR] Failed to copy final file: " 
-                  << Colors::RESET << Colors::RED << e.what() << Colors::RESET << std::endl;
+    if (!PathUtils::commitPartial(partial, config_.output_path)) {
+        std::cerr << Colors::RED << Colors::BOLD << "[ERROR] Failed to move final file into place: " 
+                  << Colors::RESET << Colors::RED << config_.output_path << Colors::RESET << std::endl;
         return false;
     }
+    std::cout << Colors::GREEN << "[OK] Final file created: " << Colors::TEXT << config_.output_path << Colors::RESET << std::endl;
     
     return true;
 }
@@ -328,6 +675,15 @@ bool SvtAv1EssentialJob::cleanup() {
 // MAIN EXECUTION
 // ============================================================================
 
+unsigned SvtAv1EssentialJob::threadDemand() const {
+    // Auto-Boost runs its own parallel encoder workers and fills the machine
+    return Core::availableCores();
+}
+
+std::string SvtAv1EssentialJob::encoderName() const {
+    return "SvtAv1EncApp"; // Both engines drive the standalone encoder
+}
+
 bool SvtAv1EssentialJob::execute() {
     const int TOTAL_WIDTH = 60;
     const int INNER_WIDTH = TOTAL_WIDTH - 2;
@@ -366,22 +722,29 @@ bool SvtAv1EssentialJob::execute() {
     std::cout << Colors::TEAL << "  • Aggressive: " << Colors::TEXT << (config_.aggressive ? "Yes" : "No") << Colors::RESET << std::endl;
     std::cout << Colors::TEAL << "  • Unshackle : " << Colors::TEXT << (config_.unshackle ? "Yes" : "No") << Colors::RESET << std::endl;
     std::cout << Colors::TEAL << "  • Cleanup   : " << Colors::TEXT << (config_.cleanup ? "Yes" : "No") << Colors::RESET << std::endl;
+    std::cout << Colors::TEAL << "  • Engine    : " << Colors::TEXT << (config_.native ? "Native" : "Auto-Boost script") << Colors::RESET << std::endl;
+    std::cout << Colors::TEAL << "  • Audio     : " << Colors::TEXT << (config_.extract_audio ? "Extracted first" : "Muxed from source") << Colors::RESET << std::endl;
     
     try {
         // Validation
         if (!validatePaths())
             return false;
-        // Step 1: Audio extraction
+        // Step 1: Audio extraction (each step ends the span of the previous one)
+        Core::Trace::Span step = traceStep("extract audio");
         if (!extractAudio())
             return false;
         // Step 2: Auto-Boost encoding
-        if (!runAutoBoost())
+        step = traceStep(config_.native ? "native boost" : "auto-boost");
+        if (!(config_.native ? runNativeBoost() : runAutoBoost()))
             return false;
         // Step 3: Final muxing
+        step = traceStep("mux");
         if (!muxFinal())
             return false;
         // Step 4: Cleanup
+        step = traceStep("cleanup");
         cleanup();
+        step.end();
         
         std::cout << std::endl;
         std::cout << Colors::BLUE;
@@ -440,6 +803,21 @@ SvtAv1EssentialBuilder& SvtAv1EssentialBuilder::cleanup(bool enabled) {
     return *this;
 }
 
+SvtAv1EssentialBuilder& SvtAv1EssentialBuilder::extractAudio(bool enabled) {
+    config_.extract_audio = enabled;
+    return *this;
+}
+
+SvtAv1EssentialBuilder& SvtAv1EssentialBuilder::native(bool enabled) {
+    config_.native = enabled;
+    return *this;
+}
+
+SvtAv1EssentialBuilder& SvtAv1EssentialBuilder::workers(unsigned count) {
+    config_.workers = count;
+    return *this;
+}
+
 SvtAv1EssentialJob SvtAv1EssentialBuilder::build() {
     if (config_.input_path.empty())
         throw std::runtime_error("Input path is required");
@@ -1,4 +1,5 @@
 #include "../../include/jobs/thumbnails.hpp"
+#include "../../include/jobs/probe.hpp"
 #include "../../include/core/ffmpeg_process.hpp"
 #include "../../include/core/path_utils.hpp"
 #include <iostream>
@@ -6,6 +7,10 @@
 #include <filesystem>
 #include <stdexcept>
 #include <iomanip>
+#include <fstream>
+#include <atomic>
+#include <thread>
+#include <algorithm>
 
 namespace fs = std::filesystem;
 
@@ -52,13 +57,16 @@ bool ThumbnailsJob::validatePaths() const {
     return true;
 }
 
+std::string ThumbnailsJob::getTargetDir() const {
+    if (config_.create_subfolder && !config_.subfolder_name.empty()) {
+        return (fs::path(config_.output_dir) / config_.subfolder_name).string();
+    }
+    return config_.output_dir;
+}
+
 bool ThumbnailsJob::createOutputDirectory() const {
     try {
-        std::string target_dir = config_.output_dir;
-        
-        if (config_.create_subfolder && !config_.subfolder_name.empty()) {
-            target_dir = (fs::path(config_.output_dir) / config_.subfolder_name).string();
-        }
+        std::string target_dir = getTargetDir();
 
         if (!fs::exists(target_dir)) {
             fs::create_directories(target_dir);
@@ -73,14 +81,16 @@ bool ThumbnailsJob::createOutputDirectory() const {
 }
 
 std::string ThumbnailsJob::getOutputPattern() const {
-    std::string target_dir = config_.output_dir;
-    
-    if (config_.create_subfolder && !config_.subfolder_name.empty()) {
-        target_dir = (fs::path(config_.output_dir) / config_.subfolder_name).string();
-    }
-
     std::string extension = getFileExtension();
-    return (fs::path(target_dir) / ("thumb_%08d" + extension)).string();
+    return (fs::path(getTargetDir()) / ("thumb_%08d" + extension)).string();
+}
+
+std::string ThumbnailsJob::getCutListPath() const {
+    return (fs::path(getTargetDir()) / "scene_cuts.csv").string();
+}
+
+const std::vector<SceneCut>& ThumbnailsJob::getCuts() const {
+    return cuts_;
 }
 
 std::string ThumbnailsJob::getFileExtension() const {
@@ -103,31 +113,7 @@ std::string ThumbnailsJob::getSceneFilter() const {
     return oss.str();
 }
 
-// ============================================================================
-// COMMAND CONSTRUCTION
-// ============================================================================
-
-std::vector<std::string> ThumbnailsJob::buildCommand() const {
-    std::vector<std::string> args;
-
-    // Global options
-    args.push_back("-hide_banner");
-    args.push_back("-i");
-    args.push_back(config_.input_path);
-
-    // Scaling and color conversion
-    args.push_back("-sws_flags");
-    args.push_back("spline+accurate_rnd+full_chroma_int");
-
-    // Scene detection filter + showinfo
-    args.push_back("-vf");
-    args.push_back(getSceneFilter());
-
-    // vsync vfr for variable frame rate (avoid duplications)
-    args.push_back("-vsync");
-    args.push_back("vfr");
-
-    // Configuration according to format
+void ThumbnailsJob::appendFormatArgs(std::vector<std::string>& args) const {
     switch (config_.format) {
         case ThumbnailFormat::PNG:
             args.push_back("-color_trc");
@@ -136,14 +122,10 @@ std::vector<std::string> ThumbnailsJob::buildCommand() const {
             args.push_back("2");
             args.push_back("-color_primaries");
             args.push_back("2");
-            args.push_back("-map");
-            args.push_back("0:v");
             args.push_back("-c:v");
             args.push_back("png");
             args.push_back("-pix_fmt");
             args.push_back("rgb24");
-            args.push_back("-start_number");
-            args.push_back("0");
             break;
 
         case ThumbnailFormat::TIFF:
@@ -153,16 +135,12 @@ std::vector<std::string> ThumbnailsJob::buildCommand() const {
             args.push_back("1");
             args.push_back("-color_primaries");
             args.push_back("1");
-            args.push_back("-map");
-            args.push_back("0:v");
             args.push_back("-c:v");
             args.push_back("tiff");
             args.push_back("-pix_fmt");
             args.push_back("rgb24");
             args.push_back("-compression_algo");
             args.push_back("deflate");
-            args.push_back("-start_number");
-            args.push_back("0");
             args.push_back("-movflags");
             args.push_back("frag_keyframe+empty_moov+delay_moov+use_metadata_tags+write_colr");
             args.push_back("-bf");
@@ -176,18 +154,46 @@ std::vector<std::string> ThumbnailsJob::buildCommand() const {
             args.push_back("2");
             args.push_back("-color_primaries");
             args.push_back("2");
-            args.push_back("-map");
-            args.push_back("0:v");
             args.push_back("-c:v");
             args.push_back("mjpeg");
             args.push_back("-pix_fmt");
             args.push_back("yuvj420p");
             args.push_back("-q:v");
             args.push_back("1");
-            args.push_back("-start_number");
-            args.push_back("0");
             break;
     }
+}
+
+// ============================================================================
+// COMMAND CONSTRUCTION
+// ============================================================================
+
+std::vector<std::string> ThumbnailsJob::buildCommand() const {
+    std::vector<std::string> args;
+
+    // Global options
+    args.push_back("-hide_banner");
+    args.push_back("-i");
+    args.push_back(config_.input_path);
+
+    // Scaling and color conversion
+    args.push_back("-sws_flags");
+    args.push_back("spline+accurate_rnd+full_chroma_int");
+
+    // Scene detection filter + showinfo
+    args.push_back("-vf");
+    args.push_back(getSceneFilter());
+
+    // vsync vfr for variable frame rate (avoid duplications)
+    args.push_back("-vsync");
+    args.push_back("vfr");
+
+    // Configuration according to format
+    args.push_back("-map");
+    args.push_back("0:v");
+    appendFormatArgs(args);
+    args.push_back("-start_number");
+    args.push_back("0");
 
     // Output pattern
     args.push_back(getOutputPattern());
@@ -225,6 +231,10 @@ bool ThumbnailsJob::execute() {
         return false;
     }
 
+    return config_.native_detection ? executeNative() : executeFilter();
+}
+
+bool ThumbnailsJob::executeFilter() {
     // Command construction
     auto args = buildCommand();
     
@@ -233,22 +243,170 @@ bool ThumbnailsJob::execute() {
     std::cout << "[INFO] Scene detection threshold: " << config_.scene_threshold << std::endl;
     
     // Execution via FFmpegProcess
-    std::filesystem::path extern_path = FFmpegMulti::PathUtils::getExternPath();
-    std::filesystem::path ffmpeg_path = extern_path / "ffmpeg.exe";
+    std::filesystem::path ffmpeg_path = FFmpegMulti::PathUtils::getToolPath("ffmpeg");
     
     ffmpegProcess ffmpeg(ffmpeg_path, args);
-    bool success = ffmpeg.execute();
+    if (hasProgressCallback()) {
+        trackProgress(ffmpeg, ::Jobs::ProbeJob::probeDuration(config_.input_path));
+    }
+    ProcessResult result = runProcess(ffmpeg);
 
-    if (success) {
+    if (result.success()) {
         std::cout << "[SUCCESS] Thumbnails extraction completed successfully!" << std::endl;
-        std::cout << "[INFO] Thumbnails extracted in: " << (config_.create_subfolder && !config_.subfolder_name.empty() 
-            ? (fs::path(config_.output_dir) / config_.subfolder_name).string() : config_.output_dir) << std::endl;
+        std::cout << "[INFO] Thumbnails extracted in: " << getTargetDir() << std::endl;
         std::cout << "[INFO] Only images corresponding to scene changes were extracted." << std::endl;
     } else {
-        std::cerr << "[ERROR] Thumbnails extraction failed!" << std::endl;
+        std::cerr << "[ERROR] Thumbnails extraction failed! (" << result.describe() << ")" << std::endl;
+    }
+
+    return result.success();
+}
+
+bool ThumbnailsJob::executeNative() {
+    cuts_.clear();
+
+    std::cout << "[INFO] Scene detection threshold: " << config_.scene_threshold << std::endl;
+    if (!detectScenes()) {
+        return false;
+    }
+    std::cout << "[INFO] " << cuts_.size() << " scene cut(s) detected" << std::endl;
+
+    if (writeCutList()) {
+        std::cout << "[INFO] Cut list written to: " << getCutListPath() << std::endl;
+    }
+
+    if (!extractSceneFrames()) {
+        return false;
+    }
+
+    std::cout << "[SUCCESS] Thumbnails extraction completed successfully!" << std::endl;
+    std::cout << "[INFO] Thumbnails extracted in: " << getTargetDir() << std::endl;
+    return true;
+}
+
+bool ThumbnailsJob::detectScenes() {
+    ::Jobs::ProbeResult probe;
+    try {
+        probe = ::Jobs::ProbeJob::probe(config_.input_path);
+    } catch (const std::exception& e) {
+        std::cerr << "[ERROR] Cannot analyze input: " << e.what() << std::endl;
+        return false;
     }
 
-    return success;
+    const ::Jobs::ProbeStream* video = probe.firstStream("video");
+    double frameRate = video ? video->frameRate() : 0.0;
+    if (!video || video->width <= 0 || video->height <= 0 || frameRate <= 0.0) {
+        std::cerr << "[ERROR] No video stream with a known size and frame rate in: " << config_.input_path << std::endl;
+        return false;
+    }
+
+    auto analysis = SceneDetector::analysisSize(video->width, video->height, config_.analysis_downscale);
+    int width = analysis.first;
+    int height = analysis.second;
+    std::vector<std::string> args = SceneDetector::buildAnalysisArgs(
+        config_.input_path, video->r_frame_rate.empty() ? std::to_string(frameRate) : video->r_frame_rate, width, height);
+
+    std::cout << "[INFO] Analyzing scenes at " << width << "x" << height << std::endl;
+
+    SceneDetector detector(width, height, frameRate, config_.scene_threshold, config_.min_scene_seconds);
+
+    ffmpegProcess ffmpeg(FFmpegMulti::PathUtils::getToolPath("ffmpeg"), args);
+    ffmpeg.setOutputCallback([&detector](const char* data, size_t size) { detector.feed(data, size); });
+    trackProgress(ffmpeg, probe.format.duration);
+    ProcessResult result = runProcess(ffmpeg);
+
+    if (!result.success()) {
+        std::cerr << "[ERROR] Scene analysis failed! (" << result.describe() << ")" << std::endl;
+        return false;
+    }
+
+    cuts_ = detector.cuts();
+    frame_rate_ = frameRate;
+    return true;
+}
+
+bool ThumbnailsJob::writeCutList() const {
+    std::ofstream file(getCutListPath());
+    if (!file.is_open()) {
+        std::cerr << "[WARN] Cannot write cut list: " << getCutListPath() << std::endl;
+        return false;
+    }
+
+    file << "frame,time,score\n";
+    file << std::fixed;
+    for (const auto& cut : cuts_) {
+        file << cut.frame << "," << std::setprecision(6) << cut.time << "," << std::setprecision(4) << cut.score << "\n";
+    }
+    return true;
+}
+
+bool ThumbnailsJob::extractSceneFrames() {
+    // First frame of every new scene, numbered from 0 like the filter mode: thumb N is row N of the cut list
+    std::vector<double> starts;
+    for (const auto& cut : cuts_) {
+        starts.push_back(cut.time);
+    }
+
+    // One short process per frame: input seeking decodes from the nearest keyframe only
+    std::string extension = getFileExtension();
+    std::atomic<size_t> next{0};
+    std::atomic<size_t> failed{0};
+
+    auto worker = [&]() {
+        while (!isCancelled()) {
+            size_t index = next++;
+            if (index >= starts.size()) {
+                return;
+            }
+
+            std::ostringstream name;
+            name << "thumb_" << std::setw(8) << std::setfill('0') << index << extension;
+
+            // Seek a quarter frame early so rounding never skips the cut frame
+            std::ostringstream seek;
+            seek << std::fixed << std::setprecision(6) << std::max(0.0, starts[index] - 0.25 / frame_rate_);
+
+            std::vector<std::string> args = {
+                "-hide_banner", "-loglevel", "error", "-y",
+                "-ss", seek.str(),
+                "-i", config_.input_path,
+                "-sws_flags", "spline+accurate_rnd+full_chroma_int",
+                "-map", "0:v:0",
+                "-frames:v", "1"
+            };
+            appendFormatArgs(args);
+            args.push_back((fs::path(getTargetDir()) / name.str()).string());
+
+            ffmpegProcess ffmpeg(FFmpegMulti::PathUtils::getToolPath("ffmpeg"), args);
+            ffmpeg.setEcho(false);
+            if (!runProcess(ffmpeg).success()) {
+                failed++;
+            }
+        }
+    };
+
+    unsigned cores = getCpuAllocation().threads > 0 ? getCpuAllocation().threads : Core::availableCores();
+    size_t workerCount = std::min<size_t>(starts.size(), std::min(4u, cores));
+
+    std::cout << "[INFO] Extracting " << starts.size() << " frame(s), " << workerCount << " in parallel" << std::endl;
+
+    std::vector<std::thread> workers;
+    for (size_t i = 0; i < workerCount; ++i) {
+        workers.emplace_back(worker);
+    }
+    for (auto& w : workers) {
+        w.join();
+    }
+
+    if (isCancelled()) {
+        std::cerr << "[ERROR] Thumbnails extraction cancelled" << std::endl;
+        return false;
+    }
+    if (failed > 0) {
+        std::cerr << "[ERROR] " << failed << " thumbnail(s) could not be extracted" << std::endl;
+        return false;
+    }
+    return true;
 }
 
 } // namespace Jobs
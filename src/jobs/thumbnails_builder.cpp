@@ -41,6 +41,27 @@ ThumbnailsBuilder& ThumbnailsBuilder::sceneThreshold(float threshold) {
     return *this;
 }
 
+ThumbnailsBuilder& ThumbnailsBuilder::nativeDetection(bool enabled) {
+    config_.native_detection = enabled;
+    return *this;
+}
+
+ThumbnailsBuilder& ThumbnailsBuilder::analysisDownscale(int factor) {
+    if (factor < 1) {
+        throw std::invalid_argument("Analysis downscale factor must be at least 1");
+    }
+    config_.analysis_downscale = factor;
+    return *this;
+}
+
+ThumbnailsBuilder& ThumbnailsBuilder::minSceneSeconds(double seconds) {
+    if (seconds < 0.0) {
+        throw std::invalid_argument("Minimum scene duration cannot be negative");
+    }
+    config_.min_scene_seconds = seconds;
+    return *this;
+}
+
 // ============================================================================
 // BUILDER - SHORTCUTS
 // ============================================================================
@@ -1,11 +1,18 @@
 #include <iostream>
+#include <string>
+#include <vector>
+#include "cli/cli.hpp"
 #include "core/app.hpp"
 
-int main() {
+int main(int argc, char** argv) {
+    // Any argument selects the non-interactive mode: no menu is ever drawn
+    if (argc > 1) {
+        return FFmpegMulti::Cli::run(std::vector<std::string>(argv + 1, argv + argc));
+    }
+
     do {
         App::affiche();
     } while (App::choice());
 
     return 0;
 }
-
@@ -0,0 +1,404 @@
+#include "../../include/pipeline/batch_runner.hpp"
+#include "../../include/core/json.hpp"
+#include "../../include/core/path_utils.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <fstream>
+#include <future>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <thread>
+
+namespace FFmpegMulti {
+namespace Pipeline {
+
+// ============================================================================
+// CONSTRUCTOR
+// ============================================================================
+
+BatchRunner::BatchRunner(BatchOptions options) : options_(std::move(options)) {}
+
+// ============================================================================
+// QUEUE
+// ============================================================================
+
+void BatchRunner::add(std::unique_ptr<Core::Job> job, const std::string& name) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Entry entry;
+    entry.job = std::move(job);
+    entry.name = name;
+    entries_.push_back(std::move(entry));
+}
+
+void BatchRunner::add(std::unique_ptr<Core::Job> job, const std::string& name, const std::string& fingerprint, const std::filesystem::path& output,
+                      int max_retries) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Entry entry;
+    entry.job = std::move(job);
+    entry.name = name;
+    entry.fingerprint = fingerprint;
+    entry.output = output;
+    entry.max_retries = max_retries;
+    entries_.push_back(std::move(entry));
+}
+
+size_t BatchRunner::size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return entries_.size();
+}
+
+BatchOptions& BatchRunner::options() {
+    return options_;
+}
+
+unsigned BatchRunner::recommendedConcurrency() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (entries_.empty()) {
+        return 1;
+    }
+
+    unsigned cores = options_.resources.threads > 0 ? options_.resources.threads : Core::availableCores();
+
+    // Size the pool for the heaviest job so the machine is never oversubscribed
+    unsigned demand = 1;
+    for (const auto& entry : entries_) {
+        demand = std::max(demand, entry.job->threadDemand());
+    }
+
+    unsigned workers = std::max(1u, cores / demand);
+    return static_cast<unsigned>(std::min<size_t>(workers, entries_.size()));
+}
+
+// ============================================================================
+// EXECUTION
+// ============================================================================
+
+BatchSummary BatchRunner::run() {
+    BatchSummary summary;
+    const size_t total = size();
+    if (total == 0) {
+        return summary;
+    }
+
+    unsigned concurrency = options_.concurrency > 0 ? options_.concurrency : recommendedConcurrency();
+    concurrency = static_cast<unsigned>(std::min<size_t>(concurrency, total));
+
+    if (!options_.log_dir.empty()) {
+        std::filesystem::create_directories(options_.log_dir);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        results_.assign(total, BatchJobResult());
+        for (size_t i = 0; i < total; ++i) {
+            results_[i].name = entries_[i].name;
+            results_[i].cancelled = true; // Until a worker picks the job up
+        }
+        next_ = 0;
+        done_ = 0;
+    }
+    stopping_ = false;
+    if (options_.prometheus) {
+        options_.prometheus->batchStarted(total);
+    }
+    if (!options_.trace_file.empty()) {
+        trace_ = std::make_shared<Core::Trace>();
+        trace_track_ = trace_->addTrack("batch", "worker");
+        std::lock_guard<std::mutex> lock(mutex_);
+        traceQueue();
+    }
+
+    std::cout << "[BATCH] " << total << " job(s), " << concurrency << " in parallel" << std::endl;
+    auto start = std::chrono::steady_clock::now();
+
+    std::vector<Core::CpuAllocation> plan(concurrency);
+    if (options_.plan_cpus) {
+        plan = Core::planAllocations(Core::CpuTopology::system(), concurrency, options_.resources);
+    }
+
+    std::vector<std::thread> workers;
+    for (unsigned i = 0; i < concurrency; ++i) {
+        workers.emplace_back(&BatchRunner::worker, this, total, plan[i]);
+    }
+
+    // Wait for the workers, polling the stop request of the caller
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (done_ < total && !(stopping_ && std::none_of(entries_.begin(), entries_.end(), [](const Entry& e) { return e.running; }))) {
+            finished_cv_.wait_for(lock, std::chrono::milliseconds(200));
+            if (!stopping_ && options_.should_stop) {
+                lock.unlock();
+                if (options_.should_stop()) {
+                    cancel();
+                }
+                lock.lock();
+            }
+        }
+    }
+
+    for (auto& w : workers) {
+        w.join();
+    }
+
+    summary.wall_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    summary.concurrency = concurrency;
+    size_t skipped;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        summary.results = results_;
+        skipped = total - next_;
+    }
+    if (options_.prometheus) {
+        options_.prometheus->batchFinished(skipped);
+    }
+    for (const auto& result : summary.results) {
+        if (result.success) {
+            summary.succeeded++;
+            if (result.resumed) {
+                summary.resumed++;
+            }
+        } else if (result.cancelled) {
+            summary.cancelled++;
+        } else {
+            summary.failed++;
+        }
+    }
+
+    if (!options_.metrics_file.empty() && !writeMetrics(summary)) {
+        std::cerr << "[BATCH] Cannot write the metrics report " << options_.metrics_file.string() << std::endl;
+    }
+    if (trace_) {
+        if (!trace_->write(options_.trace_file)) {
+            std::cerr << "[BATCH] Cannot write the trace " << options_.trace_file.string() << std::endl;
+        }
+        trace_.reset();
+    }
+    return summary;
+}
+
+void BatchRunner::cancel() {
+    stopping_ = true;
+
+    std::vector<Core::Job*> running;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto& entry : entries_) {
+            if (entry.running) {
+                running.push_back(entry.job.get());
+            }
+        }
+    }
+
+    // Stop all running jobs concurrently so their grace periods overlap
+    std::vector<std::future<void>> pending;
+    for (Core::Job* job : running) {
+        pending.push_back(std::async(std::launch::async, [job]() { job->cancel(); }));
+    }
+    for (auto& p : pending) {
+        p.wait();
+    }
+    finished_cv_.notify_all();
+}
+
+void BatchRunner::worker(size_t total, const Core::CpuAllocation& allocation) {
+    int lane = trace_ ? trace_->acquireLane(trace_track_) : 0;
+    while (true) {
+        size_t index;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (stopping_ || next_ >= total) {
+                break;
+            }
+            index = next_++;
+            entries_[index].running = true;
+            if (trace_) {
+                traceQueue();
+            }
+        }
+        Core::Job& job = *entries_[index].job;
+        if (options_.plan_cpus) {
+            job.setCpuAllocation(allocation);
+        }
+        // The job records on a track of its own, then gets its previous trace settings back
+        std::shared_ptr<Core::Trace> jobTrace = job.getTrace();
+        int jobTraceTrack = job.getTraceTrack();
+        auto start = Core::Trace::Clock::now();
+        if (trace_) {
+            entries_[index].trace_track = trace_->addTrack(entries_[index].name);
+            job.setTrace(trace_, entries_[index].trace_track);
+        }
+
+        // The exporter listens to the progress of the job, next to its own listener
+        Core::ProgressCallback listener = job.getProgressCallback();
+        std::shared_ptr<PrometheusExporter> prometheus = options_.prometheus;
+        if (prometheus) {
+            prometheus->jobStarted(index, entries_[index].name, job.encoderName());
+            job.setProgressCallback([prometheus, index, listener](const Core::Progress& progress) {
+                prometheus->jobProgress(index, progress);
+                if (listener) {
+                    listener(progress);
+                }
+            });
+        }
+
+        BatchJobResult result = runEntry(index);
+
+        if (prometheus) {
+            job.setProgressCallback(listener);
+            prometheus->jobFinished(index, result);
+        }
+
+        if (trace_) {
+            std::string outcome = result.resumed ? "resumed" : (result.success ? "succeeded" : (result.cancelled ? "cancelled" : "failed"));
+            std::string args = "\"outcome\":" + Json::quote(outcome) + ",\"attempts\":" + std::to_string(result.attempts) +
+                               ",\"threads\":" + std::to_string(job.getCpuAllocation().threads);
+            auto end = Core::Trace::Clock::now();
+            trace_->complete(trace_track_, lane, entries_[index].name, "job", start, end, args);
+            trace_->complete(entries_[index].trace_track, 0, entries_[index].name, "job", start, end, args);
+            job.setTrace(jobTrace, jobTraceTrack);
+        }
+
+        size_t done;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            entries_[index].running = false;
+            results_[index] = result;
+            done = ++done_;
+            if (trace_) {
+                traceQueue();
+            }
+        }
+        finished_cv_.notify_all();
+
+        if (options_.on_job_finished) {
+            std::lock_guard<std::mutex> lock(callback_mutex_);
+            options_.on_job_finished(result, done, total);
+        }
+    }
+    if (trace_) {
+        trace_->releaseLane(trace_track_, lane);
+    }
+}
+
+void BatchRunner::traceQueue() {
+    trace_->counter(trace_track_, "jobs", Core::Trace::Clock::now(), {
+        { "running", static_cast<double>(next_ - done_) },
+        { "queued", static_cast<double>(entries_.size() - next_) }
+    });
+}
+
+BatchJobResult BatchRunner::runEntry(size_t index) {
+    Core::Job& job = *entries_[index].job;
+    const Entry& entry = entries_[index];
+    Journal* journal = entry.fingerprint.empty() ? nullptr : options_.journal.get();
+
+    BatchJobResult result;
+    result.name = entry.name;
+
+    Core::Trace::Span check = trace_ && journal && options_.resume ? trace_->span(entry.trace_track, 0, "journal check", "step") : Core::Trace::Span();
+    if (journal && options_.resume && journal->isComplete(entry.fingerprint, options_.verify_resumed)) {
+        result.success = true;
+        result.resumed = true;
+        return result;
+    }
+    check.end();
+    // A transition that cannot be recorded would make a later resume lie: do not run
+    if (journal && !journal->record(entry.fingerprint, JournalState::STARTED, entry.name, entry.output)) {
+        result.error = "Cannot write the journal " + journal->getFilePath().string();
+        return result;
+    }
+    if (!options_.log_dir.empty()) {
+        result.log_file = getLogPath(index);
+        job.setLogFile(result.log_file);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    const int maxRetries = entry.max_retries >= 0 ? entry.max_retries : options_.max_retries;
+    for (int attempt = 0; attempt <= maxRetries; ++attempt) {
+        if (attempt > 0) {
+            if (stopping_ || job.isCancelled()) {
+                break;
+            }
+            std::cout << "[BATCH] Retrying " << result.name << " (attempt " << attempt + 1 << ")" << std::endl;
+        }
+
+        result.attempts++;
+        Core::Trace::Span span = trace_ ? trace_->span(entry.trace_track, 0, "attempt " + std::to_string(attempt + 1), "attempt") : Core::Trace::Span();
+        try {
+            result.success = job.execute();
+            result.error.clear();
+        } catch (const std::exception& e) {
+            result.success = false;
+            result.error = e.what();
+        }
+
+        if (result.success) {
+            break;
+        }
+    }
+    result.wall_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    result.cancelled = !result.success && (stopping_ || job.isCancelled());
+    result.metrics = job.getMetrics();
+
+    if (journal) {
+        JournalState state = result.success ? JournalState::DONE : (result.cancelled ? JournalState::CANCELLED : JournalState::FAILED);
+        if (!journal->record(entry.fingerprint, state, entry.name, entry.output) && result.success) {
+            std::cerr << "[BATCH] Cannot record the completion of " << entry.name << " in " << journal->getFilePath().string() << std::endl;
+        }
+    }
+
+    return result;
+}
+
+// ============================================================================
+// METRICS
+// ============================================================================
+
+bool BatchRunner::writeMetrics(const BatchSummary& summary) const {
+    Core::JobMetrics total;
+    std::ostringstream json;
+    json.precision(6);
+    json << "{\"concurrency\":" << summary.concurrency << ",\"wall_seconds\":" << summary.wall_seconds << ",\"jobs\":[";
+    for (size_t i = 0; i < summary.results.size(); ++i) {
+        const BatchJobResult& result = summary.results[i];
+        total.merge(result.metrics);
+        json << (i > 0 ? "," : "") << "\n{\"name\":" << Json::quote(result.name)
+             << ",\"success\":" << (result.success ? "true" : "false")
+             << ",\"resumed\":" << (result.resumed ? "true" : "false")
+             << ",\"attempts\":" << result.attempts
+             << ",\"wall_seconds\":" << result.wall_seconds;
+        unsigned planned = entries_[i].job->getCpuAllocation().threads;
+        if (planned > 0) {
+            json << ",\"planned_threads\":" << planned;
+        }
+        json << ",\"metrics\":" << result.metrics.toJson(result.wall_seconds) << "}";
+    }
+    json << "],\n\"total\":" << total.toJson(summary.wall_seconds) << "}\n";
+
+    std::filesystem::path partial = PathUtils::getPartialPath(options_.metrics_file);
+    {
+        std::ofstream file(partial, std::ios::binary | std::ios::trunc);
+        if (!file.is_open() || !(file << json.str())) {
+            return false;
+        }
+    }
+    return PathUtils::commitPartial(partial, options_.metrics_file);
+}
+
+std::filesystem::path BatchRunner::getLogPath(size_t index) const {
+    // Index prefix keeps names unique when two inputs share a stem
+    std::ostringstream name;
+    name << std::setw(3) << std::setfill('0') << index + 1 << "_";
+    for (char c : entries_[index].name) {
+        bool safe = std::isalnum(static_cast<unsigned char>(c)) || c == '-' || c == '_' || c == '.';
+        name << (safe ? c : '_');
+    }
+    name << ".log";
+    return options_.log_dir / name.str();
+}
+
+} // namespace Pipeline
+} // namespace FFmpegMulti
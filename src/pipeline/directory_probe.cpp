@@ -0,0 +1,286 @@
+#include "../../include/pipeline/directory_probe.hpp"
+#include "../../include/core/cpu_topology.hpp"
+#include "../../include/core/json.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+namespace FFmpegMulti {
+namespace Pipeline {
+
+namespace {
+
+const char* CSV_HEADER = "path,ok,error,size,duration,format,video_codec,width,height,fps,pix_fmt,dynamic_range,"
+                         "audio_codec,audio_channels,audio_streams,subtitle_streams";
+
+std::string csvField(const std::string& value) {
+    if (value.find_first_of(",\"\r\n") == std::string::npos) {
+        return value;
+    }
+    std::string out = "\"";
+    for (char c : value) {
+        out += c;
+        if (c == '"') {
+            out += '"';
+        }
+    }
+    out += '"';
+    return out;
+}
+
+} // namespace
+
+// ============================================================================
+// CONSTRUCTOR
+// ============================================================================
+
+DirectoryProbe::DirectoryProbe(std::filesystem::path root, DirectoryProbeOptions options)
+    : root_(std::move(root)), options_(std::move(options)) {}
+
+// ============================================================================
+// HELPERS
+// ============================================================================
+
+bool DirectoryProbe::isMediaFile(const std::filesystem::path& path) {
+    static const std::vector<std::string> extensions = {
+        ".mkv", ".mp4", ".mov", ".avi", ".webm", ".m4v", ".ts", ".m2ts", ".mts", ".mxf", ".mpg", ".mpeg", ".wmv", ".flv",
+        ".mp3", ".flac", ".wav", ".m4a", ".aac", ".opus", ".ogg"
+    };
+
+    std::string ext = path.extension().string();
+    std::transform(ext.begin(), ext.end(), ext.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return std::find(extensions.begin(), extensions.end(), ext) != extensions.end();
+}
+
+std::string DirectoryProbe::resolutionClass(int width, int height) {
+    // Wide formats (e.g. 3840x1600 scope) are classed by width
+    int lines = std::max(height, width * 9 / 16);
+    if (lines >= 4320) return "4320p";
+    if (lines >= 2160) return "2160p";
+    if (lines >= 1440) return "1440p";
+    if (lines >= 1080) return "1080p";
+    if (lines >= 720) return "720p";
+    return "SD";
+}
+
+// ============================================================================
+// EXECUTION
+// ============================================================================
+
+DirectoryProbeStats DirectoryProbe::run() {
+    if (!std::filesystem::is_directory(root_)) {
+        throw std::runtime_error("Input directory does not exist: " + root_.string());
+    }
+
+    if (!options_.report_path.empty()) {
+        if (options_.report_path.has_parent_path()) {
+            std::filesystem::create_directories(options_.report_path.parent_path());
+        }
+        report_.open(options_.report_path, std::ios::out | std::ios::trunc);
+        if (!report_.is_open()) {
+            throw std::runtime_error("Cannot create report: " + options_.report_path.string());
+        }
+        if (options_.format == ProbeReportFormat::CSV) {
+            report_ << CSV_HEADER << "\n";
+        }
+    }
+
+    walk_ = std::filesystem::recursive_directory_iterator(root_, std::filesystem::directory_options::skip_permission_denied);
+    stopped_ = false;
+    stats_ = DirectoryProbeStats();
+
+    unsigned concurrency = options_.concurrency;
+    if (concurrency == 0) {
+        concurrency = Core::availableCores();
+    }
+
+    auto start = std::chrono::steady_clock::now();
+
+    std::vector<std::thread> workers;
+    for (unsigned i = 0; i < concurrency; ++i) {
+        workers.emplace_back(&DirectoryProbe::worker, this);
+    }
+    for (auto& w : workers) {
+        w.join();
+    }
+
+    if (report_.is_open()) {
+        report_.close();
+    }
+
+    stats_.wall_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return stats_;
+}
+
+bool DirectoryProbe::nextFile(std::filesystem::path& file) {
+    std::error_code ec;
+    const std::filesystem::recursive_directory_iterator end;
+
+    while (!stopped_ && walk_ != end) {
+        const std::filesystem::directory_entry& entry = *walk_;
+        bool isDir = entry.is_directory(ec);
+        bool match = !isDir && entry.is_regular_file(ec) && isMediaFile(entry.path());
+        if (match) {
+            file = entry.path();
+        }
+        if (isDir && !options_.recursive) {
+            walk_.disable_recursion_pending();
+        } else if (isDir && !entry.is_symlink(ec)) {
+            // A subdirectory that fails to open inside increment() ends the whole walk:
+            // it is opened here first, and an unreadable one is reported and skipped
+            std::error_code openEc;
+            std::filesystem::directory_iterator contents(entry.path(), openEc);
+            if (openEc) {
+                record(entry.path(), nullptr, "cannot read directory: " + openEc.message());
+                walk_.disable_recursion_pending();
+            }
+        }
+
+        std::filesystem::path current = entry.path();
+        walk_.increment(ec);
+        if (ec) {
+            // Error while reading the current directory: the iterator cannot go on, the scan is reported as incomplete
+            record(current.parent_path(), nullptr, "directory walk stopped: " + ec.message());
+            walk_ = end;
+        }
+        if (match) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void DirectoryProbe::worker() {
+    while (true) {
+        std::filesystem::path file;
+        {
+            std::lock_guard<std::mutex> lock(walk_mutex_);
+            if (!stopped_ && options_.should_stop && options_.should_stop()) {
+                stopped_ = true;
+            }
+            if (!nextFile(file)) {
+                return;
+            }
+        }
+
+        try {
+            ::Jobs::ProbeResult result = ::Jobs::ProbeJob::probe(file.string());
+            record(file, &result, "");
+        } catch (const std::exception& e) {
+            record(file, nullptr, e.what());
+        }
+    }
+}
+
+void DirectoryProbe::record(const std::filesystem::path& file, const ::Jobs::ProbeResult* result, const std::string& error) {
+    std::string line;
+    if (report_.is_open()) {
+        line = options_.format == ProbeReportFormat::CSV ? formatCsvRow(file, result, error) : formatJsonLine(file, result, error);
+    }
+
+    std::lock_guard<std::mutex> lock(report_mutex_);
+    if (report_.is_open()) {
+        report_ << line << "\n";
+        report_.flush(); // The report stays readable while the scan runs
+    }
+
+    if (result) {
+        stats_.files++;
+        stats_.total_duration += result->format.duration;
+        if (result->format.size > 0) {
+            stats_.total_bytes += static_cast<unsigned long long>(result->format.size);
+        } else {
+            std::error_code ec;
+            auto size = std::filesystem::file_size(file, ec);
+            stats_.total_bytes += ec ? 0 : size;
+        }
+
+        if (const ::Jobs::ProbeStream* video = result->firstStream("video")) {
+            stats_.video_codecs[video->codec_name]++;
+            stats_.resolutions[resolutionClass(video->width, video->height)]++;
+            stats_.dynamic_ranges[video->dynamicRange()]++;
+        }
+        if (const ::Jobs::ProbeStream* audio = result->firstStream("audio")) {
+            stats_.audio_codecs[audio->codec_name]++;
+        }
+    } else {
+        stats_.failed++;
+    }
+
+    if (options_.on_file_done) {
+        options_.on_file_done(file, result != nullptr, stats_.files + stats_.failed);
+    }
+}
+
+// ============================================================================
+// REPORT
+// ============================================================================
+
+std::string DirectoryProbe::formatJsonLine(const std::filesystem::path& file, const ::Jobs::ProbeResult* result, const std::string& error) const {
+    std::ostringstream line;
+    line.precision(10);
+    line << "{\"path\":" << Json::quote(file.string());
+    if (!result) {
+        line << ",\"ok\":false,\"error\":" << Json::quote(error) << "}";
+        return line.str();
+    }
+
+    line << ",\"ok\":true"
+         << ",\"size\":" << result->format.size
+         << ",\"duration\":" << result->format.duration
+         << ",\"format\":" << Json::quote(result->format.format_name);
+
+    if (const ::Jobs::ProbeStream* video = result->firstStream("video")) {
+        line << ",\"video_codec\":" << Json::quote(video->codec_name)
+             << ",\"width\":" << video->width
+             << ",\"height\":" << video->height
+             << ",\"fps\":" << video->frameRate()
+             << ",\"pix_fmt\":" << Json::quote(video->pix_fmt)
+             << ",\"dynamic_range\":" << Json::quote(video->dynamicRange());
+    }
+    if (const ::Jobs::ProbeStream* audio = result->firstStream("audio")) {
+        line << ",\"audio_codec\":" << Json::quote(audio->codec_name)
+             << ",\"audio_channels\":" << audio->channels;
+    }
+    line << ",\"audio_streams\":" << result->countStreams("audio")
+         << ",\"subtitle_streams\":" << result->countStreams("subtitle") << "}";
+    return line.str();
+}
+
+std::string DirectoryProbe::formatCsvRow(const std::filesystem::path& file, const ::Jobs::ProbeResult* result, const std::string& error) const {
+    std::ostringstream row;
+    row.precision(10);
+    row << csvField(file.string()) << ",";
+    if (!result) {
+        row << "false," << csvField(error) << std::string(13, ',');
+        return row.str();
+    }
+
+    const ::Jobs::ProbeStream* video = result->firstStream("video");
+    const ::Jobs::ProbeStream* audio = result->firstStream("audio");
+
+    row << "true,,"
+        << result->format.size << ","
+        << result->format.duration << ","
+        << csvField(result->format.format_name) << ",";
+    if (video) {
+        row << csvField(video->codec_name) << "," << video->width << "," << video->height << ","
+            << video->frameRate() << "," << csvField(video->pix_fmt) << "," << video->dynamicRange() << ",";
+    } else {
+        row << ",,,,,,";
+    }
+    if (audio) {
+        row << csvField(audio->codec_name) << "," << audio->channels << ",";
+    } else {
+        row << ",,";
+    }
+    row << result->countStreams("audio") << "," << result->countStreams("subtitle");
+    return row.str();
+}
+
+} // namespace Pipeline
+} // namespace FFmpegMulti
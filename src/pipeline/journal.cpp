@@ -0,0 +1,215 @@
+#include "../../include/pipeline/journal.hpp"
+#include "../../include/core/hash.hpp"
+#include "../../include/core/json.hpp"
+
+#include <cerrno>
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#include <sys/stat.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace FFmpegMulti {
+namespace Pipeline {
+
+// ============================================================================
+// CONSTRUCTOR
+// ============================================================================
+
+Journal::Journal(std::filesystem::path file) : file_(std::move(file)) {
+    if (file_.has_parent_path()) {
+        std::filesystem::create_directories(file_.parent_path());
+    }
+    bool existed = std::filesystem::exists(file_);
+    bool torn = replay();
+
+#ifdef _WIN32
+    fd_ = ::_wopen(file_.wstring().c_str(), _O_WRONLY | _O_APPEND | _O_CREAT | _O_BINARY, _S_IREAD | _S_IWRITE);
+#else
+    fd_ = ::open(file_.c_str(), O_WRONLY | O_APPEND | O_CREAT | O_CLOEXEC, 0644);
+#endif
+    if (fd_ < 0) {
+        throw std::runtime_error("Cannot open journal: " + file_.string());
+    }
+
+    // The next record must not be glued to a torn last line, or both are lost on the next replay
+    if (torn && !appendLine("\n")) {
+        throw std::runtime_error("Cannot write journal: " + file_.string());
+    }
+
+#ifndef _WIN32
+    // A new file only survives a crash once its directory entry is on disk too
+    if (!existed) {
+        std::filesystem::path dir = file_.has_parent_path() ? file_.parent_path() : std::filesystem::path(".");
+        int dirFd = ::open(dir.c_str(), O_RDONLY | O_CLOEXEC);
+        if (dirFd >= 0) {
+            ::fsync(dirFd);
+            ::close(dirFd);
+        }
+    }
+#else
+    (void)existed;
+#endif
+}
+
+Journal::~Journal() {
+    if (fd_ >= 0) {
+#ifdef _WIN32
+        ::_close(fd_);
+#else
+        ::close(fd_);
+#endif
+    }
+}
+
+// ============================================================================
+// RECORDING
+// ============================================================================
+
+const char* Journal::stateName(JournalState state) {
+    switch (state) {
+        case JournalState::STARTED: return "started";
+        case JournalState::DONE: return "done";
+        case JournalState::FAILED: return "failed";
+        case JournalState::CANCELLED: return "cancelled";
+    }
+    return "unknown";
+}
+
+bool Journal::record(const std::string& fingerprint, JournalState state, const std::string& name, const std::filesystem::path& output) {
+    JournalEntry entry;
+    entry.fingerprint = fingerprint;
+    entry.state = state;
+    entry.name = name;
+    entry.output = output.string();
+
+    // Hashing happens outside the lock: outputs can be many GB
+    std::error_code ec;
+    if (state == JournalState::DONE && !output.empty() && std::filesystem::is_regular_file(output, ec)) {
+        entry.output_size = std::filesystem::file_size(output, ec);
+        entry.checksum = Hash::fileHex64(output);
+    }
+
+    long long now = std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+    std::ostringstream line;
+    line << "{\"time\":" << now
+         << ",\"job\":" << Json::quote(entry.fingerprint)
+         << ",\"state\":\"" << stateName(state) << "\""
+         << ",\"name\":" << Json::quote(entry.name);
+    if (!entry.output.empty()) {
+        line << ",\"output\":" << Json::quote(entry.output);
+    }
+    if (!entry.checksum.empty()) {
+        line << ",\"size\":" << entry.output_size << ",\"checksum\":\"" << entry.checksum << "\"";
+    }
+    line << "}\n";
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!appendLine(line.str())) {
+        return false;
+    }
+    entries_[fingerprint] = std::move(entry);
+    return true;
+}
+
+bool Journal::appendLine(const std::string& line) {
+    // One write() per line: O_APPEND keeps concurrent lines whole
+#ifdef _WIN32
+    int written = ::_write(fd_, line.data(), static_cast<unsigned>(line.size()));
+    return written == static_cast<int>(line.size()) && ::_commit(fd_) == 0;
+#else
+    const char* data = line.data();
+    size_t left = line.size();
+    while (left > 0) {
+        ssize_t written = ::write(fd_, data, left);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        data += written;
+        left -= static_cast<size_t>(written);
+    }
+    return ::fsync(fd_) == 0;
+#endif
+}
+
+bool Journal::replay() {
+    std::ifstream in(file_, std::ios::binary);
+    std::string line;
+    bool torn = false;
+    while (std::getline(in, line)) {
+        torn = in.eof(); // The last line was read up to the end of the file, without a newline
+        Json::Value value;
+        try {
+            value = Json::Value::parse(line);
+        } catch (const Json::ParseError&) {
+            continue; // Torn last line of a crashed run
+        }
+
+        std::string state = value["state"].asString();
+        JournalEntry entry;
+        entry.fingerprint = value["job"].asString();
+        entry.name = value["name"].asString();
+        entry.output = value["output"].asString();
+        entry.output_size = static_cast<uint64_t>(value["size"].asInt(0));
+        entry.checksum = value["checksum"].asString();
+        if (state == "done") {
+            entry.state = JournalState::DONE;
+        } else if (state == "failed") {
+            entry.state = JournalState::FAILED;
+        } else if (state == "cancelled") {
+            entry.state = JournalState::CANCELLED;
+        } else {
+            entry.state = JournalState::STARTED;
+        }
+        if (!entry.fingerprint.empty()) {
+            entries_[entry.fingerprint] = std::move(entry);
+        }
+    }
+    return torn;
+}
+
+// ============================================================================
+// QUERIES
+// ============================================================================
+
+std::optional<JournalEntry> Journal::find(const std::string& fingerprint) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(fingerprint);
+    if (it == entries_.end()) {
+        return std::nullopt;
+    }
+    return it->second;
+}
+
+bool Journal::isComplete(const std::string& fingerprint, bool verify) const {
+    std::optional<JournalEntry> found = find(fingerprint);
+    if (!found || found->state != JournalState::DONE) {
+        return false;
+    }
+    const JournalEntry& entry = *found;
+
+    if (entry.checksum.empty()) {
+        return true; // Folder output, or no output: the DONE record is all there is
+    }
+
+    std::error_code ec;
+    uintmax_t size = std::filesystem::file_size(entry.output, ec);
+    if (ec || size != entry.output_size) {
+        return false; // Deleted, truncated or replaced since
+    }
+    return !verify || Hash::fileHex64(entry.output) == entry.checksum;
+}
+
+} // namespace Pipeline
+} // namespace FFmpegMulti
@@ -0,0 +1,217 @@
+#include "../../include/pipeline/output_cache.hpp"
+#include "../../include/core/ffmpeg_process.hpp"
+#include "../../include/core/hash.hpp"
+#include "../../include/core/path_utils.hpp"
+#include "../../include/jobs/probe_cache.hpp"
+
+#include <algorithm>
+#include <map>
+#include <sstream>
+#include <thread>
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+namespace fs = std::filesystem;
+
+namespace FFmpegMulti {
+namespace Pipeline {
+
+namespace {
+
+// Bump when the key layout changes: older entries become unreachable and age out
+const char* KEY_VERSION = "ffmpeg_multi-output-cache-1";
+
+const char* DATA_FILE = "data";
+
+} // namespace
+
+// ============================================================================
+// CONSTRUCTOR / INSTANCE
+// ============================================================================
+
+OutputCache::OutputCache(fs::path dir, uint64_t max_bytes) : dir_(std::move(dir)), max_bytes_(max_bytes) {}
+
+OutputCache& OutputCache::instance() {
+    static OutputCache cache(PathUtils::getCacheDir() / "outputs");
+    return cache;
+}
+
+void OutputCache::setMaxBytes(uint64_t max_bytes) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    max_bytes_ = max_bytes;
+}
+
+uint64_t OutputCache::getMaxBytes() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return max_bytes_;
+}
+
+fs::path OutputCache::entryDir(const std::string& key) const {
+    return dir_ / key;
+}
+
+// ============================================================================
+// KEYS
+// ============================================================================
+
+std::string OutputCache::makeKey(const std::string& inputFile, const std::vector<std::string>& args, const std::string& toolVersion) {
+    std::string identity;
+    ::Jobs::FileStamp stamp;
+    if (toolVersion.empty() || !::Jobs::ProbeCache::stampFile(inputFile, identity, stamp)) {
+        return "";
+    }
+
+    // Fields are NUL separated so that no two argument vectors give the same text
+    Hash::Hasher hasher;
+    std::ostringstream header;
+    header << KEY_VERSION << '\0' << identity << '\0' << stamp.size << '\0' << stamp.mtime_ns << '\0' << stamp.inode << '\0'
+           << toolVersion << '\0' << args.size() << '\0';
+    hasher.update(header.str());
+    for (const auto& arg : args) {
+        hasher.update(arg.data(), arg.size() + 1); // With its terminator
+    }
+    return hasher.hex();
+}
+
+std::string OutputCache::toolVersion(const fs::path& tool) {
+    static std::mutex mutex;
+    static std::map<fs::path, std::string> versions;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = versions.find(tool);
+    if (it != versions.end()) {
+        return it->second;
+    }
+
+    ffmpegProcess process(tool, {"-version"});
+    process.setEcho(false);
+    process.setCaptureOutput(true);
+    ProcessResult result = process.run();
+
+    std::string version;
+    if (result.success()) {
+        // "ffmpeg version 7.1 Copyright (c) ..." (the build configuration follows)
+        std::istringstream lines(result.output);
+        std::getline(lines, version);
+        if (!version.empty() && version.back() == '\r') {
+            version.pop_back();
+        }
+    }
+    versions[tool] = version;
+    return version;
+}
+
+// ============================================================================
+// FETCH / STORE
+// ============================================================================
+
+bool OutputCache::fetch(const std::string& key, const fs::path& target) {
+    if (key.empty()) {
+        return false;
+    }
+    fs::path entry = entryDir(key);
+    std::error_code ec;
+    if (!fs::is_regular_file(entry / DATA_FILE, ec)) {
+        return false;
+    }
+    if (!PathUtils::linkOrCopyFile(entry / DATA_FILE, target)) {
+        return false; // Evicted meanwhile, or unreadable
+    }
+
+    // The folder's mtime is the LRU clock (the data file may be shared with outputs)
+    fs::last_write_time(entry, fs::file_time_type::clock::now(), ec);
+    return true;
+}
+
+bool OutputCache::store(const std::string& key, const fs::path& output) {
+    if (key.empty()) {
+        return false;
+    }
+    std::error_code ec;
+    fs::create_directories(dir_, ec);
+
+    // Filled under a private name, then renamed: readers never see a partial entry
+    std::ostringstream tempName;
+    tempName << ".tmp-" << key << "-" << std::hash<std::thread::id>()(std::this_thread::get_id());
+#ifndef _WIN32
+    tempName << "-" << ::getpid();
+#endif
+    fs::path temp = dir_ / tempName.str();
+    fs::remove_all(temp, ec);
+    fs::create_directories(temp, ec);
+    if (ec || !PathUtils::linkOrCopyFile(output, temp / DATA_FILE)) {
+        fs::remove_all(temp, ec);
+        return false;
+    }
+
+    fs::rename(temp, entryDir(key), ec);
+    if (ec) {
+        fs::remove_all(temp, ec); // Stored by another process first
+        return fs::exists(entryDir(key) / DATA_FILE);
+    }
+
+    evict(key);
+    return true;
+}
+
+// ============================================================================
+// EVICTION
+// ============================================================================
+
+uint64_t OutputCache::totalBytes() const {
+    uint64_t total = 0;
+    std::error_code ec;
+    for (fs::directory_iterator it(dir_, ec), end; !ec && it != end; it.increment(ec)) {
+        uintmax_t size = fs::file_size(it->path() / DATA_FILE, ec);
+        total += ec ? 0 : size;
+        ec.clear();
+    }
+    return total;
+}
+
+void OutputCache::evict(const std::string& keep) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    struct Entry {
+        fs::path dir;
+        fs::file_time_type used;
+        uint64_t size;
+    };
+    std::vector<Entry> entries;
+    uint64_t total = 0;
+
+    std::error_code ec;
+    for (fs::directory_iterator it(dir_, ec), end; !ec && it != end; it.increment(ec)) {
+        std::string name = it->path().filename().string();
+        if (name.empty() || name[0] == '.') {
+            continue; // Entry being stored
+        }
+        std::error_code entryEc;
+        uintmax_t size = fs::file_size(it->path() / DATA_FILE, entryEc);
+        if (entryEc) {
+            continue;
+        }
+        fs::file_time_type used = fs::last_write_time(it->path(), entryEc);
+        total += size;
+        if (name != keep) {
+            entries.push_back({it->path(), used, size});
+        }
+    }
+
+    // Oldest use first
+    std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) { return a.used < b.used; });
+    for (const auto& entry : entries) {
+        if (total <= max_bytes_) {
+            break;
+        }
+        fs::remove_all(entry.dir, ec);
+        if (!ec) {
+            total -= entry.size;
+        }
+    }
+}
+
+} // namespace Pipeline
+} // namespace FFmpegMulti
@@ -0,0 +1,258 @@
+#include "../../include/pipeline/prometheus_exporter.hpp"
+#include "../../include/pipeline/batch_runner.hpp"
+#include "../../include/core/path_utils.hpp"
+
+#include <fstream>
+#include <sstream>
+
+namespace fs = std::filesystem;
+
+namespace FFmpegMulti {
+namespace Pipeline {
+
+namespace {
+
+const char* PREFIX = "ffmpeg_multi_";
+
+// Label values escape backslashes, double quotes and line feeds
+std::string labelValue(const std::string& value) {
+    std::string escaped;
+    for (char c : value) {
+        if (c == '\\' || c == '"') {
+            escaped += '\\';
+            escaped += c;
+        } else if (c == '\n') {
+            escaped += "\\n";
+        } else {
+            escaped += c;
+        }
+    }
+    return "\"" + escaped + "\"";
+}
+
+std::string encoderLabel(const std::string& encoder) {
+    return labelValue(encoder.empty() ? "none" : encoder);
+}
+
+void family(std::ostringstream& out, const std::string& name, const char* type, const char* help) {
+    out << "# HELP " << PREFIX << name << " " << help << "\n# TYPE " << PREFIX << name << " " << type << "\n";
+}
+
+} // namespace
+
+// ============================================================================
+// CONSTRUCTOR
+// ============================================================================
+
+PrometheusExporter::PrometheusExporter(fs::path file, std::chrono::milliseconds interval)
+    : file_(std::move(file)), interval_(interval) {}
+
+PrometheusExporter::~PrometheusExporter() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        active_ = false;
+    }
+    wake_.notify_all();
+    if (writer_.joinable()) {
+        writer_.join();
+    }
+}
+
+const fs::path& PrometheusExporter::getFilePath() const {
+    return file_;
+}
+
+// ============================================================================
+// LIFECYCLE
+// ============================================================================
+
+void PrometheusExporter::batchStarted(size_t jobs) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        queued_ += jobs;
+        finished_.clear();
+        if (active_) {
+            return;
+        }
+        active_ = true;
+    }
+    if (writer_.joinable()) {
+        writer_.join();
+    }
+    writer_ = std::thread(&PrometheusExporter::writeLoop, this);
+}
+
+void PrometheusExporter::jobStarted(size_t index, const std::string& name, const std::string& encoder) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (queued_ > 0) {
+        queued_--;
+    }
+    RunningJob job;
+    job.name = name;
+    job.encoder = encoder;
+    running_[index] = job;
+}
+
+void PrometheusExporter::jobProgress(size_t index, const Core::Progress& progress) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = running_.find(index);
+    if (it != running_.end()) {
+        it->second.progress = progress;
+    }
+}
+
+void PrometheusExporter::jobFinished(size_t index, const BatchJobResult& result) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    FinishedJob job;
+    job.name = result.name;
+    auto it = running_.find(index);
+    if (it != running_.end()) {
+        job.encoder = it->second.encoder;
+        running_.erase(it);
+    }
+    job.outcome = result.resumed ? "resumed" : (result.success ? "succeeded" : (result.cancelled ? "cancelled" : "failed"));
+    job.wall_seconds = result.wall_seconds;
+    job.metrics = result.metrics;
+
+    EncoderTotals& totals = encoders_[job.encoder];
+    totals.outcomes[job.outcome]++;
+    totals.retries += result.attempts > 1 ? static_cast<uint64_t>(result.attempts - 1) : 0;
+    totals.cpu_seconds += result.metrics.cpuSeconds();
+    totals.read_bytes += result.metrics.read_bytes;
+    totals.write_bytes += result.metrics.write_bytes;
+    finished_[index] = job;
+}
+
+void PrometheusExporter::batchFinished(size_t skipped) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        queued_ = queued_ > skipped ? queued_ - skipped : 0;
+        running_.clear();
+        active_ = false;
+    }
+    wake_.notify_all();
+    if (writer_.joinable()) {
+        writer_.join();
+    }
+    write();
+}
+
+// ============================================================================
+// OUTPUT
+// ============================================================================
+
+std::string PrometheusExporter::render() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::ostringstream out;
+    out.precision(10);
+
+    family(out, "queued_jobs", "gauge", "Jobs waiting for a worker.");
+    out << PREFIX << "queued_jobs " << queued_ << "\n";
+    family(out, "running_jobs", "gauge", "Jobs being executed.");
+    out << PREFIX << "running_jobs " << running_.size() << "\n";
+
+    // Running jobs: live FFmpeg progress
+    std::map<std::string, double> encoderFps;
+    for (const auto& entry : running_) {
+        encoderFps[entry.second.encoder] += entry.second.progress.fps;
+    }
+    family(out, "encoder_fps", "gauge", "Frames per second encoded by the running jobs, per encoder.");
+    for (const auto& entry : encoderFps) {
+        out << PREFIX << "encoder_fps{encoder=" << encoderLabel(entry.first) << "} " << entry.second << "\n";
+    }
+
+    auto runningLabels = [](size_t index, const RunningJob& job) {
+        return "{job=" + labelValue(job.name) + ",id=\"" + std::to_string(index + 1) + "\",encoder=" + encoderLabel(job.encoder) + "}";
+    };
+    family(out, "job_fps", "gauge", "Frames per second of a running job.");
+    for (const auto& entry : running_) {
+        out << PREFIX << "job_fps" << runningLabels(entry.first, entry.second) << " " << entry.second.progress.fps << "\n";
+    }
+    family(out, "job_speed_ratio", "gauge", "Encode speed of a running job relative to realtime (1 = realtime).");
+    for (const auto& entry : running_) {
+        out << PREFIX << "job_speed_ratio" << runningLabels(entry.first, entry.second) << " " << entry.second.progress.speed << "\n";
+    }
+    family(out, "job_progress_ratio", "gauge", "Completion of a running job (0 to 1), when its duration is known.");
+    for (const auto& entry : running_) {
+        double percent = entry.second.progress.percent();
+        if (percent >= 0.0) {
+            out << PREFIX << "job_progress_ratio" << runningLabels(entry.first, entry.second) << " " << percent / 100.0 << "\n";
+        }
+    }
+    family(out, "job_output_bytes", "gauge", "Bytes written so far by the FFmpeg process of a running job.");
+    for (const auto& entry : running_) {
+        out << PREFIX << "job_output_bytes" << runningLabels(entry.first, entry.second) << " " << entry.second.progress.total_size << "\n";
+    }
+
+    // Totals per encoder, since the exporter started
+    family(out, "jobs_finished_total", "counter", "Jobs finished, by encoder and outcome.");
+    for (const auto& entry : encoders_) {
+        for (const auto& outcome : entry.second.outcomes) {
+            out << PREFIX << "jobs_finished_total{encoder=" << encoderLabel(entry.first) << ",outcome=" << labelValue(outcome.first) << "} " << outcome.second << "\n";
+        }
+    }
+    family(out, "job_retries_total", "counter", "Extra attempts given to failed jobs.");
+    for (const auto& entry : encoders_) {
+        out << PREFIX << "job_retries_total{encoder=" << encoderLabel(entry.first) << "} " << entry.second.retries << "\n";
+    }
+    family(out, "cpu_seconds_total", "counter", "CPU time used by the processes of finished jobs.");
+    for (const auto& entry : encoders_) {
+        out << PREFIX << "cpu_seconds_total{encoder=" << encoderLabel(entry.first) << "} " << entry.second.cpu_seconds << "\n";
+    }
+    family(out, "read_bytes_total", "counter", "Bytes read by the processes of finished jobs.");
+    for (const auto& entry : encoders_) {
+        out << PREFIX << "read_bytes_total{encoder=" << encoderLabel(entry.first) << "} " << entry.second.read_bytes << "\n";
+    }
+    family(out, "write_bytes_total", "counter", "Bytes written by the processes of finished jobs.");
+    for (const auto& entry : encoders_) {
+        out << PREFIX << "write_bytes_total{encoder=" << encoderLabel(entry.first) << "} " << entry.second.write_bytes << "\n";
+    }
+
+    // Finished jobs of the current (or last) batch
+    auto finishedLabels = [](size_t index, const FinishedJob& job) {
+        return "{job=" + labelValue(job.name) + ",id=\"" + std::to_string(index + 1) + "\",encoder=" + encoderLabel(job.encoder) +
+               ",outcome=" + labelValue(job.outcome) + "}";
+    };
+    family(out, "job_cpu_seconds", "gauge", "CPU time used by a finished job.");
+    for (const auto& entry : finished_) {
+        out << PREFIX << "job_cpu_seconds" << finishedLabels(entry.first, entry.second) << " " << entry.second.metrics.cpuSeconds() << "\n";
+    }
+    family(out, "job_average_cores", "gauge", "Cores a finished job kept busy on average.");
+    for (const auto& entry : finished_) {
+        out << PREFIX << "job_average_cores" << finishedLabels(entry.first, entry.second) << " " << entry.second.metrics.averageCores(entry.second.wall_seconds) << "\n";
+    }
+    family(out, "job_peak_rss_bytes", "gauge", "Peak resident memory of the largest process of a finished job.");
+    for (const auto& entry : finished_) {
+        out << PREFIX << "job_peak_rss_bytes" << finishedLabels(entry.first, entry.second) << " " << entry.second.metrics.peak_rss_kb * 1024LL << "\n";
+    }
+
+    family(out, "last_update_timestamp_seconds", "gauge", "Time of this report, to detect a stalled batch.");
+    out << PREFIX << "last_update_timestamp_seconds "
+        << std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch()).count() << "\n";
+    return out.str();
+}
+
+bool PrometheusExporter::write() const {
+    // The collector reads every *.prom file: the temporary one must not match
+    fs::path partial = fs::path(file_).concat(".tmp");
+    {
+        std::ofstream file(partial, std::ios::binary | std::ios::trunc);
+        if (!file.is_open() || !(file << render())) {
+            return false;
+        }
+    }
+    return PathUtils::commitPartial(partial, file_);
+}
+
+void PrometheusExporter::writeLoop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (active_) {
+        lock.unlock();
+        write();
+        lock.lock();
+        wake_.wait_for(lock, interval_, [this] { return !active_; });
+    }
+}
+
+} // namespace Pipeline
+} // namespace FFmpegMulti
@@ -0,0 +1,49 @@
+#include "../../include/pipeline/segments.hpp"
+
+#include <iomanip>
+#include <sstream>
+
+namespace FFmpegMulti {
+namespace Pipeline {
+
+std::string formatSeconds(double seconds) {
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(6) << seconds;
+    return oss.str();
+}
+
+std::vector<double> planSegmentStarts(const std::vector<double>& keyframes, double start, double end, double target) {
+    std::vector<double> starts = { start };
+    for (double time : keyframes) {
+        if (time >= end) {
+            break;
+        }
+        if (time - starts.back() >= target) {
+            starts.push_back(time);
+        }
+    }
+
+    // A short tail is merged into the previous segment
+    if (starts.size() > 1 && end - starts.back() < target / 2) {
+        starts.pop_back();
+    }
+    return starts;
+}
+
+Core::Progress SegmentProgress::merged() const {
+    Core::Progress total;
+    total.duration_seconds = duration_seconds;
+    for (const auto& segment : segments) {
+        total.frame += segment.frame;
+        total.out_time_us += segment.out_time_us;
+        total.total_size += segment.total_size;
+        if (!segment.finished) {
+            total.fps += segment.fps;
+            total.speed += segment.speed;
+        }
+    }
+    return total;
+}
+
+} // namespace Pipeline
+} // namespace FFmpegMulti